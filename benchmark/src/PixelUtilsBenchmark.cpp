@@ -0,0 +1,53 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+#include "util/PixelUtils.hpp"
+
+namespace {
+// A 1024x1024 indicator image, converted one row at a time like CairoImageElement does
+constexpr size_t k_image_size = 1024;
+
+auto BM_rgb_to_xrgb(benchmark::State& state) -> void {
+    const auto kernel = static_cast<wall::PixelUtils::Kernel>(state.range(0));
+    state.SetLabel(wall::PixelUtils::get_kernel_name(kernel));
+
+    std::vector<uint8_t> src(k_image_size * k_image_size * 3, 0x7f);
+    std::vector<uint8_t> dst(k_image_size * k_image_size * 4);
+    for (auto _ : state) {
+        for (size_t row = 0; row < k_image_size; row++) {
+            wall::PixelUtils::rgb_to_xrgb(src.data() + (row * k_image_size * 3), dst.data() + (row * k_image_size * 4), k_image_size, kernel);
+        }
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * k_image_size * k_image_size));
+}
+
+auto BM_rgba_to_premultiplied_argb(benchmark::State& state) -> void {
+    const auto kernel = static_cast<wall::PixelUtils::Kernel>(state.range(0));
+    state.SetLabel(wall::PixelUtils::get_kernel_name(kernel));
+
+    std::vector<uint8_t> src(k_image_size * k_image_size * 4, 0x7f);
+    std::vector<uint8_t> dst(k_image_size * k_image_size * 4);
+    for (auto _ : state) {
+        for (size_t row = 0; row < k_image_size; row++) {
+            wall::PixelUtils::rgba_to_premultiplied_argb(src.data() + (row * k_image_size * 4), dst.data() + (row * k_image_size * 4),
+                                                         k_image_size, kernel);
+        }
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * k_image_size * k_image_size));
+}
+
+// Runs a benchmark once for every kernel the CPU supports
+auto add_kernels(benchmark::internal::Benchmark* benchmark) -> void {
+    for (const auto kernel : wall::PixelUtils::get_supported_kernels()) {
+        benchmark->Arg(static_cast<int64_t>(kernel));
+    }
+}
+}  // namespace
+
+BENCHMARK(BM_rgb_to_xrgb)->Apply(add_kernels);
+BENCHMARK(BM_rgba_to_premultiplied_argb)->Apply(add_kernels);
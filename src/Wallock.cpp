@@ -25,6 +25,12 @@ auto wall::Wallock::start(int argc, const char** argv) -> void {
     std::srand(std::time(nullptr));
 
     wall::Config config{argc, argv};
+    auto cmd = StringUtils::trim(wall_conf_get(config, command, name));
+    if (cmd.empty()) {
+        // the logger might start threads, signals have to be blocked before that so they are only delivered through the loop
+        SignalHandler::block_signals();
+    }
+
     if (config.is_debug()) {
         wall::Log::setup_debug_logger(config);
     } else {
@@ -33,7 +39,6 @@ auto wall::Wallock::start(int argc, const char** argv) -> void {
 
     Loop loop;
 
-    auto cmd = StringUtils::trim(wall_conf_get(config, command, name));
     wall::Wallock wallock{&config, &loop};
 
     if (cmd.empty()) {
@@ -91,7 +96,7 @@ auto wall::Wallock::run(bool is_lock) -> void {
         m_display = nullptr;
 
         m_command_processor = std::make_unique<wall::CommandProcessor>(this);
-        m_signal_handler = std::make_unique<wall::SignalHandler>(&get_config(), this);
+        m_signal_handler = std::make_unique<wall::SignalHandler>(this);
         if (!m_command_processor->start_listening()) {
             LOG_FATAL("Failed to start listening");
             return;
@@ -290,7 +290,7 @@ auto wall::Config::get_command_line_options() -> cxxopts::Options {
         ("c,config", "Config file", cxxopts::value<std::string>()->default_value(conf::k_default_config_file))
         ("l,log", "Log level", cxxopts::value<std::string>()->default_value(conf::k_default_log_level))
         ("s,start_lock", "Start lock immediately")
-        ("o,command", "Send a command (e.g. -o lock), possible commands are: lock, stop, next, reload, refresh", cxxopts::value<std::string>()->default_value(conf::k_default_log_level));
+        ("o,command", "Send a command (e.g. -o lock), possible commands are: lock, stop, next, reload, refresh, stats", cxxopts::value<std::string>()->default_value(conf::k_default_log_level));
     // clang-format on
 
     return options;
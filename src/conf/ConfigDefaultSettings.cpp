@@ -53,6 +53,9 @@ void wall::conf::setup_settings() {
     wall_conf_set(general, force_software_rendering);
     wall_conf_set(general, mpv_logging_enabled);
     wall_conf_set(general, lock_cmd);
+    wall_conf_set(general, overlay_render_threads);
+    wall_conf_set(general, worker_threads);
+    wall_conf_set(general, overlay_gl_composite);
 
     wall_conf_set(file, path);
     wall_conf_set(file, extensions);
@@ -61,8 +64,14 @@ void wall::conf::setup_settings() {
     wall_conf_set(file, sort_order);
     wall_conf_set(file, loop);
     wall_conf_set(file, keep_same_order);
+    wall_conf_set(file, share_decode);
     wall_conf_set(file, image_change_interval_secs);
     wall_conf_set(file, video_preload_secs);
+    wall_conf_set(file, standby_preload);
+    wall_conf_set(file, max_fps);
+    wall_conf_set(file, battery_max_fps);
+    wall_conf_set(file, pause_hidden);
+    wall_conf_set(file, limit_decode_resolution);
     wall_conf_set(file, video_max_change_interval_secs);
     wall_conf_set(file, screenshot_enabled);
     wall_conf_set(file, screenshot_cache_enabled);
@@ -84,8 +93,14 @@ void wall::conf::setup_settings() {
     wall_conf_set(wallpaper, sort_order);
     wall_conf_set(wallpaper, loop);
     wall_conf_set(wallpaper, keep_same_order);
+    wall_conf_set(wallpaper, share_decode);
     wall_conf_set(wallpaper, image_change_interval_secs);
     wall_conf_set(wallpaper, video_preload_secs);
+    wall_conf_set(wallpaper, standby_preload);
+    wall_conf_set(wallpaper, max_fps);
+    wall_conf_set(wallpaper, battery_max_fps);
+    wall_conf_set(wallpaper, pause_hidden);
+    wall_conf_set(wallpaper, limit_decode_resolution);
     wall_conf_set(wallpaper, video_max_change_interval_secs);
     wall_conf_set(wallpaper, screenshot_enabled);
     wall_conf_set(wallpaper, screenshot_cache_enabled);
@@ -103,8 +118,14 @@ void wall::conf::setup_settings() {
     wall_conf_set(lock, sort_order);
     wall_conf_set(lock, loop);
     wall_conf_set(lock, keep_same_order);
+    wall_conf_set(lock, share_decode);
     wall_conf_set(lock, image_change_interval_secs);
     wall_conf_set(lock, video_preload_secs);
+    wall_conf_set(lock, standby_preload);
+    wall_conf_set(lock, max_fps);
+    wall_conf_set(lock, battery_max_fps);
+    wall_conf_set(lock, pause_hidden);
+    wall_conf_set(lock, limit_decode_resolution);
     wall_conf_set(lock, video_max_change_interval_secs);
     wall_conf_set(lock, screenshot_enabled);
     wall_conf_set(lock, screenshot_cache_enabled);
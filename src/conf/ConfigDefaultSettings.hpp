@@ -58,6 +58,9 @@ wall_conf_key(general, daemonize, true, "Daemonize, run in background.")
 wall_conf_key(general, force_software_rendering, false, "Force software rendering.")
 wall_conf_key(general, mpv_logging_enabled, false, "Enable mpv logging.")
 wall_conf_key(general, lock_cmd, "", "Command to run after locking, the process will be terminated after the lock screen is dismissed.")
+wall_conf_key(general, overlay_render_threads, 0UL, "Number of threads drawing the indicator and bar, 0 draws them on the main thread.")
+wall_conf_key(general, worker_threads, 1UL, "Number of threads encoding screenshots and running their done command, 0 runs them on the main thread.")
+wall_conf_key(general, overlay_gl_composite, false, "Blend the indicator and bar into the wallpaper's OpenGL frame instead of showing them on separate surfaces.")
 wall_conf_key(command, socket_backlog, 128, "Number of connections to allow in the socket backlog.")
 wall_conf_key(command, socket_filename, "wallock.sock", "Socket filename.")
 
@@ -69,15 +72,21 @@ wall_conf_key(file, fit, "fill", "Options are fit or fill.")
 wall_conf_key(file, sort_order, "random", "Sort order for resources, options are random or alpha.")
 wall_conf_key(file, loop, false, "Loop first loaded resource.")
 wall_conf_key(file, keep_same_order, false, "Enforces the same ordering of resources between multiple monitors.")
+wall_conf_key(file, share_decode, false, "With keep_same_order, decodes each resource once and scales it to every monitor instead of decoding it per monitor.")
 wall_conf_key(file, image_change_interval_secs, 900UL, "How long to display an image for before rotating.")
 wall_conf_key(file, video_preload_secs, 1UL, "How long before the current resource finishes before loading the next. Note this may cutoff the end of a video.")
+wall_conf_key(file, limit_decode_resolution, false, "Decodes a resource at down to an eighth of its resolution when it is at least twice the size of the largest output showing it, codecs that cannot skip their loop filter instead. Only applies to software decoding, hardware decoding is used where available unless software rendering is forced.")
+wall_conf_key(file, max_fps, 0UL, "Caps how often a video is presented, 0 presents every frame.")
+wall_conf_key(file, battery_max_fps, 0UL, "Caps how often a video is presented while running on battery, 0 uses max_fps.")
+wall_conf_key(file, pause_hidden, true, "Pauses playback while no output is showing the resource, for example when it is turned off or covered.")
+wall_conf_key(file, standby_preload, false, "Opens the next resource paused in a second player video_preload_secs early and switches to it when the current one finishes, instead of cutting the end of a video.")
 wall_conf_key(file, video_max_change_interval_secs, 0UL, "Maximum time in seconds a video is allowed to play before rotating, default is unlimited.")
 wall_conf_key(file, screenshot_enabled, false, "Enables taking a screenshot after a new resource has been loaded.")
 wall_conf_key(file, screenshot_cache_enabled, true, "Caches the screenshot of a video.")
 wall_conf_key(file, screenshot_directory, "", "Screenshot location, default will be ~/.cache/wallock.")
 wall_conf_key(file, screenshot_delay_ms, 1000UL, "How long to wait until after a resource loads to take a screenshot.")
 wall_conf_key(file, screenshot_done_cmd, "", "Command to run after a screenshot has been taken.")
-wall_conf_key(file, screenshot_format, "jpg", "Screenshot format, note png can be very slow and large, jpg is recommended.")
+wall_conf_key(file, screenshot_format, "jpg", "Screenshot format, any format gdk-pixbuf can save: jpg, png, bmp, tiff and ico, webp and avif only with their gdk-pixbuf loaders installed. Unsupported formats fall back to jpg. Note png can be very slow and large, jpg is recommended.")
 wall_conf_key(file, screenshot_filename, "{filename}.{format}", "Screenshot filename.")
 wall_conf_key(file, screenshot_reload_on_done, true, "Reload colors on success.")
 
@@ -94,8 +103,14 @@ wall_conf_key(wallpaper, fit, k_default_file_fit, "")
 wall_conf_key(wallpaper, sort_order, k_default_file_sort_order, "")
 wall_conf_key(wallpaper, loop, false, "Loop first loaded resource.")
 wall_conf_key(wallpaper, keep_same_order, k_default_file_keep_same_order, "")
+wall_conf_key(wallpaper, share_decode, k_default_file_share_decode, "")
 wall_conf_key(wallpaper, image_change_interval_secs, k_default_file_image_change_interval_secs, "")
 wall_conf_key(wallpaper, video_preload_secs, k_default_file_video_preload_secs, "")
+wall_conf_key(wallpaper, limit_decode_resolution, k_default_file_limit_decode_resolution, "")
+wall_conf_key(wallpaper, max_fps, k_default_file_max_fps, "")
+wall_conf_key(wallpaper, battery_max_fps, k_default_file_battery_max_fps, "")
+wall_conf_key(wallpaper, pause_hidden, k_default_file_pause_hidden, "")
+wall_conf_key(wallpaper, standby_preload, k_default_file_standby_preload, "")
 wall_conf_key(wallpaper, video_max_change_interval_secs, k_default_file_video_max_change_interval_secs, "")
 wall_conf_key(wallpaper, screenshot_enabled, k_default_file_screenshot_enabled, "")
 wall_conf_key(wallpaper, screenshot_cache_enabled, k_default_file_screenshot_cache_enabled, "")
@@ -114,8 +129,14 @@ wall_conf_key(lock, fit, k_default_file_fit, "")
 wall_conf_key(lock, sort_order, k_default_file_sort_order, "")
 wall_conf_key(lock, loop, false, "Loop first loaded resource.")
 wall_conf_key(lock, keep_same_order, k_default_file_keep_same_order, "")
+wall_conf_key(lock, share_decode, k_default_file_share_decode, "")
 wall_conf_key(lock, image_change_interval_secs, k_default_file_image_change_interval_secs, "")
 wall_conf_key(lock, video_preload_secs, k_default_file_video_preload_secs, "")
+wall_conf_key(lock, limit_decode_resolution, k_default_file_limit_decode_resolution, "")
+wall_conf_key(lock, max_fps, k_default_file_max_fps, "")
+wall_conf_key(lock, battery_max_fps, k_default_file_battery_max_fps, "")
+wall_conf_key(lock, pause_hidden, k_default_file_pause_hidden, "")
+wall_conf_key(lock, standby_preload, k_default_file_standby_preload, "")
 wall_conf_key(lock, video_max_change_interval_secs, k_default_file_video_max_change_interval_secs, "")
 wall_conf_key(lock, screenshot_enabled, k_default_file_screenshot_enabled, "")
 wall_conf_key(lock, screenshot_cache_enabled, k_default_file_screenshot_cache_enabled, "")
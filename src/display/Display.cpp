@@ -51,7 +51,7 @@ wall::Display::Display(const Config& config,
             stop();
         }
     });
-    m_display_wake = m_loop->add_poll_pipe([](loop::PollPipe*, const std::vector<uint8_t>&) { LOG_DEBUG("Display wake"); });
+    m_display_wake = m_loop->add_poll_event([](loop::PollEvent*, uint64_t) { LOG_DEBUG("Display wake"); });
 
     check_for_failure();
 }
@@ -80,7 +80,7 @@ auto wall::Display::create_lock() -> void {
 
     // setup keyboard input handler
     setup_keyboard_callback();
-    m_lock_time = std::chrono::system_clock::now();
+    m_lock_time = std::chrono::steady_clock::now();
     m_lock_cmd.run();
 }
 
@@ -176,8 +176,12 @@ auto wall::Display::loop() -> void {
             wl_display_cancel_read(m_wl_display);
         }
 
+        const auto swap_start_time = loop::Clock::now();
         swap_surfaces();
+        const auto render_start_time = loop::Clock::now();
         render();
+        m_loop->get_stats_mut()->record(LoopMetric::SwapSurfaces, render_start_time - swap_start_time);
+        m_loop->get_stats_mut()->record(LoopMetric::Render, loop::Clock::now() - render_start_time);
 
         wl_display_dispatch_pending(m_wl_display);
 
@@ -363,7 +367,7 @@ auto wall::Display::on_state_change(State state) -> void {
     }
 
     if (m_grace_period.count() > 0 && state != State::NoOp && state != State::None) {
-        const auto now = std::chrono::system_clock::now();
+        const auto now = std::chrono::steady_clock::now();
         if ((now - m_lock_time) < m_grace_period) {
             unlock();
             return;
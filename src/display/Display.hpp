@@ -117,7 +117,7 @@ class Display {
 
     loop::Poll* m_display_poll{};
 
-    loop::PollPipe* m_display_wake{};
+    loop::PollEvent* m_display_wake{};
 
     PrimaryDisplayState m_primary_state{};
 
@@ -155,7 +155,7 @@ class Display {
 
     std::chrono::milliseconds m_grace_period;
 
-    std::chrono::time_point<std::chrono::system_clock> m_lock_time{};
+    std::chrono::time_point<std::chrono::steady_clock> m_lock_time{};
 
     std::vector<std::unique_ptr<Screen>> m_screens_to_be_destroyed;
 
@@ -2,17 +2,23 @@
 
 #include <deque>
 #include <filesystem>
+#include <memory>
 #include <mutex>
 #include "mpv/MpvResourceConfig.hpp"
 
 namespace wall {
+class MpvResource;
+
 struct PrimaryDisplayState {
     std::mutex m_guard;
     std::deque<std::filesystem::path> m_lock_files{};
     wall::MpvResourceConfig m_lock_config{};
+    // With share_decode, every output of the mode shows this resource for as long as one of them does
+    std::weak_ptr<MpvResource> m_lock_shared_resource{};
 
     std::deque<std::filesystem::path> m_wallpaper_files{};
     wall::MpvResourceConfig m_wallpaper_config{};
+    std::weak_ptr<MpvResource> m_wallpaper_shared_resource{};
 
     std::string m_primary_name;
 };
@@ -258,7 +258,7 @@ auto wall::Screen::on_state_change(State state) -> void {
 
 auto wall::Screen::destroy_lock_surface() -> void {
     if (m_lock_surface->get_mpv_resource() != nullptr) {
-        m_lock_surface->get_mpv_resource()->set_surface(nullptr);
+        m_lock_surface->get_mpv_resource()->remove_surface(m_lock_surface.get());
     }
     m_lock_surface->destroy_resources();
     m_lock_surface = nullptr;
@@ -266,7 +266,7 @@ auto wall::Screen::destroy_lock_surface() -> void {
 
 auto wall::Screen::destroy_wallpaper_surface() -> void {
     if (m_wallpaper_surface->get_mpv_resource() != nullptr) {
-        m_wallpaper_surface->get_mpv_resource()->set_surface(nullptr);
+        m_wallpaper_surface->get_mpv_resource()->remove_surface(m_wallpaper_surface.get());
     }
     m_wallpaper_surface->destroy_resources();
     m_wallpaper_surface = nullptr;
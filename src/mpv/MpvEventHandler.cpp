@@ -33,7 +33,7 @@ auto wall::MpvEventHandlerData::get_callback() const -> mpv_event_callback { ret
 auto wall::MpvEventHandlerData::set_callback(mpv_event_callback callback) -> void { m_callback = callback; }
 
 wall::MpvEventHandler::MpvEventHandler(Loop* loop, mpv_handle* mpv) : m_loop{loop}, m_mpv{mpv} {
-    m_wakeup_poll = m_loop->add_poll_pipe([this](loop::Poll*, const std::vector<uint8_t>& /* buffer */) { handle_new_events(); });
+    m_wakeup_poll = m_loop->add_poll_event([this](loop::PollEvent*, uint64_t /* count */) { handle_new_events(); });
 
     mpv_set_wakeup_callback(m_mpv, wakeup, this);
 }
@@ -65,9 +65,11 @@ auto wall::MpvEventHandler::wakeup([[maybe_unused]] void* ctx) -> void {
 auto wall::MpvEventHandler::handle_new_events() -> void {
     mpv_event* event = mpv_wait_event(m_mpv, 0);
     while (event != nullptr && event->event_id != MPV_EVENT_NONE) {
+        // hooks are continued by their id, so their handlers get it instead of the id they were added with
+        const auto user_event_id = event->event_id == MPV_EVENT_HOOK ? static_cast<mpv_event_hook*>(event->data)->id : event->reply_userdata;
         for (auto& [id, handler] : m_event_handlers) {
             if (handler->get_event_type() == event->event_id) {
-                handler->get_callback()(handler->get_data(), event->reply_userdata);
+                handler->get_callback()(handler->get_data(), user_event_id);
             }
         }
         event = mpv_wait_event(m_mpv, 0);
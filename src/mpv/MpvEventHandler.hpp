@@ -68,7 +68,7 @@ class MpvEventHandler {
 
     mpv_handle* m_mpv{};
 
-    loop::PollPipe* m_wakeup_poll{};
+    loop::PollEvent* m_wakeup_poll{};
 
     std::unordered_map<uint64_t, MpvEventHandlerData*> m_event_handlers;
 };
@@ -32,14 +32,28 @@ wall::MpvFileLoader::MpvFileLoader(const Config& config,
 
 wall::MpvFileLoader::~MpvFileLoader() { stop(); }
 
-auto wall::MpvFileLoader::stop() -> void {
+auto wall::MpvFileLoader::stop() -> void { close_timers(); }
+
+auto wall::MpvFileLoader::close_timers() -> void {
     if (m_load_next_file_timer != nullptr) {
         m_load_next_file_timer->close();
+        m_load_next_file_timer = nullptr;
+    }
+
+    if (m_switch_file_timer != nullptr) {
+        m_switch_file_timer->close();
+        m_switch_file_timer = nullptr;
     }
 }
 
 auto wall::MpvFileLoader::set_resource_config(MpvResourceConfig* resource_config) -> void { m_resource_config = resource_config; }
 
+auto wall::MpvFileLoader::set_standby_callbacks(std::function<void(std::string)> on_preload_file, std::function<bool()> on_switch_file)
+    -> void {
+    m_on_preload_file = std::move(on_preload_file);
+    m_on_switch_file = std::move(on_switch_file);
+}
+
 auto wall::MpvFileLoader::get_current_file() const -> const std::filesystem::path& { return m_current_file; }
 
 auto wall::MpvFileLoader::get_loop() const -> Loop* { return m_loop; }
@@ -99,16 +113,26 @@ auto wall::MpvFileLoader::get_files(const MpvResourceConfig& resource_config) ->
     return files;
 }
 
-auto wall::MpvFileLoader::calculate_timer_delay(double file_duration, const MpvResourceConfig& resource_config) -> std::chrono::seconds {
+auto wall::MpvFileLoader::get_file_duration(double file_duration, const MpvResourceConfig& resource_config) -> double {
     if (file_duration == 0.0) {
-        file_duration = resource_config.m_image_change_interval_secs.count();
-    } else if (resource_config.m_video_max_change_interval_secs.count() != 0 &&
-               file_duration > resource_config.m_video_max_change_interval_secs.count()) {
-        file_duration = resource_config.m_video_max_change_interval_secs.count();
+        return static_cast<double>(resource_config.m_image_change_interval_secs.count());
+    }
+
+    if (resource_config.m_video_max_change_interval_secs.count() != 0 &&
+        file_duration > static_cast<double>(resource_config.m_video_max_change_interval_secs.count())) {
+        return static_cast<double>(resource_config.m_video_max_change_interval_secs.count());
     }
 
+    return file_duration;
+}
+
+auto wall::MpvFileLoader::calculate_switch_delay(double file_duration, const MpvResourceConfig& resource_config) -> std::chrono::milliseconds {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::duration<double>{get_file_duration(file_duration, resource_config)});
+}
+
+auto wall::MpvFileLoader::calculate_timer_delay(double file_duration, const MpvResourceConfig& resource_config) -> std::chrono::seconds {
     // Calculate the timer delay to prevent black frames
-    auto timer_delay = std::chrono::seconds{static_cast<uint64_t>(file_duration)};
+    auto timer_delay = std::chrono::seconds{static_cast<uint64_t>(get_file_duration(file_duration, resource_config))};
     if (timer_delay > resource_config.m_video_preload_secs) {
         timer_delay -= resource_config.m_video_preload_secs;
     }
@@ -122,33 +146,71 @@ auto wall::MpvFileLoader::setup_load_next_file_timer([[maybe_unused]] double fil
         return;
     }
 
-    if (m_load_next_file_timer != nullptr) {
-        // Close the existing timer handle
-        m_load_next_file_timer->close();
-        m_load_next_file_timer = nullptr;
-    }
+    // Close the existing timer handles
+    close_timers();
+    m_standby_file.clear();
 
     // Adjust the file duration based on resource configuration
     const auto timer_delay = calculate_timer_delay(file_duration, *m_resource_config);
 
+    if (m_resource_config->m_is_standby_preload && m_on_preload_file && m_on_switch_file) {
+        // the standby has the preload time to open the file, the switch waits for the current one to play to its end
+        m_load_next_file_timer = get_loop()->add_timer(timer_delay, std::chrono::milliseconds{0}, [this](loop::Timer*) { preload_next_file(); });
+        m_switch_file_timer = get_loop()->add_timer(calculate_switch_delay(file_duration, *m_resource_config), std::chrono::milliseconds{0},
+                                                    [this](loop::Timer*) { switch_to_standby_file(); });
+        return;
+    }
+
     // Create a new timer handle
     m_load_next_file_timer = get_loop()->add_timer(timer_delay, std::chrono::milliseconds{0}, [this](loop::Timer*) { load_next_file(); });
 }
 
+auto wall::MpvFileLoader::preload_next_file() -> void {
+    m_standby_file = take_next_file();
+    if (!m_standby_file.empty()) {
+        LOG_DEBUG("Preloading file: {}", m_standby_file.string());
+        m_on_preload_file(m_standby_file);
+    }
+}
+
+auto wall::MpvFileLoader::switch_to_standby_file() -> void {
+    // the preload timer fires first unless the file is shorter than the preload time
+    if (m_standby_file.empty()) {
+        load_next_file();
+        return;
+    }
+
+    m_current_file = std::exchange(m_standby_file, {});
+    LOG_INFO("Switching to file: {}", m_current_file.string());
+    if (!m_on_switch_file()) {
+        m_on_load_file(m_current_file);
+    }
+}
+
 auto wall::MpvFileLoader::load_next_file() -> void {
-    if (!m_next_resource_override.empty()) {
-        LOG_DEBUG("Loading next resource override: {}", m_next_resource_override.string());
+    // a file loaded out of turn replaces whatever was waiting in the standby player
+    close_timers();
+    m_standby_file.clear();
 
-        m_current_file = m_next_resource_override;
-        m_on_load_file(m_next_resource_override);
-        m_next_resource_override = "";
+    auto file = take_next_file();
+    if (file.empty()) {
         return;
     }
 
+    m_current_file = file;
+    m_on_load_file(file);
+}
+
+auto wall::MpvFileLoader::take_next_file() -> std::filesystem::path {
+    if (!m_next_resource_override.empty()) {
+        LOG_DEBUG("Loading next resource override: {}", m_next_resource_override.string());
+        return std::exchange(m_next_resource_override, {});
+    }
+
     // Check if there are files to load
     if (m_files.empty()) {
         LOG_DEBUG("No files to load");
-        return;
+        return {};
     }
 
     // Handle case where file order needs to be maintained
@@ -164,9 +226,6 @@ auto wall::MpvFileLoader::load_next_file() -> void {
     auto file = m_files[m_load_file_counter];
     LOG_INFO("Loading file: {}", file.string());
 
-    // Send the MPV command to load the file
-    m_on_load_file(file);
-
     m_load_file_counter++;
 
     // Re-shuffle files at the end of a rotation if order is random
@@ -184,5 +243,5 @@ auto wall::MpvFileLoader::load_next_file() -> void {
 
     // add the current file back to the list
     m_files.push_back(file);
-    m_current_file = file;
+    return file;
 }
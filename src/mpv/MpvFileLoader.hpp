@@ -29,6 +29,10 @@ class MpvFileLoader {
 
     auto set_resource_config(MpvResourceConfig* resource_config) -> void;
 
+    // With standby_preload, the next file is handed to on_preload_file video_preload_secs early, and on_switch_file is called when the
+    // current one ends. If switching fails the file is loaded with on_load_file instead.
+    auto set_standby_callbacks(std::function<void(std::string)> on_preload_file, std::function<bool()> on_switch_file) -> void;
+
     /**
      * @brief Sets up a timer to load the next file after a certain duration.
      *
@@ -54,6 +58,9 @@ class MpvFileLoader {
 
     static auto calculate_timer_delay(double file_duration, const MpvResourceConfig& resource_config) -> std::chrono::seconds;
 
+    // When the current file ends, without taking the preload time off
+    static auto calculate_switch_delay(double file_duration, const MpvResourceConfig& resource_config) -> std::chrono::milliseconds;
+
    protected:
     auto assign_global_order(const std::deque<std::filesystem::path>& files) const -> void;
 
@@ -63,6 +70,17 @@ class MpvFileLoader {
 
     [[nodiscard]] auto get_config() const -> const Config&;
 
+    // Advances the rotation and returns the file after the current one, empty if there are no files
+    [[nodiscard]] auto take_next_file() -> std::filesystem::path;
+
+    auto preload_next_file() -> void;
+
+    auto switch_to_standby_file() -> void;
+
+    auto close_timers() -> void;
+
+    [[nodiscard]] static auto get_file_duration(double file_duration, const MpvResourceConfig& resource_config) -> double;
+
    private:
     const Config& m_config;
 
@@ -74,12 +92,21 @@ class MpvFileLoader {
 
     std::function<void(std::string)> m_on_load_file{};
 
+    std::function<void(std::string)> m_on_preload_file{};
+
+    std::function<bool()> m_on_switch_file{};
+
     std::deque<std::filesystem::path> m_files;
 
     uint64_t m_load_file_counter{};
 
     loop::Timer* m_load_next_file_timer{};
 
+    loop::Timer* m_switch_file_timer{};
+
+    // Opened in the standby player, shown once the current file ends
+    std::filesystem::path m_standby_file;
+
     std::filesystem::path m_current_file;
 
     std::filesystem::path m_next_resource_override;
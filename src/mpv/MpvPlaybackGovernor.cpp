@@ -0,0 +1,71 @@
+#include "mpv/MpvPlaybackGovernor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+auto get_fps_interval(double fps) -> std::chrono::milliseconds {
+    return std::chrono::milliseconds{static_cast<int64_t>(std::lround(1000.0 / fps))};
+}
+}  // namespace
+
+auto wall::MpvPlaybackGovernor::set_limits(uint32_t max_fps, uint32_t battery_max_fps, bool is_pause_hidden) -> void {
+    m_max_fps = max_fps;
+    m_battery_max_fps = battery_max_fps;
+    m_is_pause_hidden = is_pause_hidden;
+}
+
+auto wall::MpvPlaybackGovernor::is_enabled() const -> bool { return m_max_fps != 0U || m_battery_max_fps != 0U || m_is_pause_hidden; }
+
+auto wall::MpvPlaybackGovernor::is_battery_needed() const -> bool { return m_battery_max_fps != 0U; }
+
+auto wall::MpvPlaybackGovernor::get_mode() const -> PlaybackMode { return m_current.m_mode; }
+
+auto wall::MpvPlaybackGovernor::get_frame_interval() const -> std::chrono::milliseconds { return m_current.m_frame_interval; }
+
+auto wall::MpvPlaybackGovernor::get_target(const PlaybackInputs& inputs) const -> Target {
+    if (m_is_pause_hidden && inputs.m_is_hidden) {
+        return {.m_mode = PlaybackMode::Paused};
+    }
+
+    auto max_fps = m_max_fps;
+    if (m_battery_max_fps != 0U && inputs.m_is_ac_connected.has_value() && !inputs.m_is_ac_connected.value()) {
+        max_fps = max_fps == 0U ? m_battery_max_fps : std::min(max_fps, m_battery_max_fps);
+    }
+
+    if (max_fps == 0U) {
+        return {};
+    }
+
+    // stepping saves mpv from running its playback clock between frames that hardly change
+    if (inputs.m_file_fps > 0.0 && inputs.m_file_fps <= k_static_fps) {
+        return {.m_mode = PlaybackMode::Stepping, .m_frame_interval = get_fps_interval(inputs.m_file_fps)};
+    }
+
+    // a cap at or above the file's own rate would only add timers
+    if (inputs.m_file_fps > 0.0 && static_cast<double>(max_fps) >= inputs.m_file_fps) {
+        return {};
+    }
+
+    return {.m_mode = PlaybackMode::Capped, .m_frame_interval = get_fps_interval(max_fps)};
+}
+
+auto wall::MpvPlaybackGovernor::update(std::chrono::steady_clock::time_point now, const PlaybackInputs& inputs) -> bool {
+    const auto target = get_target(inputs);
+    if (target == m_current) {
+        m_pending = target;
+        return false;
+    }
+
+    if (target != m_pending) {
+        m_pending = target;
+        m_pending_since = now;
+    }
+
+    if (m_current.m_mode != PlaybackMode::Paused && now - m_pending_since < k_mode_hold) {
+        return false;
+    }
+
+    m_current = target;
+    return true;
+}
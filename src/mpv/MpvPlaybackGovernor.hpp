@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace wall {
+
+enum class PlaybackMode {
+    // Every frame mpv decodes is presented
+    Normal,
+    // Frames are presented at most once per frame interval, mpv drops the ones in between
+    Capped,
+    // Playback is paused and the file is stepped a frame at a time at its own rate
+    Stepping,
+    // No output is showing the surfaces, so nothing is decoded
+    Paused
+};
+
+struct PlaybackInputs {
+    // Empty when there is no battery information
+    std::optional<bool> m_is_ac_connected{};
+    // Frame rate of the file, 0 for images or when it is unknown
+    double m_file_fps{0.0};
+    // None of the surfaces showing the file received a frame callback for a while
+    bool m_is_hidden{false};
+};
+
+// Picks how a resource plays its file from the power state, the file's frame rate and whether it is visible. A new mode has to be wanted
+// for k_mode_hold before it is used, so that a battery or a surface switching back and forth does not restart playback every time.
+// Resuming from a pause is the exception, the file is shown again right away.
+class MpvPlaybackGovernor {
+   public:
+    static constexpr auto k_mode_hold = std::chrono::seconds{3};
+
+    // While a cap applies, files at or below this rate are near static and stepped instead of played
+    static constexpr double k_static_fps = 2.0;
+
+    // A max fps of 0 leaves the rate uncapped, a battery max fps of 0 uses the max fps on battery too
+    auto set_limits(uint32_t max_fps, uint32_t battery_max_fps, bool is_pause_hidden) -> void;
+
+    // Returns true if the mode or its frame interval changed
+    auto update(std::chrono::steady_clock::time_point now, const PlaybackInputs& inputs) -> bool;
+
+    [[nodiscard]] auto get_mode() const -> PlaybackMode;
+
+    // Minimum time between presented frames while capped, the file's frame time while stepping and 0 otherwise
+    [[nodiscard]] auto get_frame_interval() const -> std::chrono::milliseconds;
+
+    [[nodiscard]] auto is_enabled() const -> bool;
+
+    [[nodiscard]] auto is_battery_needed() const -> bool;
+
+   private:
+    struct Target {
+        PlaybackMode m_mode{PlaybackMode::Normal};
+        std::chrono::milliseconds m_frame_interval{0};
+
+        [[nodiscard]] auto operator==(const Target& other) const -> bool = default;
+    };
+
+    [[nodiscard]] auto get_target(const PlaybackInputs& inputs) const -> Target;
+
+    uint32_t m_max_fps{0U};
+
+    uint32_t m_battery_max_fps{0U};
+
+    bool m_is_pause_hidden{false};
+
+    Target m_current{};
+
+    Target m_pending{};
+
+    std::chrono::steady_clock::time_point m_pending_since{};
+};
+}  // namespace wall
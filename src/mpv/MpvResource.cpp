@@ -4,38 +4,61 @@
 #include <mpv/client.h>
 #include <mpv/render_gl.h>
 #include <wayland-client-core.h>
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <string>
+#include <utility>
 #include "conf/ConfigMacros.hpp"
 #include "display/Display.hpp"
 #include "mpv/MpvEventHandler.hpp"
 #include "mpv/MpvFileLoader.hpp"
 #include "mpv/MpvResourceConfig.hpp"
 #include "mpv/MpvScreenshot.hpp"
+#include "render/SharedFrame.hpp"
+#include "util/BatteryDiscover.hpp"
 #include "util/Log.hpp"
 
+namespace {
+auto close_timer(wall::loop::Timer*& timer) -> void {
+    if (timer != nullptr) {
+        timer->close();
+        timer = nullptr;
+    }
+}
+}  // namespace
+
 #pragma GCC diagnostic push
 // Ignore the warning about missing field initializers in the struct, some older versions of the protocol are missing .axis_value120
 #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
 
+wall::MpvResource::MpvResource(const Config& config, Display* display, Surface* surface)
+    : MpvResource(config, display, surface, surface->get_next_resource_override()) {}
+
 wall::MpvResource::MpvResource(const Config& config,
                                Display* display,
-                               Surface* surface)  // NOLINT *-performance-unnecessary-value-param
+                               Surface* surface,
+                               std::filesystem::path first_file)  // NOLINT *-performance-unnecessary-value-param
     : m_config{config},
       m_display{display},
-      m_surface{surface},
+      m_surfaces{surface},
       m_resource_config{MpvResourceConfig::build_config(config, surface->get_resource_mode())},
       m_mpv{mpv_create()},
       m_event_handler{std::make_unique<MpvEventHandler>(display->get_loop(), m_mpv)},
-      m_screenshot{std::make_shared<MpvScreenshot>(config)},
+      m_screenshot{std::make_shared<MpvScreenshot>(config, display->get_loop(), surface->get_registry()->get_worker_pool_mut())},
       m_file_loader{std::make_unique<MpvFileLoader>(config,
                                                     display->get_loop(),
                                                     &m_resource_config,
                                                     display->get_primary_state_mut(),
-                                                    surface->get_next_resource_override(),
+                                                    std::move(first_file),
                                                     [&](const std::string& file) { send_mpv_cmd("loadfile", file.c_str()); })} {
     if (m_mpv == nullptr) {
         LOG_FATAL("Couldn't create mpv handle");
     }
 
+    m_file_loader->set_standby_callbacks([this](const std::string& file) { prepare_standby(file); },
+                                         [this]() { return switch_to_standby(); });
+
     m_is_mpv_log_enabled = wall_conf_get(config, general, mpv_logging_enabled);
 }
 
@@ -50,44 +73,114 @@ auto wall::MpvResource::play() -> void {
     }
 
     if (m_is_paused) {
-        send_mpv_cmd("set", "pause", "no");
+        m_is_paused = false;
+        apply_playback_mode();
     }
 
     if (m_is_single_frame) {
         send_mpv_cmd("seek", "0", "absolute");
     }
-    m_is_paused = false;
 }
 
 auto wall::MpvResource::pause() -> void {
+    close_timer(m_step_timer);
     if (!m_is_paused) {
         send_mpv_cmd("set", "pause", "yes");
     }
     m_is_paused = true;
 }
 
-auto wall::MpvResource::set_surface(Surface* surface) -> void { m_surface = surface; }
+auto wall::MpvResource::add_surface(Surface* surface) -> void {
+    if (surface != nullptr && std::ranges::find(m_surfaces, surface) == m_surfaces.end()) {
+        m_surfaces.push_back(surface);
+    }
+    m_is_frame_dirty = true;
+    if (m_mpv_context != nullptr && is_shared() != m_is_shared_fit) {
+        apply_fit_mode();
+    }
+
+    if (m_standby != nullptr) {
+        m_standby->add_surface(surface);
+    }
+}
+
+auto wall::MpvResource::remove_surface(Surface* surface) -> void {
+    std::erase(m_surfaces, surface);
+    if (m_mpv_context != nullptr && is_shared() != m_is_shared_fit) {
+        apply_fit_mode();
+    }
+
+    if (m_standby != nullptr) {
+        m_standby->remove_surface(surface);
+    }
+}
+
+auto wall::MpvResource::get_surface() const -> Surface* { return m_surfaces.empty() ? nullptr : m_surfaces.front(); }
+
+auto wall::MpvResource::get_largest_surface_size() const -> std::pair<int32_t, int32_t> {
+    int32_t width = 0;
+    int32_t height = 0;
+    for (const auto* surface : m_surfaces) {
+        const auto surface_width = static_cast<int32_t>(surface->get_width());
+        const auto surface_height = static_cast<int32_t>(surface->get_height());
+        if (static_cast<int64_t>(surface_width) * surface_height > static_cast<int64_t>(width) * height) {
+            width = surface_width;
+            height = surface_height;
+        }
+    }
+    return {width, height};
+}
+
+auto wall::MpvResource::is_shared() const -> bool { return m_resource_config.m_is_share_decode && m_surfaces.size() > 1; }
+
+auto wall::MpvResource::render_shared_frame() -> const SharedFrame* {
+    if (m_mpv_context == nullptr) {
+        return nullptr;
+    }
+
+    // the largest output is the only one that gets the frame at its own size, the others are scaled down from it
+    const auto [largest_width, largest_height] = get_largest_surface_size();
+    const auto [width, height] =
+        calculate_shared_frame_size(m_video_width, m_video_height, largest_width, largest_height, m_resource_config.m_fit_mode);
 
-auto wall::MpvResource::get_surface() const -> Surface* { return m_surface; }
+    if (m_shared_frame == nullptr) {
+        m_shared_frame = std::make_unique<SharedFrame>();
+    }
+
+    const auto is_resized = m_shared_frame->get_width() != width || m_shared_frame->get_height() != height;
+    if (m_is_frame_dirty || is_resized || !m_shared_frame->is_rendered()) {
+        if (!m_shared_frame->render(m_mpv_context, width, height)) {
+            return nullptr;
+        }
+        m_is_frame_dirty = false;
+    }
+
+    return m_shared_frame.get();
+}
 
 auto wall::MpvResource::get_display() const -> Display* { return m_display; }
 
 auto wall::MpvResource::send_mpv_cmd(const char* arg1) const -> void {
-    std::array<const char*, 4> cmd_args = {arg1, nullptr, nullptr, nullptr};
+    std::array<const char*, 5> cmd_args = {arg1, nullptr, nullptr, nullptr, nullptr};
     send_mpv_cmd_base(cmd_args);
 }
 
 auto wall::MpvResource::send_mpv_cmd(const char* arg1, const char* arg2) const -> void {
-    std::array<const char*, 4> cmd_args = {arg1, arg2, nullptr, nullptr};
+    std::array<const char*, 5> cmd_args = {arg1, arg2, nullptr, nullptr, nullptr};
     send_mpv_cmd_base(cmd_args);
 }
 
 auto wall::MpvResource::send_mpv_cmd(const char* arg1, const char* arg2, const char* arg3) const -> void {
-    std::array<const char*, 4> cmd_args = {arg1, arg2, arg3, nullptr};
+    std::array<const char*, 5> cmd_args = {arg1, arg2, arg3, nullptr, nullptr};
+    send_mpv_cmd_base(cmd_args);
+}
+
+auto wall::MpvResource::send_mpv_cmd(const char* arg1, const char* arg2, const char* arg3, const char* arg4) const -> void {
+    std::array<const char*, 5> cmd_args = {arg1, arg2, arg3, arg4, nullptr};
     send_mpv_cmd_base(cmd_args);
 }
 
-auto wall::MpvResource::send_mpv_cmd_base(std::array<const char*, 4> args) const -> void {
+auto wall::MpvResource::send_mpv_cmd_base(std::array<const char*, 5> args) const -> void {
     if (m_mpv == nullptr) {
         return;
     }
@@ -101,6 +194,10 @@ auto wall::MpvResource::send_mpv_cmd_base(std::array<const char*, 4> args) const
 auto wall::MpvResource::get_current_file() const -> const std::filesystem::path& { return m_file_loader->get_current_file(); }
 
 auto wall::MpvResource::terminate() -> void {
+    m_standby = nullptr;
+    close_timer(m_governor_timer);
+    close_timer(m_present_timer);
+    close_timer(m_step_timer);
     m_event_handlers.clear();
     m_event_handler = nullptr;
 
@@ -113,6 +210,8 @@ auto wall::MpvResource::terminate() -> void {
         m_screenshot->stop();
     }
 
+    m_shared_frame = nullptr;
+
     if (m_mpv_context != nullptr) {
         mpv_render_context_free(m_mpv_context);
         m_mpv_context = nullptr;
@@ -130,10 +229,16 @@ auto wall::MpvResource::load_new_config(const wall::MpvResourceConfig& new_confi
     }
 
     m_resource_config = new_config;
+    m_standby = nullptr;
+    add_preloaded_hook();
     load_mpv_options();
+    setup_governor();
 }
 
-auto wall::MpvResource::next() -> void { m_file_loader->load_next_file(); }
+auto wall::MpvResource::next() -> void {
+    m_standby = nullptr;
+    m_file_loader->load_next_file();
+}
 
 auto wall::MpvResource::setup() -> void {
     mpv_set_option_string(m_mpv, "vo", "libmpv");
@@ -155,6 +260,8 @@ auto wall::MpvResource::setup() -> void {
         LOG_FATAL("mpv init failed");
     }
 
+    add_preloaded_hook();
+
     if (m_is_mpv_log_enabled || get_config().is_debug()) {
         send_mpv_cmd("set", "terminal", "yes");
         send_mpv_cmd("set", "msg-level", "all=v");
@@ -183,12 +290,18 @@ auto wall::MpvResource::setup() -> void {
 
     setup_update_callback();
 
+    setup_governor();
+
     next();
 }
 
 auto wall::MpvResource::is_single_frame() const -> bool { return m_is_single_frame; }
 
 auto wall::MpvResource::stop() -> void {
+    m_standby = nullptr;
+    close_timer(m_governor_timer);
+    close_timer(m_present_timer);
+    close_timer(m_step_timer);
     if (m_mpv != nullptr) {
         send_mpv_cmd("stop");
     }
@@ -200,11 +313,14 @@ auto wall::MpvResource::stop() -> void {
 }
 
 auto wall::MpvResource::setup_update_callback() -> void {
-    m_mpv_update_async = m_display->get_loop()->add_poll_pipe([this](loop::PollPipe*, const std::vector<uint8_t>& /* buffer */) {
+    m_mpv_update_async = m_display->get_loop()->add_poll_event([this](loop::PollEvent*, uint64_t /* count */) {
         mpv_render_context_update(get_mpv_context());
-        if (m_surface != nullptr && m_surface->get_renderer_mut() != nullptr) {
-            m_surface->get_renderer_mut()->set_is_dirty(true);
+        if (m_is_standby) {
+            return;
         }
+
+        m_is_frame_dirty = true;
+        present_frame();
     });
 
     mpv_render_context_set_update_callback(
@@ -219,6 +335,142 @@ auto wall::MpvResource::setup_update_callback() -> void {
         this);
 }
 
+auto wall::MpvResource::close_update_callback() -> void {
+    if (m_mpv_context != nullptr) {
+        mpv_render_context_set_update_callback(m_mpv_context, nullptr, nullptr);
+    }
+
+    if (m_mpv_update_async != nullptr) {
+        m_mpv_update_async->close();
+        m_mpv_update_async = nullptr;
+    }
+}
+
+auto wall::MpvResource::mark_surfaces_dirty() -> void {
+    for (auto* surface : m_surfaces) {
+        if (surface->get_renderer_mut() != nullptr) {
+            surface->get_renderer_mut()->set_is_dirty(true);
+        }
+    }
+}
+
+auto wall::MpvResource::present_frame() -> void {
+    if (m_governor.get_mode() == PlaybackMode::Capped) {
+        // mpv drops the frames that are replaced before they are rendered, so only the newest one is presented when the timer fires
+        const auto now = std::chrono::steady_clock::now();
+        const auto due = m_last_present + m_governor.get_frame_interval();
+        if (now < due) {
+            if (m_present_timer == nullptr) {
+                m_present_timer = m_display->get_loop()->add_timer(std::chrono::ceil<std::chrono::milliseconds>(due - now),
+                                                                   std::chrono::milliseconds{0}, [this](loop::Timer*) {
+                                                                       close_timer(m_present_timer);
+                                                                       present_frame();
+                                                                   });
+            }
+            return;
+        }
+        m_last_present = now;
+    }
+
+    mark_surfaces_dirty();
+}
+
+auto wall::MpvResource::setup_governor() -> void {
+    m_governor.set_limits(m_resource_config.m_max_fps, m_resource_config.m_battery_max_fps, m_resource_config.m_is_pause_hidden);
+
+    // a standby is paused until it is switched to and then plays by the governor of the resource it switched into
+    if (m_is_standby) {
+        return;
+    }
+
+    if (m_governor.is_battery_needed() && m_battery_discover == nullptr) {
+        m_battery_discover = std::make_unique<BatteryDiscover>(m_config);
+    }
+
+    if (!m_governor.is_enabled()) {
+        close_timer(m_governor_timer);
+    } else if (m_governor_timer == nullptr) {
+        m_governor_timer =
+            m_display->get_loop()->add_timer(k_governor_interval, k_governor_interval, [this](loop::Timer*) { update_governor(); });
+    }
+
+    update_governor();
+}
+
+auto wall::MpvResource::is_hidden(std::chrono::steady_clock::time_point now) const -> bool {
+    return !m_surfaces.empty() && std::ranges::all_of(m_surfaces, [now](Surface* surface) {
+        return surface->get_renderer_mut() != nullptr && surface->get_renderer_mut()->is_frame_callback_overdue(now, k_hidden_after);
+    });
+}
+
+auto wall::MpvResource::update_governor() -> void {
+    if (m_is_standby) {
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    PlaybackInputs inputs{.m_file_fps = m_is_single_frame ? 0.0 : m_file_fps, .m_is_hidden = is_hidden(now)};
+    if (m_governor.is_battery_needed() && m_battery_discover != nullptr) {
+        inputs.m_is_ac_connected = m_battery_discover->get_status(std::chrono::system_clock::now()).m_is_ac_connected;
+    }
+
+    if (m_governor.update(now, inputs)) {
+        LOG_DEBUG("Playback mode {} with frame interval {}ms", static_cast<int32_t>(m_governor.get_mode()),
+                  m_governor.get_frame_interval().count());
+        apply_playback_mode();
+    }
+}
+
+auto wall::MpvResource::apply_playback_mode() -> void {
+    close_timer(m_step_timer);
+    if (m_is_paused || m_is_standby) {
+        return;
+    }
+
+    switch (m_governor.get_mode()) {
+        case PlaybackMode::Paused:
+            send_mpv_cmd("set", "pause", "yes");
+            break;
+        case PlaybackMode::Stepping: {
+            send_mpv_cmd("set", "pause", "yes");
+            const auto interval = m_governor.get_frame_interval();
+            m_step_timer = m_display->get_loop()->add_timer(interval, interval, [this](loop::Timer*) { send_mpv_cmd("frame-step"); });
+            break;
+        }
+        case PlaybackMode::Normal:
+            [[fallthrough]];
+        case PlaybackMode::Capped:
+            [[fallthrough]];
+        default:
+            send_mpv_cmd("set", "pause", "no");
+            break;
+    }
+}
+
+auto wall::MpvResource::apply_fit_mode() -> void {
+    // the shared frame already has the source's aspect ratio, mpv stretches it to exactly that size and each surface crops or letterboxes
+    // it afterwards
+    m_is_shared_fit = is_shared();
+    if (m_is_shared_fit) {
+        send_mpv_cmd("set", "keepaspect", "no");
+        return;
+    }
+
+    send_mpv_cmd("set", "keepaspect", "yes");
+    switch (m_resource_config.m_fit_mode) {
+        case FitMode::Fill:
+            send_mpv_cmd("set", "panscan", "1.0");
+            break;
+        case FitMode::Fit:
+            send_mpv_cmd("set", "panscan", "0.0");
+            break;
+        case FitMode::None:
+            [[fallthrough]];
+        default:
+            break;
+    }
+}
+
 auto wall::MpvResource::setup_event_handlers() -> void {
     if (m_event_handler != nullptr) {
         m_event_handlers.emplace_back(m_event_handler->add_event_handler(
@@ -228,6 +480,20 @@ auto wall::MpvResource::setup_event_handlers() -> void {
                 resource->handle_file_loaded();
             },
             this));
+        m_event_handlers.emplace_back(m_event_handler->add_event_handler(
+            MPV_EVENT_VIDEO_RECONFIG,
+            [](void* data, [[maybe_unused]] uint64_t user_event_id) {
+                auto* resource = (MpvResource*)data;
+                resource->handle_video_reconfig();
+            },
+            this));
+        m_event_handlers.emplace_back(m_event_handler->add_event_handler(
+            MPV_EVENT_HOOK,
+            [](void* data, uint64_t hook_id) {
+                auto* resource = (MpvResource*)data;
+                resource->handle_preloaded(hook_id);
+            },
+            this));
         m_event_handlers.emplace_back(m_event_handler->add_event_handler(
             MPV_EVENT_END_FILE, []([[maybe_unused]] void* data, [[maybe_unused]] uint64_t user_event_id) { LOG_DEBUG("End of file"); }, this));
 
@@ -242,18 +508,7 @@ auto wall::MpvResource::load_mpv_options() -> void {
         send_mpv_cmd("set", "mute", "yes");
     }
 
-    switch (m_resource_config.m_fit_mode) {
-        case FitMode::Fill:
-            send_mpv_cmd("set", "panscan", "1.0");
-            break;
-        case FitMode::Fit:
-            send_mpv_cmd("set", "panscan", "0.0");
-            break;
-        case FitMode::None:
-            [[fallthrough]];
-        default:
-            break;
-    }
+    apply_fit_mode();
 
     // this lets us load the next file while the current one is paused on the last frame
     send_mpv_cmd("set", "idle", "yes");
@@ -287,17 +542,194 @@ auto wall::MpvResource::handle_file_loaded() -> void {
     auto file_duration = 0.0;
     mpv_get_property(m_mpv, "duration", MPV_FORMAT_DOUBLE, &file_duration);
 
+    m_file_duration = file_duration;
+    m_is_single_frame = file_duration == 0.0;
+    m_file_fps = 0.0;
+    mpv_get_property(m_mpv, "container-fps", MPV_FORMAT_DOUBLE, &m_file_fps);
+    m_is_file_loaded = true;
+
+    // the standby's file is only on screen once it is switched to
+    if (!m_is_standby) {
+        show_file();
+    }
+}
+
+auto wall::MpvResource::handle_video_reconfig() -> void {
+    int64_t width = 0;
+    int64_t height = 0;
+    int64_t rotate = 0;
+    mpv_get_property(m_mpv, "video-params/dw", MPV_FORMAT_INT64, &width);
+    mpv_get_property(m_mpv, "video-params/dh", MPV_FORMAT_INT64, &height);
+    mpv_get_property(m_mpv, "video-params/rotate", MPV_FORMAT_INT64, &rotate);
+
+    // mpv rotates the frame while rendering it
+    if (rotate % 180 != 0) {
+        std::swap(width, height);
+    }
+
+    if (width != m_video_width || height != m_video_height) {
+        m_video_width = width;
+        m_video_height = height;
+        m_is_frame_dirty = true;
+    }
+}
+
+auto wall::MpvResource::add_preloaded_hook() -> void {
+    // the hook holds up every file until the loop thread answers it, so it is only added when it has something to do
+    if (!m_resource_config.m_is_limit_decode_resolution || m_is_preloaded_hook_added || m_mpv == nullptr) {
+        return;
+    }
+
+    mpv_hook_add(m_mpv, 0, "on_preloaded", 0);
+    m_is_preloaded_hook_added = true;
+}
+
+auto wall::MpvResource::handle_preloaded(uint64_t hook_id) -> void {
+    limit_decode_resolution();
+    mpv_hook_continue(m_mpv, hook_id);
+}
+
+auto wall::MpvResource::calculate_decode_lowres(int64_t source_width, int64_t source_height, int32_t width, int32_t height, FitMode fit_mode)
+    -> int32_t {
+    constexpr int32_t k_max_decode_lowres = 3;
+    if (source_width <= 0 || source_height <= 0 || width <= 0 || height <= 0) {
+        return 0;
+    }
+
+    // fill scales the source until it covers the output, so the side that is shrunk the least decides how much detail is left.
+    // Fit and no fit mode scale it until all of it is shown.
+    const auto width_ratio = static_cast<double>(source_width) / width;
+    const auto height_ratio = static_cast<double>(source_height) / height;
+    const auto ratio = fit_mode == FitMode::Fill ? std::min(width_ratio, height_ratio) : std::max(width_ratio, height_ratio);
+
+    auto level = 0;
+    while (level < k_max_decode_lowres && ratio >= static_cast<double>(1 << (level + 1))) {
+        level++;
+    }
+    return level;
+}
+
+auto wall::MpvResource::calculate_shared_frame_size(int64_t source_width, int64_t source_height, int32_t width, int32_t height, FitMode fit_mode)
+    -> std::pair<int32_t, int32_t> {
+    if (source_width <= 0 || source_height <= 0 || width <= 0 || height <= 0) {
+        return {width, height};
+    }
+
+    const auto width_scale = static_cast<double>(width) / static_cast<double>(source_width);
+    const auto height_scale = static_cast<double>(height) / static_cast<double>(source_height);
+    const auto scale = fit_mode == FitMode::Fill ? std::max(width_scale, height_scale) : std::min(width_scale, height_scale);
+    return {std::max(1, static_cast<int32_t>(std::lround(static_cast<double>(source_width) * scale))),
+            std::max(1, static_cast<int32_t>(std::lround(static_cast<double>(source_height) * scale)))};
+}
+
+auto wall::MpvResource::limit_decode_resolution() -> void {
+    auto level = 0;
+    const auto [width, height] = get_largest_surface_size();
+    if (m_resource_config.m_is_limit_decode_resolution) {
+        int64_t source_width = 0;
+        int64_t source_height = 0;
+        if (mpv_get_property(m_mpv, "current-tracks/video/demux-w", MPV_FORMAT_INT64, &source_width) >= 0 &&
+            mpv_get_property(m_mpv, "current-tracks/video/demux-h", MPV_FORMAT_INT64, &source_height) >= 0) {
+            level = calculate_decode_lowres(source_width, source_height, width, height, m_resource_config.m_fit_mode);
+            LOG_DEBUG("Decoding {}x{} for {}x{} at lowres {}", source_width, source_height, width, height, level);
+        }
+    }
+
+    if (level == m_decode_lowres) {
+        return;
+    }
+
+    // lowres is a libavcodec option that only some software decoders support, for the others the loop filter is skipped as its detail is
+    // scaled away. Other decoder options set on the player are kept.
+    m_decode_lowres = level;
+    send_mpv_cmd("change-list", "vd-lavc-o", "remove", "lowres");
+    if (level > 0) {
+        const auto lowres = "lowres=" + std::to_string(level);
+        send_mpv_cmd("change-list", "vd-lavc-o", "append", lowres.c_str());
+    }
+    send_mpv_cmd("set", "vd-lavc-skiploopfilter", level > 0 ? "all" : "default");
+}
+
+auto wall::MpvResource::show_file() -> void {
+    update_governor();
+
     // if loop is set, then keep the first loaded resource and loop forever
     if (!m_resource_config.m_is_loop) {
-        m_file_loader->setup_load_next_file_timer(file_duration);
+        m_file_loader->setup_load_next_file_timer(m_file_duration);
     }
 
-    m_is_single_frame = file_duration == 0.0;
-
     // Only take a screenshot if this is the primary resource
-    if (get_surface()->is_primary()) {
+    if (std::ranges::any_of(m_surfaces, [](const Surface* surface) { return surface->is_primary(); })) {
         m_screenshot->screenshot(get_current_file(), m_mpv);
     }
 }
 
+auto wall::MpvResource::prepare_standby(const std::filesystem::path& file) -> void {
+    m_standby = nullptr;
+
+    // the standby's render context is created in the context shared by all surfaces, so one of them has to be current
+    if (get_surface() == nullptr || eglGetCurrentContext() == EGL_NO_CONTEXT) {
+        return;
+    }
+
+    auto standby = std::make_unique<MpvResource>(m_config, m_display, get_surface(), file);
+    // the decode resolution the standby picks for its file has to cover every output showing this resource
+    standby->m_surfaces = m_surfaces;
+    standby->m_is_standby = true;
+    standby->m_is_paused = true;
+    mpv_set_option_string(standby->m_mpv, "pause", "yes");
+
+    try {
+        standby->setup();
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to create standby mpv resource: {}", e.what());
+        return;
+    }
+
+    m_standby = std::move(standby);
+}
+
+auto wall::MpvResource::switch_to_standby() -> bool {
+    auto standby = std::move(m_standby);
+    if (standby == nullptr || standby->m_mpv_context == nullptr) {
+        return false;
+    }
+
+    // neither player may call back into its old resource while they change hands, the previous file's screenshot still uses its player
+    m_screenshot->stop();
+    m_event_handlers.clear();
+    standby->m_event_handlers.clear();
+    close_update_callback();
+    standby->close_update_callback();
+
+    std::swap(m_mpv, standby->m_mpv);
+    std::swap(m_mpv_context, standby->m_mpv_context);
+    std::swap(m_event_handler, standby->m_event_handler);
+    std::swap(m_file_duration, standby->m_file_duration);
+    std::swap(m_is_single_frame, standby->m_is_single_frame);
+    std::swap(m_is_file_loaded, standby->m_is_file_loaded);
+    std::swap(m_decode_lowres, standby->m_decode_lowres);
+    std::swap(m_is_preloaded_hook_added, standby->m_is_preloaded_hook_added);
+    std::swap(m_file_fps, standby->m_file_fps);
+    std::swap(m_video_width, standby->m_video_width);
+    std::swap(m_video_height, standby->m_video_height);
+    std::swap(m_is_shared_fit, standby->m_is_shared_fit);
+
+    setup_event_handlers();
+    setup_update_callback();
+    apply_playback_mode();
+
+    // the standby resource now holds the previous player, which is destroyed with it
+    standby = nullptr;
+
+    m_is_frame_dirty = true;
+    mark_surfaces_dirty();
+
+    // a file that is still opening is shown from handle_file_loaded instead
+    if (m_is_file_loaded) {
+        show_file();
+    }
+    return true;
+}
+
 #pragma GCC diagnostic pop
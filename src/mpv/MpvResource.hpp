@@ -4,8 +4,13 @@
 #include <mpv/render.h>
 #include <wayland-client-core.h>
 #include <wayland-client.h>
+#include <chrono>
 #include <filesystem>
+#include <memory>
+#include <utility>
+#include <vector>
 #include "mpv/MpvEventHandler.hpp"
+#include "mpv/MpvPlaybackGovernor.hpp"
 #include "mpv/MpvResourceConfig.hpp"
 #include "util/Loop.hpp"
 
@@ -15,10 +20,15 @@ class MpvScreenshot;
 class MpvFileLoader;
 class Display;
 class Surface;
+class SharedFrame;
+class BatteryDiscover;
 
 class MpvResource : public std::enable_shared_from_this<MpvResource> {
    public:
     MpvResource(const Config& config, Display* display, Surface* surface);
+
+    // Starts with the given file instead of the surface's next resource override
+    MpvResource(const Config& config, Display* display, Surface* surface, std::filesystem::path first_file);
     virtual ~MpvResource();
 
     MpvResource(const MpvResource&) = delete;
@@ -34,7 +44,9 @@ class MpvResource : public std::enable_shared_from_this<MpvResource> {
 
     auto setup() -> void;
 
-    auto set_surface(Surface* surface) -> void;
+    auto add_surface(Surface* surface) -> void;
+
+    auto remove_surface(Surface* surface) -> void;
 
     auto load_new_config(const wall::MpvResourceConfig& new_config) -> void;
 
@@ -56,12 +68,35 @@ class MpvResource : public std::enable_shared_from_this<MpvResource> {
 
     auto send_mpv_cmd(const char* arg1, const char* arg2, const char* arg3) const -> void;
 
+    auto send_mpv_cmd(const char* arg1, const char* arg2, const char* arg3, const char* arg4) const -> void;
+
+    // The first surface attached, it drives loading the next file. Null when no surface is attached.
     [[nodiscard]] auto get_surface() const -> Surface*;
 
+    // True when the decoded frame is scaled into every attached surface instead of being rendered into each of them
+    [[nodiscard]] auto is_shared() const -> bool;
+
+    // Renders the current frame once for all attached surfaces, with the source's aspect ratio so every surface crops or letterboxes it
+    // only once. The context has to be current.
+    [[nodiscard]] auto render_shared_frame() -> const SharedFrame*;
+
     [[nodiscard]] auto get_display() const -> Display*;
 
     [[nodiscard]] auto is_single_frame() const -> bool;
 
+    // Lowres level to decode a source at, 1 / 2^level of its size, so that it still covers the output with the fit mode. 0 when the
+    // source is less than twice the output's size.
+    [[nodiscard]] static auto calculate_decode_lowres(int64_t source_width, int64_t source_height, int32_t width, int32_t height, FitMode fit_mode)
+        -> int32_t;
+
+    // Size of the shared frame, the source's aspect ratio scaled to cover the largest output for fill and to fit into it otherwise, so the
+    // largest output samples it at its own resolution. The largest output's size while the source's size is unknown.
+    [[nodiscard]] static auto calculate_shared_frame_size(int64_t source_width,
+                                                          int64_t source_height,
+                                                          int32_t width,
+                                                          int32_t height,
+                                                          FitMode fit_mode) -> std::pair<int32_t, int32_t>;
+
    protected:
     auto load_mpv_options() -> void;
 
@@ -69,28 +104,116 @@ class MpvResource : public std::enable_shared_from_this<MpvResource> {
 
     auto handle_file_loaded() -> void;
 
+    // Reads the source's display size once mpv knows it
+    auto handle_video_reconfig() -> void;
+
+    // mpv fits the frame to the surface, unless the frame is shared, then the surfaces fit it themselves
+    auto apply_fit_mode() -> void;
+
+    // Decoders are created after mpv's on_preloaded hook, so the decode resolution for the file is chosen there
+    auto add_preloaded_hook() -> void;
+
+    auto handle_preloaded(uint64_t hook_id) -> void;
+
+    auto limit_decode_resolution() -> void;
+
+    // Starts the timer for the next file and takes the screenshot once the loaded file is on screen
+    auto show_file() -> void;
+
     [[nodiscard]] auto get_config() const -> const Config&;
 
-    virtual auto send_mpv_cmd_base(std::array<const char*, 4> args) const -> void;
+    virtual auto send_mpv_cmd_base(std::array<const char*, 5> args) const -> void;
 
     auto setup_update_callback() -> void;
 
+    auto close_update_callback() -> void;
+
+    // Marks the surfaces dirty, or once the frame interval has passed while the frame rate is capped
+    auto present_frame() -> void;
+
+    auto mark_surfaces_dirty() -> void;
+
+    auto setup_governor() -> void;
+
+    auto update_governor() -> void;
+
+    // Pauses, steps or plays the player for the governor's mode, unless the resource itself is paused
+    auto apply_playback_mode() -> void;
+
+    [[nodiscard]] auto is_hidden(std::chrono::steady_clock::time_point now) const -> bool;
+
    private:
     static auto get_proc_address(void* ctx, const char* name) -> void*;
 
+    // Size in pixels of the largest surface showing the resource
+    [[nodiscard]] auto get_largest_surface_size() const -> std::pair<int32_t, int32_t>;
+
+    // Opens the file paused in a second player, so it is demuxed and its first frame decoded before it is shown
+    auto prepare_standby(const std::filesystem::path& file) -> void;
+
+    // Takes over the standby's player and destroys the current one, false if there is no standby to switch to
+    [[nodiscard]] auto switch_to_standby() -> bool;
+
     const Config& m_config;
 
     bool m_is_mpv_log_enabled{false};
 
     bool m_is_single_frame{false};
 
+    // Duration of the loaded file, 0 for images
+    double m_file_duration{0.0};
+
+    bool m_is_file_loaded{false};
+
+    // lowres level currently set in the player's vd-lavc-o
+    int32_t m_decode_lowres{0};
+
+    // mpv has no way to remove a hook, it stays once limit_decode_resolution was turned on
+    bool m_is_preloaded_hook_added{false};
+
+    // Frame rate of the loaded file, 0 if it has none
+    double m_file_fps{0.0};
+
+    // Size the source is displayed at, 0 until mpv has configured the video
+    int64_t m_video_width{0};
+    int64_t m_video_height{0};
+
+    // Whether mpv was last set up to render a shared frame
+    bool m_is_shared_fit{false};
+
+    static constexpr auto k_governor_interval = std::chrono::seconds{1};
+
+    // A frame callback that has not arrived for this long means the surface is hidden
+    static constexpr auto k_hidden_after = std::chrono::seconds{2};
+
+    MpvPlaybackGovernor m_governor;
+
+    std::unique_ptr<BatteryDiscover> m_battery_discover;
+
+    loop::Timer* m_governor_timer{};
+
+    loop::Timer* m_present_timer{};
+
+    loop::Timer* m_step_timer{};
+
+    std::chrono::steady_clock::time_point m_last_present{};
+
+    // A standby only loads its file, it neither draws to the surface nor starts timers
+    bool m_is_standby{false};
+
+    std::unique_ptr<MpvResource> m_standby;
+
     Display* m_display{};
 
-    Surface* m_surface{};
+    std::vector<Surface*> m_surfaces{};
+
+    std::unique_ptr<SharedFrame> m_shared_frame;
+
+    bool m_is_frame_dirty{true};
 
     bool m_is_paused{false};
 
-    loop::PollPipe* m_mpv_update_async{};
+    loop::PollEvent* m_mpv_update_async{};
 
     MpvResourceConfig m_resource_config{};
 
@@ -23,9 +23,16 @@ auto wall::MpvResourceConfig::build_config(const Config& config, const char* con
     const auto order = StringUtils::trim(get_config_with_fallback<std::string>(config, config_prefix, "sort_order"));
     resource_config.m_is_loop = get_config_with_fallback<bool>(config, config_prefix, "loop");
     resource_config.m_is_keep_same_order = get_config_with_fallback<bool>(config, config_prefix, "keep_same_order");
+    resource_config.m_is_share_decode =
+        resource_config.m_is_keep_same_order && get_config_with_fallback<bool>(config, config_prefix, "share_decode");
     resource_config.m_image_change_interval_secs =
         std::chrono::seconds(get_config_with_fallback<uint64_t>(config, config_prefix, "image_change_interval_secs"));
     resource_config.m_video_preload_secs = std::chrono::seconds(get_config_with_fallback<uint64_t>(config, config_prefix, "video_preload_secs"));
+    resource_config.m_is_standby_preload = get_config_with_fallback<bool>(config, config_prefix, "standby_preload");
+    resource_config.m_is_limit_decode_resolution = get_config_with_fallback<bool>(config, config_prefix, "limit_decode_resolution");
+    resource_config.m_max_fps = static_cast<uint32_t>(get_config_with_fallback<uint64_t>(config, config_prefix, "max_fps"));
+    resource_config.m_battery_max_fps = static_cast<uint32_t>(get_config_with_fallback<uint64_t>(config, config_prefix, "battery_max_fps"));
+    resource_config.m_is_pause_hidden = get_config_with_fallback<bool>(config, config_prefix, "pause_hidden");
     resource_config.m_video_max_change_interval_secs =
         std::chrono::seconds(get_config_with_fallback<uint64_t>(config, config_prefix, "video_max_change_interval_secs"));
     resource_config.m_is_screenshot_enabled = get_config_with_fallback<bool>(config, config_prefix, "screenshot_enabled");
@@ -73,7 +80,9 @@ auto wall::MpvResourceConfig::operator==(const MpvResourceConfig& other) const -
            m_screenshot_directory == other.m_screenshot_directory && m_screenshot_delay_ms == other.m_screenshot_delay_ms &&
            m_image_change_interval_secs == other.m_image_change_interval_secs &&
            m_video_max_change_interval_secs == other.m_video_max_change_interval_secs && m_video_preload_secs == other.m_video_preload_secs &&
-           m_fit_mode == other.m_fit_mode && m_order == other.m_order;
+           m_fit_mode == other.m_fit_mode && m_order == other.m_order && m_is_share_decode == other.m_is_share_decode &&
+           m_is_standby_preload == other.m_is_standby_preload && m_is_limit_decode_resolution == other.m_is_limit_decode_resolution &&
+           m_max_fps == other.m_max_fps && m_battery_max_fps == other.m_battery_max_fps && m_is_pause_hidden == other.m_is_pause_hidden;
 }
 
 auto wall::MpvResourceConfig::to_string() const -> std::string {
@@ -96,5 +105,11 @@ auto wall::MpvResourceConfig::to_string() const -> std::string {
     result += "video_preload_secs: " + std::to_string(m_video_preload_secs.count()) + "\n";
     result += "fit_mode: " + std::to_string(static_cast<int>(m_fit_mode)) + "\n";
     result += "order: " + std::to_string(static_cast<int>(m_order)) + "\n";
+    result += "is_share_decode: " + bool_to_string(m_is_share_decode) + "\n";
+    result += "is_standby_preload: " + bool_to_string(m_is_standby_preload) + "\n";
+    result += "is_limit_decode_resolution: " + bool_to_string(m_is_limit_decode_resolution) + "\n";
+    result += "max_fps: " + std::to_string(m_max_fps) + "\n";
+    result += "battery_max_fps: " + std::to_string(m_battery_max_fps) + "\n";
+    result += "is_pause_hidden: " + bool_to_string(m_is_pause_hidden) + "\n";
     return result;
 }
@@ -49,9 +49,18 @@ struct MpvResourceConfig {
     std::chrono::seconds m_image_change_interval_secs{std::chrono::seconds(conf::k_default_file_image_change_interval_secs)};
     std::chrono::seconds m_video_max_change_interval_secs{std::chrono::seconds(conf::k_default_file_video_max_change_interval_secs)};
     std::chrono::seconds m_video_preload_secs{std::chrono::seconds(conf::k_default_file_video_preload_secs)};
+    // The next file is opened in a standby player and switched to at the end of the current one
+    bool m_is_standby_preload{conf::k_default_file_standby_preload};
+    // Sources much larger than the outputs showing them are decoded at a lower resolution
+    bool m_is_limit_decode_resolution{conf::k_default_file_limit_decode_resolution};
+    uint32_t m_max_fps{static_cast<uint32_t>(conf::k_default_file_max_fps)};
+    uint32_t m_battery_max_fps{static_cast<uint32_t>(conf::k_default_file_battery_max_fps)};
+    bool m_is_pause_hidden{conf::k_default_file_pause_hidden};
     FitMode m_fit_mode{FitMode::Fill};
     Order m_order{Order::None};
     bool m_is_keep_same_order{conf::k_default_file_keep_same_order};
+    // One resource decodes for every output, only with the same order
+    bool m_is_share_decode{conf::k_default_file_share_decode};
 
     [[nodiscard]] auto operator==(const MpvResourceConfig& other) const -> bool;
 
@@ -1,13 +1,17 @@
 #include "mpv/MpvScreenshot.hpp"
 
+#include <gdk-pixbuf/gdk-pixbuf-core.h>
+#include <gdk-pixbuf/gdk-pixbuf-io.h>
+#include <glib-object.h>
 #include <spdlog/common.h>
+#include <unistd.h>
 #include <array>
 #include <csignal>
 #include <cstdlib>
 #include <map>
 #include <optional>
+#include <string_view>
 #include <system_error>
-#include <thread>
 
 #include "conf/ConfigMacros.hpp"
 #include "mpv/MpvResource.hpp"
@@ -21,7 +25,8 @@ namespace wall {
 class Config;
 }  // namespace wall
 
-wall::MpvScreenshot::MpvScreenshot(const Config& config) : m_config(config), m_formatter{get_config()} {}
+wall::MpvScreenshot::MpvScreenshot(const Config& config, Loop* loop, WorkerPool* worker_pool)
+    : m_config(config), m_loop(loop), m_worker_pool(worker_pool), m_formatter{get_config()} {}
 
 wall::MpvScreenshot::~MpvScreenshot() { stop(); }
 
@@ -30,18 +35,26 @@ auto wall::MpvScreenshot::get_config() const -> const Config& { return m_config;
 auto wall::MpvScreenshot::set_resource_config(MpvResourceConfig* resource_config) -> void { m_resource_config = resource_config; }
 
 auto wall::MpvScreenshot::stop() -> void {
-    if (m_screenshot_data != nullptr) {
-        std::lock_guard<std::mutex> lock(m_screenshot_data->m_access_guard);
-        if (m_screenshot_data != nullptr) {
-            m_screenshot_data->m_mpv_screenshot = nullptr;
-            m_screenshot_data = nullptr;
-        }
+    if (m_delay_timer != nullptr) {
+        m_delay_timer->close();
+        m_delay_timer = nullptr;
+    }
+
+    if (m_task != nullptr) {
+        // waits for a screenshot mpv is taking right now
+        std::lock_guard<std::mutex> lock(m_task->m_access_guard);
+        m_task->m_mpv = nullptr;
     }
+    m_task = nullptr;
 }
 
 auto wall::MpvScreenshot::load_options(MpvResource* mpv_resource) -> void {
     m_screenshot_filename_format = StringUtils::trim(wall_conf_get(get_config(), file, screenshot_filename));
     m_screenshot_format = StringUtils::trim(wall_conf_get(get_config(), file, screenshot_format));
+    if (!is_pixbuf_format_writable(get_pixbuf_format(m_screenshot_format))) {
+        LOG_ERROR("Screenshot format {} can not be saved by gdk-pixbuf, using jpg instead", m_screenshot_format);
+        m_screenshot_format = "jpg";
+    }
 
     m_tmp_filename = "screenshot_" + mpv_resource->get_surface()->get_output_name() + "_tmp";
     const auto screenshot_dir = FileUtils::get_expansion_cache(m_resource_config->m_screenshot_directory).value_or("").string();
@@ -50,9 +63,8 @@ auto wall::MpvScreenshot::load_options(MpvResource* mpv_resource) -> void {
         LOG_FATAL("screenshot directory is empty but screenshot is enabled");
     }
 
-    mpv_resource->send_mpv_cmd("set", "screenshot-template", m_tmp_filename.c_str());
-    mpv_resource->send_mpv_cmd("set", "screenshot-dir", screenshot_dir.c_str());
-    mpv_resource->send_mpv_cmd("set", "screenshot-format", m_screenshot_format.c_str());
+    // take the screenshot from the decoded frame, from the window mpv would have to wait for the loop thread to render
+    mpv_resource->send_mpv_cmd("set", "screenshot-sw", "yes");
 }
 
 auto wall::MpvScreenshot::screenshot([[maybe_unused]] const std::filesystem::path& current_filename, [[maybe_unused]] mpv_handle* mpv) -> void {
@@ -60,7 +72,7 @@ auto wall::MpvScreenshot::screenshot([[maybe_unused]] const std::filesystem::pat
         return;
     }
 
-    if (m_screenshot_data != nullptr) {
+    if (m_task != nullptr) {
         LOG_DEBUG("screenshot already in progress");
         return;
     }
@@ -75,93 +87,181 @@ auto wall::MpvScreenshot::screenshot([[maybe_unused]] const std::filesystem::pat
     const auto screenshot_file_tmp = FileUtils::get_expansion_cache(m_resource_config->m_screenshot_directory).value_or("") / screenshot_name_tmp;
     const auto screenshot_file_final = FileUtils::get_expansion_cache(m_resource_config->m_screenshot_directory).value_or("") / screenshot_name_final;
 
-    // take screenshot in uv worker thread
-    m_screenshot_data = new ScreenshotData;
-    m_screenshot_data->m_cmd = m_resource_config->m_screenshot_done_cmd;
-    m_screenshot_data->m_mpv_screenshot = shared_from_this();
-    m_screenshot_data->m_mpv = mpv;
-    m_screenshot_data->m_screenshot_delay = m_resource_config->m_screenshot_delay_ms;
-    m_screenshot_data->m_screenshot_file = screenshot_file_final;
-    m_screenshot_data->m_screenshot_tmp_file = screenshot_file_tmp;
-    m_screenshot_data->m_is_screenshot_cache_enabled = m_resource_config->m_is_screenshot_cache_enabled;
-    m_screenshot_data->m_is_reload_colors_on_success = m_resource_config->m_is_reload_colors_on_success;
-
-    m_screenshot_thread = std::thread(&MpvScreenshot::take_screenshot, m_screenshot_data);
-    m_screenshot_thread.detach();
+    auto task = std::make_shared<ScreenshotTask>();
+    task->m_cmd = m_resource_config->m_screenshot_done_cmd;
+    task->m_pixbuf_format = get_pixbuf_format(m_screenshot_format);
+    task->m_mpv = mpv;
+    task->m_screenshot_file = screenshot_file_final;
+    task->m_screenshot_tmp_file = screenshot_file_tmp;
+    task->m_is_screenshot_cache_enabled = m_resource_config->m_is_screenshot_cache_enabled;
+    task->m_is_reload_colors_on_success = m_resource_config->m_is_reload_colors_on_success;
+    task->m_is_cached = task->m_is_screenshot_cache_enabled && std::filesystem::exists(screenshot_file_final);
+    m_task = task;
+
+    if (task->m_is_cached) {
+        LOG_DEBUG("Using screenshot from cache: {}", screenshot_file_final.string());
+        post_screenshot(task);
+        return;
+    }
+
+    m_delay_timer = m_loop->add_timer(m_resource_config->m_screenshot_delay_ms, std::chrono::milliseconds{0}, [this, task](loop::Timer* timer) {
+        timer->close();
+        m_delay_timer = nullptr;
+        post_screenshot(task);
+    });
 }
 
-auto wall::MpvScreenshot::take_screenshot(ScreenshotData* data) -> void {
-    auto* mpv = data->m_mpv;
+auto wall::MpvScreenshot::post_screenshot(const std::shared_ptr<ScreenshotTask>& task) -> void {
+    m_worker_pool->post([task]() { take_screenshot(task.get()); },
+                        [screenshot = weak_from_this(), task]() {
+                            if (auto mpv_screenshot = screenshot.lock()) {
+                                mpv_screenshot->finish_screenshot(task);
+                            }
+                        });
+}
 
-    {
-        std::lock_guard<std::mutex> lock(data->m_access_guard);
-        if (data->m_mpv_screenshot == nullptr) {
-            delete data;
-            return;
-        }
-        if (data->m_is_screenshot_cache_enabled && std::filesystem::exists(data->m_screenshot_file)) {
-            data->m_mpv_screenshot->m_screenshot_data = nullptr;
+auto wall::MpvScreenshot::take_screenshot(ScreenshotTask* task) -> void {
+    if (!task->m_is_cached) {
+        mpv_node frame{};
+        {
+            std::lock_guard<std::mutex> lock(task->m_access_guard);
+            if (task->m_mpv == nullptr) {
+                // screenshot was cancelled
+                return;
+            }
 
-            LOG_DEBUG("Using screenshot from cache: {}", data->m_screenshot_file.string());
-            const auto is_successful = run_screenshot_callbacks(data->m_screenshot_file, data->m_cmd);
-            if (is_successful && data->m_is_reload_colors_on_success) {
-                raise(SIGUSR1);
+            std::array<const char*, 2> cmd_args = {"screenshot-raw", nullptr};
+            const auto result = mpv_command_ret(task->m_mpv, cmd_args.data(), &frame);
+            if (result < 0) {
+                LOG_ERROR("Failed to take screenshot: {}", mpv_error_string(result));
+                return;
             }
+        }
 
-            delete data;
+        const auto is_saved = save_frame(frame, task->m_screenshot_tmp_file, task->m_pixbuf_format);
+        mpv_free_node_contents(&frame);
+        if (!is_saved) {
             return;
         }
-    }
-
-    std::this_thread::sleep_for(data->m_screenshot_delay);
 
-    {
-        std::lock_guard<std::mutex> lock(data->m_access_guard);
-        if (data->m_mpv_screenshot == nullptr) {
-            // screenshot was cancelled
-            delete data;
+        std::error_code err_code;
+        std::filesystem::rename(task->m_screenshot_tmp_file, task->m_screenshot_file, err_code);
+        if (err_code) {
+            LOG_ERROR("Failed to move screenshot to {}: {}", task->m_screenshot_file.string(), err_code.message());
             return;
         }
+    }
 
-        if (std::filesystem::exists(data->m_screenshot_tmp_file)) {
-            std::filesystem::remove(data->m_screenshot_tmp_file);
-        }
-        std::array<const char*, 2> cmd_args = {"screenshot", nullptr};
-        mpv_command(mpv, cmd_args.data());
+    task->m_is_successful = run_screenshot_callbacks(task->m_screenshot_file, task->m_cmd);
+}
 
-        // clear the screenshot data
-        data->m_mpv_screenshot->m_screenshot_data = nullptr;
+auto wall::MpvScreenshot::finish_screenshot(const std::shared_ptr<ScreenshotTask>& task) -> void {
+    if (m_task == task) {
+        m_task = nullptr;
     }
 
-    // wait for screenshot to be written, the file size will be non-zero
-    std::chrono::milliseconds timeout{10 * 1000};
-    std::error_code err_code;
-    while (std::filesystem::file_size(data->m_screenshot_tmp_file, err_code) == 0 && timeout.count() > 0) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        timeout -= std::chrono::milliseconds{1};
+    if (task->m_is_successful && task->m_is_reload_colors_on_success) {
+        kill(getpid(), SIGUSR1);
     }
 
-    if (std::filesystem::file_size(data->m_screenshot_tmp_file, err_code) == 0) {
-        delete data;
-        return;
+    if (!task->m_is_screenshot_cache_enabled) {
+        m_loop->add_timer(k_remove_delay, std::chrono::milliseconds{0}, [screenshot_file = task->m_screenshot_file](loop::Timer* timer) {
+            timer->close();
+            std::error_code err_code;
+            std::filesystem::remove(screenshot_file, err_code);
+        });
     }
+}
 
-    std::filesystem::rename(data->m_screenshot_tmp_file, data->m_screenshot_file, err_code);
+auto wall::MpvScreenshot::save_frame(const mpv_node& frame, const std::filesystem::path& file, const std::string& pixbuf_format) -> bool {
+    if (frame.format != MPV_FORMAT_NODE_MAP) {
+        LOG_ERROR("Unexpected screenshot result");
+        return false;
+    }
 
-    if (!err_code) {
-        const auto is_successful = run_screenshot_callbacks(data->m_screenshot_file, data->m_cmd);
-        if (is_successful && data->m_is_reload_colors_on_success) {
-            raise(SIGUSR1);
+    int64_t width = 0;
+    int64_t height = 0;
+    int64_t stride = 0;
+    std::string_view format;
+    const mpv_byte_array* data = nullptr;
+    for (auto i = 0; i < frame.u.list->num; i++) {
+        const std::string_view key = frame.u.list->keys[i];
+        const auto& value = frame.u.list->values[i];
+        if (key == "w" && value.format == MPV_FORMAT_INT64) {
+            width = value.u.int64;
+        } else if (key == "h" && value.format == MPV_FORMAT_INT64) {
+            height = value.u.int64;
+        } else if (key == "stride" && value.format == MPV_FORMAT_INT64) {
+            stride = value.u.int64;
+        } else if (key == "format" && value.format == MPV_FORMAT_STRING) {
+            format = value.u.string;
+        } else if (key == "data" && value.format == MPV_FORMAT_BYTE_ARRAY) {
+            data = value.u.ba;
         }
     }
 
-    if (!data->m_is_screenshot_cache_enabled) {
-        // give enough time for the callback commands to run before deleting the screenshot
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-        std::filesystem::remove(data->m_screenshot_file);
+    if (format != "bgr0" || width <= 0 || height <= 0 || stride < width * 4 || data == nullptr ||
+        data->size < static_cast<size_t>(stride) * static_cast<size_t>(height)) {
+        LOG_ERROR("Unexpected screenshot frame: {}x{} {}", width, height, format);
+        return false;
+    }
+
+    GdkPixbuf* pixbuf = gdk_pixbuf_new(GDK_COLORSPACE_RGB, FALSE, 8, static_cast<int>(width), static_cast<int>(height));
+    if (pixbuf == nullptr) {
+        LOG_ERROR("Failed to allocate screenshot of {}x{}", width, height);
+        return false;
+    }
+
+    const auto* src = static_cast<const uint8_t*>(data->data);
+    auto* dst = gdk_pixbuf_get_pixels(pixbuf);
+    const auto dst_stride = static_cast<size_t>(gdk_pixbuf_get_rowstride(pixbuf));
+    for (int64_t row = 0; row < height; row++) {
+        bgr0_to_rgb(src + (row * stride), dst + (static_cast<size_t>(row) * dst_stride), static_cast<size_t>(width));
+    }
+
+    // same quality mpv saves jpg screenshots with
+    std::array<char*, 2> option_keys{nullptr, nullptr};
+    std::array<char*, 2> option_values{nullptr, nullptr};
+    std::string quality_key = "quality";
+    std::string quality_value = "90";
+    if (pixbuf_format == "jpeg") {
+        option_keys[0] = quality_key.data();
+        option_values[0] = quality_value.data();
+    }
+
+    GError* err = nullptr;
+    const auto is_saved = gdk_pixbuf_savev(pixbuf, file.c_str(), pixbuf_format.c_str(), option_keys.data(), option_values.data(), &err) != FALSE;
+    if (!is_saved) {
+        LOG_ERROR("Failed to save screenshot ({}): {}", file.string(), err->message);
+        g_error_free(err);
+    }
+
+    g_object_unref(pixbuf);
+    return is_saved;
+}
+
+auto wall::MpvScreenshot::bgr0_to_rgb(const uint8_t* src, uint8_t* dst, size_t count) -> void {
+    for (size_t i = 0; i < count; i++) {
+        dst[(i * 3) + 0] = src[(i * 4) + 2];
+        dst[(i * 3) + 1] = src[(i * 4) + 1];
+        dst[(i * 3) + 2] = src[(i * 4) + 0];
+    }
+}
+
+auto wall::MpvScreenshot::get_pixbuf_format(const std::string& format) -> std::string { return format == "jpg" ? "jpeg" : format; }
+
+auto wall::MpvScreenshot::is_pixbuf_format_writable(const std::string& pixbuf_format) -> bool {
+    auto* formats = gdk_pixbuf_get_formats();
+    auto is_writable = false;
+    for (auto* iter = formats; iter != nullptr && !is_writable; iter = iter->next) {
+        auto* format = static_cast<GdkPixbufFormat*>(iter->data);
+        auto* name = gdk_pixbuf_format_get_name(format);
+        is_writable = name != nullptr && pixbuf_format == name && gdk_pixbuf_format_is_writable(format) != FALSE;
+        g_free(name);
     }
 
-    delete data;
+    g_slist_free(formats);
+    return is_writable;
 }
 
 auto wall::MpvScreenshot::replace_filename(const std::string& replace, std::string& subject) -> void {
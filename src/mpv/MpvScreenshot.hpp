@@ -1,18 +1,37 @@
 #pragma once
 
+#include <mpv/client.h>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <thread>
 #include "mpv/MpvResource.hpp"
 #include "util/Formatter.hpp"
+#include "util/Loop.hpp"
+#include "util/WorkerPool.hpp"
 
 namespace wall {
 class MpvResource;
+
+// Takes a screenshot of the file once it is on screen. mpv hands over the raw frame, it is encoded and saved on the worker pool and the
+// done command runs there too, the loop is woken up once it has finished.
 class MpvScreenshot : public std::enable_shared_from_this<MpvScreenshot> {
    public:
-    MpvScreenshot(const Config& config);
+    // Time the done command has to read the screenshot before it is removed when the cache is disabled
+    static constexpr auto k_remove_delay = std::chrono::seconds{1};
+
+    MpvScreenshot(const Config& config, Loop* loop, WorkerPool* worker_pool);
 
     ~MpvScreenshot();
 
+    MpvScreenshot(MpvScreenshot&&) = delete;
+    MpvScreenshot(const MpvScreenshot&) = delete;
+    auto operator=(const MpvScreenshot&) -> MpvScreenshot = delete;
+    auto operator=(MpvScreenshot&&) -> MpvScreenshot = delete;
+
+    // Cancels the screenshot in progress, mpv is not used anymore once this returns
     auto stop() -> void;
 
     auto load_options(MpvResource* mpv_resource) -> void;
@@ -21,6 +40,15 @@ class MpvScreenshot : public std::enable_shared_from_this<MpvScreenshot> {
 
     auto set_resource_config(MpvResourceConfig* resource_config) -> void;
 
+    // Converts a row of mpv's bgr0 pixels to the packed RGB gdk-pixbuf saves
+    static auto bgr0_to_rgb(const uint8_t* src, uint8_t* dst, size_t count) -> void;
+
+    // Name gdk-pixbuf saves the screenshot format under
+    [[nodiscard]] static auto get_pixbuf_format(const std::string& format) -> std::string;
+
+    // Whether gdk-pixbuf has a saver for the format, formats like webp or avif depend on the loaders that are installed
+    [[nodiscard]] static auto is_pixbuf_format_writable(const std::string& pixbuf_format) -> bool;
+
    protected:
     [[nodiscard]] auto get_config() const -> const Config&;
 
@@ -29,27 +57,41 @@ class MpvScreenshot : public std::enable_shared_from_this<MpvScreenshot> {
     static auto run_screenshot_callbacks(const std::filesystem::path& screenshot_file, const std::string& cmd) -> bool;
 
    private:
-    struct ScreenshotData {
-        mpv_handle* m_mpv{};
+    struct ScreenshotTask {
         std::string m_cmd;
+        std::string m_pixbuf_format;
         bool m_is_screenshot_cache_enabled{};
         bool m_is_reload_colors_on_success{false};
+        // The cached screenshot only needs the done command
+        bool m_is_cached{false};
+        bool m_is_successful{false};
         std::filesystem::path m_screenshot_file;
         std::filesystem::path m_screenshot_tmp_file;
-        std::chrono::milliseconds m_screenshot_delay;
         std::mutex m_access_guard{};
-        std::shared_ptr<MpvScreenshot> m_mpv_screenshot{};
+        // Guarded by m_access_guard, null once the screenshot is cancelled
+        mpv_handle* m_mpv{};
     };
 
-    static auto take_screenshot(ScreenshotData* data) -> void;
+    auto post_screenshot(const std::shared_ptr<ScreenshotTask>& task) -> void;
+
+    auto finish_screenshot(const std::shared_ptr<ScreenshotTask>& task) -> void;
+
+    // Runs on the worker pool
+    static auto take_screenshot(ScreenshotTask* task) -> void;
+
+    static auto save_frame(const mpv_node& frame, const std::filesystem::path& file, const std::string& pixbuf_format) -> bool;
 
     const Config& m_config;
 
-    std::string m_tmp_filename;
+    Loop* m_loop;
 
-    std::thread m_screenshot_thread;
+    WorkerPool* m_worker_pool;
+
+    loop::Timer* m_delay_timer{};
+
+    std::string m_tmp_filename;
 
-    ScreenshotData* m_screenshot_data{};
+    std::shared_ptr<ScreenshotTask> m_task{};
 
     MpvResourceConfig* m_resource_config{};
 
@@ -1,5 +1,6 @@
 #include "overlay/CairoAnalogClockElement.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <compare>
@@ -8,6 +9,7 @@
 
 #include "State.hpp"
 #include "conf/ConfigMacros.hpp"
+#include "util/ClockUtils.hpp"
 
 namespace wall {
 class Config;
@@ -15,6 +17,8 @@ class Config;
 
 wall::CairoAnalogClockElement::CairoAnalogClockElement(const Config& config) : m_config(config) { update_settings(); }
 
+wall::CairoAnalogClockElement::~CairoAnalogClockElement() { clear_layers(); }
+
 auto wall::CairoAnalogClockElement::get_config() const -> const Config& { return m_config; }
 
 auto wall::CairoAnalogClockElement::update_settings() -> void {
@@ -45,6 +49,8 @@ auto wall::CairoAnalogClockElement::update_settings() -> void {
     m_is_hour_marker_enabled = wall_conf_get(get_config(), lock_indicator, analog_clock_hour_marker_enabled);
     m_is_second_marker_enabled = wall_conf_get(get_config(), lock_indicator, analog_clock_second_marker_enabled);
 
+    clear_layers();
+    m_layers.m_bounds.reset();
     update_colors();
 }
 
@@ -66,37 +72,41 @@ auto wall::CairoAnalogClockElement::update_colors() -> void {
     m_markers.m_caps_lock = wall_conf_get(get_config(), lock_indicator, analog_clock_marker_color_caps_lock);
     m_markers.m_verifying = wall_conf_get(get_config(), lock_indicator, analog_clock_marker_color_verifying);
     m_markers.m_wrong = wall_conf_get(get_config(), lock_indicator, analog_clock_marker_color_wrong);
+    m_drawn = DrawnState{};
 }
 
-auto wall::CairoAnalogClockElement::get_min_redraw_time() const -> std::chrono::milliseconds {
+auto wall::CairoAnalogClockElement::get_redraw_period() const -> std::chrono::seconds {
     if (m_is_second_hand_enabled) {
-        return std::chrono::milliseconds(1000);
+        return std::chrono::seconds{1};
     }
 
     if (m_is_minute_hand_enabled) {
-        return std::chrono::milliseconds(60000);
+        return std::chrono::minutes{1};
     }
 
     if (m_is_hour_hand_enabled) {
-        return std::chrono::milliseconds(3600000);
+        return std::chrono::hours{1};
     }
 
-    return std::chrono::milliseconds::zero();
+    return std::chrono::seconds::zero();
 }
 
-auto wall::CairoAnalogClockElement::should_redraw(const std::chrono::milliseconds& time_since_last_draw) const -> bool {
-    const auto min_redraw_time = get_min_redraw_time();
-    if (get_min_redraw_time().count() > 0) {
-        return time_since_last_draw >= min_redraw_time;
+auto wall::CairoAnalogClockElement::should_redraw(std::chrono::system_clock::time_point last_draw_time,
+                                                  std::chrono::system_clock::time_point now) const -> bool {
+    const auto period = get_redraw_period();
+    if (period.count() > 0) {
+        return ClockUtils::get_tick(last_draw_time, period) != ClockUtils::get_tick(now, period);
     }
 
     return false;
 }
 
-auto wall::CairoAnalogClockElement::draw(cairo_t* cairo, double center_x, double center_y, State indicator_state) const -> std::chrono::milliseconds {
-    // draw analog clock arms in the inner circle
+auto wall::CairoAnalogClockElement::get_time_to_redraw(std::chrono::system_clock::time_point now) const -> std::chrono::milliseconds {
+    return ClockUtils::get_time_to_next_tick(now, get_redraw_period());
+}
 
-    const auto time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+auto wall::CairoAnalogClockElement::get_hand_angles(std::chrono::system_clock::time_point now) -> HandAngles {
+    const auto time = std::chrono::system_clock::to_time_t(now);
     const auto* local_time = std::localtime(&time);
 
     const auto seconds = local_time->tm_sec;
@@ -107,60 +117,113 @@ auto wall::CairoAnalogClockElement::draw(cairo_t* cairo, double center_x, double
     const auto minute_angle = (minutes * 6.0) * (std::numbers::pi / 180.0);
     const auto hour_angle = ((hours % 12) * 30.0) * (std::numbers::pi / 180.0) + (minute_angle / 12.0);
 
+    return {.m_hour = hour_angle, .m_minute = minute_angle, .m_second = second_angle};
+}
+
+auto wall::CairoAnalogClockElement::is_same_colors(State state, State other_state) const -> bool {
+    return m_hands.get(state) == m_hands.get(other_state) && m_center.get(state) == m_center.get(other_state) &&
+           m_markers.get(state) == m_markers.get(other_state);
+}
+
+auto wall::CairoAnalogClockElement::add_damage(CairoDamage* damage,
+                                               double center_x,
+                                               double center_y,
+                                               State indicator_state,
+                                               std::chrono::system_clock::time_point now) const -> void {
+    if (!m_drawn.m_is_valid || !is_same_colors(m_drawn.m_state, indicator_state)) {
+        const auto radius = std::max({m_hour_hand_length, m_minute_hand_length, m_second_hand_length, m_hour_marker_radius,
+                                      m_second_marker_radius, m_center_radius});
+        const auto thickness = std::max({m_hour_hand_thickness, m_minute_hand_thickness, m_second_hand_thickness, m_hour_marker_thickness,
+                                         m_second_marker_thickness});
+        damage->add_circle(center_x, center_y, radius + thickness);
+        return;
+    }
+
+    const auto angles = get_hand_angles(now);
+    const auto add_if_moved = [&](bool is_enabled, double old_angle, double angle, double thickness, double length) {
+        if (is_enabled && old_angle != angle) {
+            add_hand_damage(damage, center_x, center_y, old_angle, thickness, length);
+            add_hand_damage(damage, center_x, center_y, angle, thickness, length);
+        }
+    };
+
+    add_if_moved(m_is_hour_hand_enabled, m_drawn.m_angles.m_hour, angles.m_hour, m_hour_hand_thickness, m_hour_hand_length);
+    add_if_moved(m_is_minute_hand_enabled, m_drawn.m_angles.m_minute, angles.m_minute, m_minute_hand_thickness, m_minute_hand_length);
+    add_if_moved(m_is_second_hand_enabled, m_drawn.m_angles.m_second, angles.m_second, m_second_hand_thickness, m_second_hand_length);
+}
+
+auto wall::CairoAnalogClockElement::add_hand_damage(CairoDamage* damage,
+                                                    double center_x,
+                                                    double center_y,
+                                                    double angle,
+                                                    double thickness,
+                                                    double length) const -> void {
+    damage->add_line(center_x, center_y, center_x + (length * std::sin(angle)), center_y - (length * std::cos(angle)), thickness);
+}
+
+auto wall::CairoAnalogClockElement::draw(cairo_t* cairo,
+                                         double center_x,
+                                         double center_y,
+                                         State indicator_state,
+                                         std::chrono::system_clock::time_point now) -> void {
+    update_layer_bounds(center_x, center_y);
+
+    // draw analog clock arms in the inner circle
+    const auto angles = get_hand_angles(now);
+    const auto& hand_color = m_hands.get(indicator_state);
+
     if (m_is_hour_hand_enabled) {
-        // draw hour hand
-        draw_hand(cairo, center_x, center_y, hour_angle, m_hour_hand_thickness, m_hour_hand_length, m_hands.get(indicator_state));
+        draw_hand(cairo, angles.m_hour, m_hour_hand_thickness, m_hour_hand_length, hand_color, &m_layers.m_hour_hand);
     }
 
     if (m_is_minute_hand_enabled) {
-        // draw minute hand
-        draw_hand(cairo, center_x, center_y, minute_angle, m_minute_hand_thickness, m_minute_hand_length, m_hands.get(indicator_state));
+        draw_hand(cairo, angles.m_minute, m_minute_hand_thickness, m_minute_hand_length, hand_color, &m_layers.m_minute_hand);
     }
 
     if (m_is_second_hand_enabled) {
-        // draw second hand
-        draw_hand(cairo, center_x, center_y, second_angle, m_second_hand_thickness, m_second_hand_length, m_hands.get(indicator_state));
+        draw_hand(cairo, angles.m_second, m_second_hand_thickness, m_second_hand_length, hand_color, &m_layers.m_second_hand);
     }
 
     if (m_is_center_enabled) {
-        // draw center circle
-        cairo_set_line_width(cairo, 0.0);
-        cairo_arc(cairo, center_x, center_y, m_center_radius, 0, 2.0 * std::numbers::pi);
         Color::set_cairo_color(cairo, m_center.get(indicator_state));
-        cairo_fill_preserve(cairo);
-        cairo_stroke(cairo);
-    }
-
-    if (m_is_hour_marker_enabled) {
-        draw_markers(cairo, center_x, center_y, 12, m_hour_marker_radius, m_hour_marker_thickness, m_hour_marker_length,
-                     m_markers.get(indicator_state));
+        cairo_mask_surface(cairo, get_center_layer(cairo), m_layers.m_bounds.get_x_pos(), m_layers.m_bounds.get_y_pos());
     }
 
-    if (m_is_second_marker_enabled) {
-        draw_markers(cairo, center_x, center_y, 60, m_second_marker_radius, m_second_marker_thickness, m_second_marker_length,
-                     m_markers.get(indicator_state));
+    if (m_is_hour_marker_enabled || m_is_second_marker_enabled) {
+        Color::set_cairo_color(cairo, m_markers.get(State::Input));
+        cairo_mask_surface(cairo, get_marker_layer(cairo), m_layers.m_bounds.get_x_pos(), m_layers.m_bounds.get_y_pos());
     }
 
-    return get_min_redraw_time();
+    m_drawn = DrawnState{.m_is_valid = true, .m_state = indicator_state, .m_angles = angles};
 }
 
-auto wall::CairoAnalogClockElement::draw_hand(cairo_t* cairo,
-                                              double center_x,
-                                              double center_y,
-                                              double angle,
-                                              double thickness,
-                                              double length,
-                                              const Color& color) const -> void {
-    cairo_set_line_width(cairo, thickness);
-    cairo_move_to(cairo, center_x, center_y);
-
-    const auto hour_x = center_x + (length * std::sin(angle));
-    const auto hour_y = center_y - (length * std::cos(angle));
+auto wall::CairoAnalogClockElement::draw_hand(cairo_t* cairo, double angle, double thickness, double length, const Color& color, HandSprite* sprite)
+    -> void {
+    const auto& bounds = m_layers.m_bounds;
+    if (sprite->m_surface == nullptr) {
+        // the pivot has the same offset within its pixel as the clock's center, so a hand pointing straight up is not filtered at all
+        sprite->m_pivot_x = std::ceil(CairoLayerBounds::k_margin + (thickness / 2.0)) + (bounds.get_center_x() - std::floor(bounds.get_center_x()));
+        sprite->m_pivot_y = std::ceil(CairoLayerBounds::k_margin + length) + (bounds.get_center_y() - std::floor(bounds.get_center_y()));
+        const auto width = static_cast<int32_t>(std::ceil(sprite->m_pivot_x + (thickness / 2.0) + CairoLayerBounds::k_margin));
+        const auto height = static_cast<int32_t>(std::ceil(sprite->m_pivot_y + CairoLayerBounds::k_margin));
+
+        auto* sprite_cairo = CairoLayerBounds::create_mask_cairo(cairo, width, height);
+        cairo_set_line_width(sprite_cairo, thickness);
+        cairo_move_to(sprite_cairo, sprite->m_pivot_x, sprite->m_pivot_y);
+        cairo_line_to(sprite_cairo, sprite->m_pivot_x, sprite->m_pivot_y - length);
+        cairo_stroke(sprite_cairo);
+
+        sprite->m_surface = cairo_surface_reference(cairo_get_target(sprite_cairo));
+        cairo_destroy(sprite_cairo);
+    }
 
-    cairo_line_to(cairo, hour_x, hour_y);
+    // rotating clockwise from twelve turns the hand's direction into (sin, -cos) like the damage expects
+    cairo_save(cairo);
     Color::set_cairo_color(cairo, color);
-
-    cairo_stroke(cairo);
+    cairo_translate(cairo, bounds.get_center_x(), bounds.get_center_y());
+    cairo_rotate(cairo, angle);
+    cairo_mask_surface(cairo, sprite->m_surface, -sprite->m_pivot_x, -sprite->m_pivot_y);
+    cairo_restore(cairo);
 }
 
 auto wall::CairoAnalogClockElement::draw_markers(cairo_t* cairo,
@@ -169,8 +232,7 @@ auto wall::CairoAnalogClockElement::draw_markers(cairo_t* cairo,
                                                  uint32_t count,
                                                  double marker_radius,
                                                  double thickness,
-                                                 double length,
-                                                 const Color& /* color*/) const -> void {
+                                                 double length) -> void {
     const auto degrees = 360.0 / count;
     // draw hour markers
     for (auto marker_ix = 0U; marker_ix < count; marker_ix++) {
@@ -184,8 +246,57 @@ auto wall::CairoAnalogClockElement::draw_markers(cairo_t* cairo,
         const auto marker_end_y = center_y - ((marker_radius - length) * std::cos(angle));
 
         cairo_line_to(cairo, marker_end_x, marker_end_y);
-        Color::set_cairo_color(cairo, m_markers.get(State::Input));
-
         cairo_stroke(cairo);
     }
 }
+
+auto wall::CairoAnalogClockElement::get_center_layer(cairo_t* cairo) -> cairo_surface_t* {
+    if (m_layers.m_center != nullptr) {
+        return m_layers.m_center;
+    }
+
+    const auto& bounds = m_layers.m_bounds;
+    auto* layer_cairo = bounds.create_mask_cairo(cairo);
+    cairo_arc(layer_cairo, bounds.get_center_x(), bounds.get_center_y(), m_center_radius, 0, 2.0 * std::numbers::pi);
+    cairo_fill(layer_cairo);
+
+    m_layers.m_center = cairo_surface_reference(cairo_get_target(layer_cairo));
+    cairo_destroy(layer_cairo);
+    return m_layers.m_center;
+}
+
+auto wall::CairoAnalogClockElement::get_marker_layer(cairo_t* cairo) -> cairo_surface_t* {
+    if (m_layers.m_markers != nullptr) {
+        return m_layers.m_markers;
+    }
+
+    // overlapping markers add up to the same coverage as stroking them one after another in the same color
+    const auto& bounds = m_layers.m_bounds;
+    auto* layer_cairo = bounds.create_mask_cairo(cairo);
+    if (m_is_hour_marker_enabled) {
+        draw_markers(layer_cairo, bounds.get_center_x(), bounds.get_center_y(), 12, m_hour_marker_radius, m_hour_marker_thickness,
+                     m_hour_marker_length);
+    }
+
+    if (m_is_second_marker_enabled) {
+        draw_markers(layer_cairo, bounds.get_center_x(), bounds.get_center_y(), 60, m_second_marker_radius, m_second_marker_thickness,
+                     m_second_marker_length);
+    }
+
+    m_layers.m_markers = cairo_surface_reference(cairo_get_target(layer_cairo));
+    cairo_destroy(layer_cairo);
+    return m_layers.m_markers;
+}
+
+auto wall::CairoAnalogClockElement::update_layer_bounds(double center_x, double center_y) -> void {
+    const auto radius = std::max({m_hour_marker_radius, m_second_marker_radius, m_center_radius});
+    const auto thickness = std::max(m_hour_marker_thickness, m_second_marker_thickness);
+    if (m_layers.m_bounds.update(center_x, center_y, radius + (thickness / 2.0))) {
+        clear_layers();
+    }
+}
+
+auto wall::CairoAnalogClockElement::clear_layers() -> void {
+    CairoLayerBounds::destroy_surfaces({&m_layers.m_center, &m_layers.m_markers, &m_layers.m_hour_hand.m_surface,
+                                        &m_layers.m_minute_hand.m_surface, &m_layers.m_second_hand.m_surface});
+}
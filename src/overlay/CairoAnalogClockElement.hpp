@@ -1,6 +1,8 @@
 #pragma once
 
 #include "conf/Config.hpp"
+#include "overlay/CairoDamage.hpp"
+#include "overlay/CairoLayerBounds.hpp"
 #include "overlay/ColorSet.hpp"
 
 #include <cairo.h>
@@ -10,10 +12,29 @@ namespace wall {
 class CairoAnalogClockElement {
    public:
     CairoAnalogClockElement(const Config& config);
+    ~CairoAnalogClockElement();
 
-    auto draw(cairo_t* cairo, double center_x, double center_y, State indicator_state) const -> std::chrono::milliseconds;
+    CairoAnalogClockElement(CairoAnalogClockElement&&) = delete;
+    CairoAnalogClockElement(const CairoAnalogClockElement&) = delete;
+    auto operator=(const CairoAnalogClockElement&) -> CairoAnalogClockElement = delete;
+    auto operator=(CairoAnalogClockElement&&) -> CairoAnalogClockElement = delete;
 
-    [[nodiscard]] auto should_redraw(const std::chrono::milliseconds& time_since_last_draw) const -> bool;
+    auto draw(cairo_t* cairo,
+              double center_x,
+              double center_y,
+              State indicator_state,
+              std::chrono::system_clock::time_point now = std::chrono::system_clock::now()) -> void;
+
+    // Adds the hands that move and everything if the colors change, compared to the last draw
+    auto add_damage(CairoDamage* damage, double center_x, double center_y, State indicator_state, std::chrono::system_clock::time_point now) const
+        -> void;
+
+    // True if a hand moved to its next tick since the last draw
+    [[nodiscard]] auto should_redraw(std::chrono::system_clock::time_point last_draw_time, std::chrono::system_clock::time_point now) const
+        -> bool;
+
+    // Time until the fastest enabled hand moves, aligned to the clock, zero without hands
+    [[nodiscard]] auto get_time_to_redraw(std::chrono::system_clock::time_point now) const -> std::chrono::milliseconds;
 
     auto update_settings() -> void;
 
@@ -22,18 +43,47 @@ class CairoAnalogClockElement {
    protected:
     [[nodiscard]] auto get_config() const -> const Config&;
 
-    [[nodiscard]] auto get_min_redraw_time() const -> std::chrono::milliseconds;
+    [[nodiscard]] auto get_redraw_period() const -> std::chrono::seconds;
+
+    struct HandAngles {
+        double m_hour{};
+        double m_minute{};
+        double m_second{};
+    };
+
+    [[nodiscard]] static auto get_hand_angles(std::chrono::system_clock::time_point now) -> HandAngles;
+
+    [[nodiscard]] auto is_same_colors(State state, State other_state) const -> bool;
+
+    auto add_hand_damage(CairoDamage* damage, double center_x, double center_y, double angle, double thickness, double length) const -> void;
+
+    // Coverage of a hand pointing at twelve. It is rotated around its pivot, which sits on the clock's center, when it is drawn.
+    struct HandSprite {
+        cairo_surface_t* m_surface{};
+        double m_pivot_x{};
+        double m_pivot_y{};
+    };
+
+    // Paints the hand's color through its rotated sprite, the sprite is rendered on first use
+    auto draw_hand(cairo_t* cairo, double angle, double thickness, double length, const Color& color, HandSprite* sprite) -> void;
 
-    auto draw_hand(cairo_t* cairo, double center_x, double center_y, double angle, double thickness, double length, const Color& color) const -> void;
+    // Only strokes the markers, the source is set by the caller
+    static auto draw_markers(cairo_t* cairo,
+                             double center_x,
+                             double center_y,
+                             uint32_t count,
+                             double marker_radius,
+                             double thickness,
+                             double length) -> void;
 
-    auto draw_markers(cairo_t* cairo,
-                      double center_x,
-                      double center_y,
-                      uint32_t count,
-                      double marker_radius,
-                      double thickness,
-                      double length,
-                      const Color& color) const -> void;
+    [[nodiscard]] auto get_center_layer(cairo_t* cairo) -> cairo_surface_t*;
+
+    [[nodiscard]] auto get_marker_layer(cairo_t* cairo) -> cairo_surface_t*;
+
+    // Drops the layers and sprites if they were rendered for another position
+    auto update_layer_bounds(double center_x, double center_y) -> void;
+
+    auto clear_layers() -> void;
 
    private:
     const Config& m_config;
@@ -68,5 +118,28 @@ class CairoAnalogClockElement {
 
     bool m_is_hour_marker_enabled{true};
     bool m_is_second_marker_enabled{true};
+
+    struct DrawnState {
+        bool m_is_valid{false};
+        State m_state{State::None};
+        HandAngles m_angles{};
+    };
+
+    DrawnState m_drawn{};
+
+    // Coverage of everything that does not move, rendered once for the clock's position and painted through with the state's colors.
+    // Hands are stroked once as well and only rotated afterwards, so a tick costs compositing the hands within the damaged area.
+    struct Layers {
+        CairoLayerBounds m_bounds{};
+
+        cairo_surface_t* m_center{};
+        cairo_surface_t* m_markers{};
+
+        HandSprite m_hour_hand{};
+        HandSprite m_minute_hand{};
+        HandSprite m_second_hand{};
+    };
+
+    Layers m_layers{};
 };
 }  // namespace wall
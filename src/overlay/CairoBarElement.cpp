@@ -57,26 +57,18 @@ auto wall::CairoBarElement::update_settings() -> void {
     m_text_top_bottom_margin = wall_conf_get(get_config(), lock_bar, text_top_bottom_margin);
 
     m_font_color = wall_conf_get_with_fallback(get_config(), lock_bar, font_color, font, color);
+    m_drawn = DrawnState{};
 }
 
 auto wall::CairoBarElement::get_buffer_size(int32_t width,
                                             int32_t height,
                                             const CairoFontCache& font_cache,
                                             const std::string& message) const -> std::pair<int32_t, int32_t> {
-    auto* font_face = font_cache.get_font_face();
-    auto font_size = font_cache.get_font_size();
-    auto* cairo = font_cache.get_font_cairo_state()->get_cairo();
-    cairo_set_antialias(cairo, CAIRO_ANTIALIAS_BEST);
-    cairo_set_font_face(cairo, font_face);
-    cairo_set_font_size(cairo, font_size);
-
     auto buffer_width = width;
     auto buffer_height = height;
 
     if (!message.empty()) {
-        cairo_text_extents_t text_extents;
-
-        cairo_text_extents(cairo, message.c_str(), &text_extents);
+        const auto& text_extents = font_cache.get_text_extents(message);
         buffer_width = (text_extents.width < buffer_width) ? text_extents.width : buffer_width;
         buffer_height = (text_extents.height < buffer_height) ? text_extents.height : buffer_height;
         buffer_width += (m_border_width * 2);
@@ -128,27 +120,56 @@ auto wall::CairoBarElement::get_position_size(int32_t width,
     return {subsurf_xpos, subsurf_ypos};
 }
 
-auto wall::CairoBarElement::draw(cairo_t* cairo, double width, double height, const CairoFontCache& font_cache, const std::string& message) const
+auto wall::CairoBarElement::draw(cairo_t* cairo, double width, double height, const CairoFontCache& font_cache, const std::string& message)
     -> void {
     draw_background(cairo, width, height);
     draw_text(cairo, width, height, font_cache, message);
 }
 
-auto wall::CairoBarElement::draw_text(cairo_t* cairo, double width, double height, const CairoFontCache& font_cache, const std::string& message) const
-    -> void {
-    Color::set_cairo_color(cairo, m_font_color);
-    cairo_set_font_face(cairo, font_cache.get_font_face());
-    cairo_set_font_size(cairo, font_cache.get_font_size());
+auto wall::CairoBarElement::add_damage(CairoDamage* damage,
+                                       double width,
+                                       double height,
+                                       const CairoFontCache& font_cache,
+                                       const std::string& message) const -> void {
+    if (m_drawn.m_is_valid && m_drawn.m_message == message) {
+        return;
+    }
+
+    if (m_drawn.m_is_valid) {
+        damage->add_rect(m_drawn.m_rect.x, m_drawn.m_rect.y, m_drawn.m_rect.width, m_drawn.m_rect.height);
+    }
 
     cairo_text_extents_t text_extents;
-    cairo_font_extents_t font_extents;
-    cairo_text_extents(cairo, message.c_str(), &text_extents);
-    cairo_font_extents(cairo, &font_extents);
-    const auto text_x = (width / 2.0) - (text_extents.width / 2.0) + text_extents.x_bearing;
+    const auto [text_x, text_y] = layout_text(width, height, font_cache, message, &text_extents);
+    damage->add_rect(text_x + text_extents.x_bearing, text_y + text_extents.y_bearing, text_extents.width, text_extents.height);
+}
+
+auto wall::CairoBarElement::layout_text(double width,
+                                        double height,
+                                        const CairoFontCache& font_cache,
+                                        const std::string& message,
+                                        cairo_text_extents_t* text_extents) const -> std::pair<double, double> {
+    *text_extents = font_cache.get_text_extents(message);
+    const auto& font_extents = font_cache.get_font_extents();
+    const auto text_x = (width / 2.0) - (text_extents->width / 2.0) + text_extents->x_bearing;
     const auto text_y = (height / 2.0) + (font_extents.height / 2.0) - font_extents.descent;
 
-    cairo_move_to(cairo, text_x, text_y);
-    cairo_show_text(cairo, message.c_str());
+    return {text_x, text_y};
+}
+
+auto wall::CairoBarElement::draw_text(cairo_t* cairo, double width, double height, const CairoFontCache& font_cache, const std::string& message)
+    -> void {
+    Color::set_cairo_color(cairo, m_font_color);
+
+    cairo_text_extents_t text_extents;
+    const auto [text_x, text_y] = layout_text(width, height, font_cache, message, &text_extents);
+    font_cache.show_text(cairo, message, text_x, text_y);
+
+    m_drawn = DrawnState{
+        .m_is_valid = true,
+        .m_message = message,
+        .m_rect = {text_x + text_extents.x_bearing, text_y + text_extents.y_bearing, text_extents.width, text_extents.height},
+    };
 }
 
 auto wall::CairoBarElement::draw_background(cairo_t* cairo, double width, double height) const -> void {
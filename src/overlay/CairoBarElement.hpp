@@ -1,8 +1,10 @@
 #pragma once
 
 #include <cairo.h>
+#include <utility>
 
 #include "conf/Config.hpp"
+#include "overlay/CairoDamage.hpp"
 #include "overlay/CairoFontCache.hpp"
 #include "overlay/Color.hpp"
 
@@ -25,7 +27,11 @@ class CairoBarElement {
 
     auto update_settings() -> void;
 
-    auto draw(cairo_t* cairo, double width, double height, const CairoFontCache& font_cache, const std::string& message) const -> void;
+    auto draw(cairo_t* cairo, double width, double height, const CairoFontCache& font_cache, const std::string& message) -> void;
+
+    // Adds the old and new text bounds if the next draw shows a different message than the last one
+    auto add_damage(CairoDamage* damage, double width, double height, const CairoFontCache& font_cache, const std::string& message) const
+        -> void;
 
     [[nodiscard]] auto get_position_size(int32_t width,
                                          int32_t height,
@@ -42,7 +48,11 @@ class CairoBarElement {
 
     [[nodiscard]] auto alignment_from_string(std::string_view str_orig) const -> BarAlignment;
 
-    auto draw_text(cairo_t* cairo, double width, double height, const CairoFontCache& font_cache, const std::string& message) const -> void;
+    auto draw_text(cairo_t* cairo, double width, double height, const CairoFontCache& font_cache, const std::string& message) -> void;
+
+    // Returns where to draw the message for it to be centered in the bar, and its extents
+    auto layout_text(double width, double height, const CairoFontCache& font_cache, const std::string& message, cairo_text_extents_t* text_extents)
+        const -> std::pair<double, double>;
 
     auto draw_background(cairo_t* cairo, double width, double height) const -> void;
 
@@ -65,5 +75,13 @@ class CairoBarElement {
     int32_t m_top_padding{};
     int32_t m_bottom_padding{};
     int32_t m_text_top_bottom_margin{};
+
+    struct DrawnState {
+        bool m_is_valid{false};
+        std::string m_message{};
+        cairo_rectangle_t m_rect{};
+    };
+
+    DrawnState m_drawn{};
 };
 }  // namespace wall
@@ -4,6 +4,7 @@
 #include <wayland-client-protocol.h>
 #include <wayland-client.h>
 #include "registry/Registry.hpp"
+#include "util/ClockUtils.hpp"
 #include "util/Formatter.hpp"
 #include "util/Log.hpp"
 #include "util/NetworkDiscover.hpp"
@@ -15,9 +16,10 @@ wall::CairoBarSurface::CairoBarSurface(const Config& config, Surface* surface, w
     set_state(State::Idle);
 }
 
-wall::CairoBarSurface::~CairoBarSurface() = default;
+wall::CairoBarSurface::~CairoBarSurface() { cancel_render(); }
 
 auto wall::CairoBarSurface::update_settings() -> void {
+    cancel_render();
     set_is_visible_on_idle(wall_conf_get(get_config(), lock_bar, visible_on_idle));
     set_idle_timeout(std::chrono::milliseconds(wall_conf_get(get_config(), lock_bar, idle_timeout_ms)));
     const auto monitor = wall_conf_get(get_config(), lock_bar, monitor);
@@ -26,6 +28,7 @@ auto wall::CairoBarSurface::update_settings() -> void {
     m_is_wallpaper_enabled = wall_conf_get(get_config(), wallpaper, bar_enabled);
     m_module_separator = wall_conf_get(get_config(), lock_bar, module_separator);
     m_is_module_draw_on_empty = wall_conf_get(get_config(), lock_bar, module_draw_on_empty);
+    m_clock_period = ClockUtils::get_format_period(wall_conf_get(get_config(), lock_bar, clock_format));
 
     m_is_primary_only = (monitor == "primary");
 
@@ -42,8 +45,9 @@ auto wall::CairoBarSurface::update_settings() -> void {
     m_last_state = StateCheck{};
 
     // set last activity to zero
-    set_last_activity_time(std::chrono::system_clock::time_point{});
+    set_last_activity_time(loop::Clock::time_point{});
     set_last_draw_time(std::chrono::system_clock::time_point{});
+    request_redraw();
 }
 
 auto wall::CairoBarSurface::generate_message() -> std::string {
@@ -92,29 +96,70 @@ auto wall::CairoBarSurface::should_draw() -> bool {
     return should_draw_frame_on_idle(get_surface()->get_wl_bar_surface(), get_surface()->get_wl_bar_subsurface());
 }
 
+auto wall::CairoBarSurface::get_time_to_redraw() const -> std::chrono::milliseconds {
+    auto time_to_redraw = std::chrono::milliseconds::zero();
+    const auto update = [&time_to_redraw](std::chrono::milliseconds time) {
+        if (time.count() > 0 && (time_to_redraw.count() == 0 || time < time_to_redraw)) {
+            time_to_redraw = time;
+        }
+    };
+
+    for (const auto mod : m_modules) {
+        switch (mod) {
+            case Module::Clock:
+                update(ClockUtils::get_time_to_next_tick(get_now(), m_clock_period));
+                break;
+            case Module::Battery:
+                update(m_battery_discover.get_time_to_update(get_now()));
+                break;
+            case Module::Network:
+                update(m_network_discover.get_time_to_update(get_now()));
+                break;
+            default:
+                // keyboard changes arrive as state changes
+                break;
+        }
+    }
+
+    return time_to_redraw;
+}
+
 auto wall::CairoBarSurface::draw_frame(int32_t width, int32_t height) -> std::chrono::milliseconds {
     if (!should_draw()) {
         return std::chrono::milliseconds::zero();
     }
 
     const auto message = generate_message();
+    const auto time_to_redraw = get_time_to_redraw();
     StateCheck current_state{width, height, get_state(), message};
     if (m_last_state == current_state) {
-        return std::chrono::milliseconds::zero();
+        return time_to_redraw;
     }
 
     const auto [buffer_width, buffer_height] = m_bar.get_buffer_size(width, height, get_font_cache(), message);
     const auto [subsurf_xpos, subsurf_ypos] = m_bar.get_position_size(width, height, buffer_width, buffer_height);
 
-    create_cairo_surface(buffer_width, buffer_height, get_pixel_width());
-    auto* cairo = get_cairo_state()->get_cairo();
-    m_bar.draw(cairo, buffer_width, buffer_height, get_font_cache(), message);
+    auto* damage = get_damage_mut();
+    if (m_last_state.m_width != width || m_last_state.m_height != height || m_last_state.m_state != get_state()) {
+        damage->add_full();
+    } else {
+        m_bar.add_damage(damage, buffer_width, buffer_height, get_font_cache(), message);
+    }
+
+    if (!create_cairo_surface(buffer_width, buffer_height, get_pixel_width())) {
+        return time_to_redraw;
+    }
 
-    update_surface(get_surface()->get_wl_bar_surface(), get_surface()->get_wl_bar_subsurface(), subsurf_xpos, subsurf_ypos,
-                   get_cairo_state()->get_buffer());
     set_last_draw_time(get_now());
     m_last_state = current_state;
 
-    // the fast redraw time is if the clock is formatted with seconds, so min redraw time is 1 second
-    return std::chrono::milliseconds{1000};
+    render_frame(
+        [this, buffer_width, buffer_height, message](cairo_t* cairo) {
+            m_bar.draw(cairo, buffer_width, buffer_height, get_font_cache(), message);
+        },
+        [this, subsurf_xpos, subsurf_ypos]() {
+            update_surface(get_surface()->get_wl_bar_surface(), get_surface()->get_wl_bar_subsurface(), subsurf_xpos, subsurf_ypos,
+                           get_cairo_state()->get_buffer());
+        });
+    return time_to_redraw;
 }
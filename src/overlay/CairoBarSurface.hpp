@@ -26,6 +26,9 @@ class CairoBarSurface : public CairoSurface {
 
     [[nodiscard]] auto should_draw() -> bool;
 
+    // Time until the first module changes on its own, zero if none of them does
+    [[nodiscard]] auto get_time_to_redraw() const -> std::chrono::milliseconds;
+
    private:
     struct StateCheck {
         int32_t m_width{};
@@ -61,5 +64,7 @@ class CairoBarSurface : public CairoSurface {
     std::string m_module_separator{};
 
     bool m_is_module_draw_on_empty{};
+
+    std::chrono::seconds m_clock_period{};
 };
 }  // namespace wall
@@ -0,0 +1,93 @@
+#include "overlay/CairoDamage.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+
+namespace {
+// antialiasing touches pixels slightly outside of the geometry
+constexpr auto k_antialias_margin = 2.0;
+}  // namespace
+
+auto wall::CairoDamage::add_full() -> void {
+    m_is_full = true;
+    m_rects.clear();
+}
+
+auto wall::CairoDamage::add_rect(double x_pos, double y_pos, double width, double height) -> void {
+    if (m_is_full || width <= 0.0 || height <= 0.0) {
+        return;
+    }
+
+    const auto x_start = static_cast<int32_t>(std::floor(x_pos - k_antialias_margin));
+    const auto y_start = static_cast<int32_t>(std::floor(y_pos - k_antialias_margin));
+    const auto x_end = static_cast<int32_t>(std::ceil(x_pos + width + k_antialias_margin));
+    const auto y_end = static_cast<int32_t>(std::ceil(y_pos + height + k_antialias_margin));
+    m_rects.push_back({x_start, y_start, x_end - x_start, y_end - y_start});
+}
+
+auto wall::CairoDamage::add_circle(double center_x, double center_y, double radius) -> void {
+    add_rect(center_x - radius, center_y - radius, radius * 2.0, radius * 2.0);
+}
+
+auto wall::CairoDamage::add_arc(double center_x, double center_y, double radius, double angle_start, double angle_end, double line_width)
+    -> void {
+    const auto half_width = line_width / 2.0;
+    if (angle_end - angle_start >= 2.0 * std::numbers::pi) {
+        add_circle(center_x, center_y, radius + half_width);
+        return;
+    }
+
+    auto min_x = center_x + (radius * std::cos(angle_start));
+    auto max_x = min_x;
+    auto min_y = center_y + (radius * std::sin(angle_start));
+    auto max_y = min_y;
+    const auto extend = [&](double angle) {
+        const auto x_pos = center_x + (radius * std::cos(angle));
+        const auto y_pos = center_y + (radius * std::sin(angle));
+        min_x = std::min(min_x, x_pos);
+        max_x = std::max(max_x, x_pos);
+        min_y = std::min(min_y, y_pos);
+        max_y = std::max(max_y, y_pos);
+    };
+
+    extend(angle_end);
+
+    // the arc reaches its extremes where it crosses the axes
+    const auto quarter = std::numbers::pi / 2.0;
+    for (auto angle = std::ceil(angle_start / quarter) * quarter; angle < angle_end; angle += quarter) {
+        extend(angle);
+    }
+
+    add_rect(min_x - half_width, min_y - half_width, (max_x - min_x) + line_width, (max_y - min_y) + line_width);
+}
+
+auto wall::CairoDamage::add_line(double x_start, double y_start, double x_end, double y_end, double line_width) -> void {
+    const auto half_width = line_width / 2.0;
+    const auto min_x = std::min(x_start, x_end);
+    const auto min_y = std::min(y_start, y_end);
+    add_rect(min_x - half_width, min_y - half_width, std::abs(x_end - x_start) + line_width, std::abs(y_end - y_start) + line_width);
+}
+
+auto wall::CairoDamage::add(const CairoDamage& other) -> void {
+    if (other.m_is_full) {
+        add_full();
+        return;
+    }
+
+    if (!m_is_full) {
+        m_rects.insert(m_rects.end(), other.m_rects.begin(), other.m_rects.end());
+    }
+}
+
+auto wall::CairoDamage::clear() -> void {
+    m_is_full = false;
+    m_rects.clear();
+}
+
+auto wall::CairoDamage::is_full() const -> bool { return m_is_full; }
+
+auto wall::CairoDamage::is_empty() const -> bool { return !m_is_full && m_rects.empty(); }
+
+auto wall::CairoDamage::get_rects() const -> const std::vector<cairo_rectangle_int_t>& { return m_rects; }
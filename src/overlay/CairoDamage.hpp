@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cairo.h>
+#include <vector>
+
+namespace wall {
+
+// Buffer areas that change in the next frame. Overlay elements add the bounds of whatever they will draw differently than in the
+// frame before, the surface then only clears, repaints and damages those areas.
+class CairoDamage {
+   public:
+    // The whole buffer changes
+    auto add_full() -> void;
+
+    auto add_rect(double x_pos, double y_pos, double width, double height) -> void;
+
+    auto add_circle(double center_x, double center_y, double radius) -> void;
+
+    // Bounds of an arc stroked with the given line width, angles are in radians like cairo_arc
+    auto add_arc(double center_x, double center_y, double radius, double angle_start, double angle_end, double line_width) -> void;
+
+    auto add_line(double x_start, double y_start, double x_end, double y_end, double line_width) -> void;
+
+    auto add(const CairoDamage& other) -> void;
+
+    auto clear() -> void;
+
+    [[nodiscard]] auto is_full() const -> bool;
+
+    [[nodiscard]] auto is_empty() const -> bool;
+
+    [[nodiscard]] auto get_rects() const -> const std::vector<cairo_rectangle_int_t>&;
+
+   private:
+    bool m_is_full{false};
+
+    std::vector<cairo_rectangle_int_t> m_rects;
+};
+}  // namespace wall
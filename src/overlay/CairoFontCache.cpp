@@ -1,7 +1,5 @@
 #include "overlay/CairoFontCache.hpp"
 
-#include <cairo-ft.h>
-#include <fontconfig/fontconfig.h>
 #include <spdlog/common.h>
 
 #include "util/Log.hpp"
@@ -10,17 +8,21 @@ namespace wall {
 class Config;
 }  // namespace wall
 
-wall::CairoFontCache::CairoFontCache(const Config& config, cairo_subpixel_order_t subpixel) : m_config{config}, m_subpixel{subpixel} {
+wall::CairoFontCache::CairoFontCache(const Config& config, FontRegistry* font_registry, cairo_subpixel_order_t subpixel)
+    : m_config{config}, m_font_registry{font_registry}, m_subpixel{subpixel} {
     auto* text_test_surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, 1, 1);
     auto* text_test_cairo = cairo_create(text_test_surface);
     cairo_set_antialias(text_test_cairo, CAIRO_ANTIALIAS_BEST);
     m_font_cairo_state = std::make_unique<CairoState>(1, 1, 1, text_test_cairo, text_test_surface, nullptr);
+    update_scaled_font();
 }
 
 wall::CairoFontCache::~CairoFontCache() {
-    if (m_font_face != nullptr) {
-        cairo_font_face_destroy(m_font_face);
+    if (m_scaled_font != nullptr) {
+        cairo_scaled_font_destroy(m_scaled_font);
     }
+
+    m_font_registry->release_font_face(m_font_face);
 }
 
 auto wall::CairoFontCache::get_font_face() const -> cairo_font_face_t* { return m_font_face; }
@@ -31,6 +33,70 @@ auto wall::CairoFontCache::get_font_size() const -> double { return m_font_size;
 
 auto wall::CairoFontCache::get_font_cairo_state() const -> CairoState* { return m_font_cairo_state.get(); }
 
+auto wall::CairoFontCache::get_font_extents() const -> const cairo_font_extents_t& { return m_font_extents; }
+
+auto wall::CairoFontCache::get_text_extents(const std::string& text) const -> const cairo_text_extents_t& {
+    return get_text_layout(text).m_extents;
+}
+
+auto wall::CairoFontCache::show_text(cairo_t* cairo, const std::string& text, double x_pos, double y_pos) const -> void {
+    const auto& layout = get_text_layout(text);
+    if (layout.m_glyphs.empty()) {
+        return;
+    }
+
+    // the glyph indices only depend on the font face, the target keeps its own font options
+    cairo_set_font_face(cairo, get_font_face());
+    cairo_set_font_size(cairo, get_font_size());
+
+    cairo_save(cairo);
+    cairo_translate(cairo, x_pos, y_pos);
+    cairo_show_glyphs(cairo, layout.m_glyphs.data(), static_cast<int>(layout.m_glyphs.size()));
+    cairo_restore(cairo);
+}
+
+auto wall::CairoFontCache::get_text_layout_count() const -> size_t { return m_text_layouts.size(); }
+
+auto wall::CairoFontCache::get_text_layout(const std::string& text) const -> const TextLayout& {
+    if (auto find_result = m_text_layout_index.find(text); find_result != m_text_layout_index.end()) {
+        m_text_layouts.splice(m_text_layouts.begin(), m_text_layouts, find_result->second);
+        return find_result->second->second;
+    }
+
+    TextLayout layout{};
+    cairo_glyph_t* glyphs = nullptr;
+    auto glyph_count = 0;
+    if (cairo_scaled_font_text_to_glyphs(m_scaled_font, 0.0, 0.0, text.c_str(), static_cast<int>(text.size()), &glyphs, &glyph_count,
+                                         nullptr, nullptr, nullptr) == CAIRO_STATUS_SUCCESS) {
+        layout.m_glyphs.assign(glyphs, glyphs + glyph_count);
+        cairo_scaled_font_glyph_extents(m_scaled_font, glyphs, glyph_count, &layout.m_extents);
+    } else {
+        LOG_DEBUG("Failed to convert text to glyphs: {}", text);
+    }
+    cairo_glyph_free(glyphs);
+
+    if (m_text_layouts.size() >= k_max_text_layouts) {
+        m_text_layout_index.erase(m_text_layouts.back().first);
+        m_text_layouts.pop_back();
+    }
+
+    m_text_layouts.emplace_front(text, std::move(layout));
+    m_text_layout_index[text] = m_text_layouts.begin();
+    return m_text_layouts.front().second;
+}
+
+auto wall::CairoFontCache::update_scaled_font() -> void {
+    m_text_layouts.clear();
+    m_text_layout_index.clear();
+
+    if (m_scaled_font != nullptr) {
+        cairo_scaled_font_destroy(m_scaled_font);
+    }
+
+    m_scaled_font = cairo_scaled_font_reference(cairo_get_scaled_font(m_font_cairo_state->get_cairo()));
+    cairo_scaled_font_extents(m_scaled_font, &m_font_extents);
+}
+
 auto wall::CairoFontCache::load_font(std::string_view font, double font_size) -> void {
     if (m_font_face != nullptr && m_loaded_font_face == font && m_font_size == font_size) {
         return;
@@ -39,18 +105,15 @@ auto wall::CairoFontCache::load_font(std::string_view font, double font_size) ->
     m_font_family = font;
     m_font_size = font_size;
 
-    // destroy the old font face
-    if (m_font_face != nullptr) {
-        cairo_font_face_destroy(m_font_face);
-        m_font_face = nullptr;
-    }
-
-    auto* font_face = load_font_face(font);
+    auto* font_face = m_font_registry->acquire_font_face(font);
     configure_font_options(m_font_cairo_state->get_cairo(), font_face, font_size);
 
+    // give back the old font face
+    m_font_registry->release_font_face(m_font_face);
     m_font_face = font_face;
     m_loaded_font_face = font;
     m_font_size = font_size;
+    update_scaled_font();
 }
 
 auto wall::CairoFontCache::configure_font_options(cairo_t* cairo, cairo_font_face_t* font_face, double font_size) const -> void {
@@ -64,68 +127,3 @@ auto wall::CairoFontCache::configure_font_options(cairo_t* cairo, cairo_font_fac
     cairo_set_font_size(cairo, font_size);
     cairo_font_options_destroy(font_options);
 }
-
-/*
- * This is taken from i3lock and modified to fit our needs.
- *
- * Returns the cairo_font_face_t for sans-serif
- * if this thing returns NULL, then we're somehow on a system without a
- * sans-serif font, or a system without fontconfig (but with cairo somehow)
- * Reference counts and caches the font-face, so we don't have memory leaks
- * (and so that we don't have to go through all the parsing each time)
- */
-auto wall::CairoFontCache::load_font_face(std::string_view font) const -> cairo_font_face_t* {
-    FcResult result;
-
-    /*
-     * Loads the default config.
-     * On successive calls, does no work and just returns true.
-     */
-    if (FcInit() == FcFalse) {
-        LOG_DEBUG("Fontconfig init failed. No text will be shown.");
-        return nullptr;
-    }
-
-    /*
-     * converts a font face name to a pattern for that face name
-     */
-    auto* pattern = FcNameParse((const unsigned char*)font.data());
-    if (pattern == nullptr) {
-        LOG_DEBUG("no sans-serif font available");
-        return nullptr;
-    }
-
-    /*
-     * Gets the default font for our pattern. (Gets the default sans-serif font face)
-     * Without these two calls, the FcFontMatch call will fail due to FcConfigGetCurrent()
-     * not giving it a valid/useful config.
-     */
-    FcDefaultSubstitute(pattern);
-    if (FcConfigSubstitute(FcConfigGetCurrent(), pattern, FcMatchPattern) == FcFalse) {
-        LOG_DEBUG("config sub failed?");
-        return nullptr;
-    }
-
-    /*
-     * Looks up the font pattern and does some internal RenderPrepare work,
-     * then returns the resulting pattern that's ready for rendering.
-     */
-    auto* pattern_ready = FcFontMatch(FcConfigGetCurrent(), pattern, &result);
-
-    FcPatternDestroy(pattern);
-    pattern = nullptr;
-    if (pattern_ready == nullptr) {
-        LOG_DEBUG("no sans-serif font available\n");
-        return nullptr;
-    }
-
-    /*
-     * Passes the given pattern into cairo, which loads it into a cairo freetype font face.
-     * Increment its reference count and cache it.
-     */
-    auto* face = cairo_ft_font_face_create_for_pattern(pattern_ready);
-    FcPatternDestroy(pattern_ready);
-    FcFini();
-
-    return face;
-}
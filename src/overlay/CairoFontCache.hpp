@@ -1,17 +1,27 @@
 #pragma once
 
 #include <cairo.h>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "conf/Config.hpp"
 #include "overlay/CairoState.hpp"
+#include "registry/FontRegistry.hpp"
 
 namespace wall
 
 {
 class CairoFontCache {
    public:
-    CairoFontCache(const Config& config, cairo_subpixel_order_t subpixel);
+    CairoFontCache(const Config& config, FontRegistry* font_registry, cairo_subpixel_order_t subpixel);
     ~CairoFontCache();
 
+    CairoFontCache(CairoFontCache&&) = delete;
+    CairoFontCache(const CairoFontCache&) = delete;
+    auto operator=(const CairoFontCache&) -> CairoFontCache = delete;
+    auto operator=(CairoFontCache&&) -> CairoFontCache = delete;
+
     auto load_font(std::string_view font, double font_size) -> void;
 
     [[nodiscard]] auto get_font_face() const -> cairo_font_face_t*;
@@ -22,16 +32,38 @@ class CairoFontCache {
 
     [[nodiscard]] auto get_font_cairo_state() const -> CairoState*;
 
+    [[nodiscard]] auto get_font_extents() const -> const cairo_font_extents_t&;
+
+    [[nodiscard]] auto get_text_extents(const std::string& text) const -> const cairo_text_extents_t&;
+
+    // Shows the text with its baseline starting at the given position, like cairo_move_to followed by cairo_show_text
+    auto show_text(cairo_t* cairo, const std::string& text, double x_pos, double y_pos) const -> void;
+
+    [[nodiscard]] auto get_text_layout_count() const -> size_t;
+
    protected:
     [[nodiscard]] auto get_config() const -> const Config&;
 
-    [[nodiscard]] auto load_font_face(std::string_view font) const -> cairo_font_face_t*;
-
     auto configure_font_options(cairo_t* cairo, cairo_font_face_t* font_face, double font_size) const -> void;
 
+    // Takes the scaled font of the measuring cairo and drops the text layouts made with the previous one
+    auto update_scaled_font() -> void;
+
+    struct TextLayout {
+        // Positioned relative to the start of the baseline
+        std::vector<cairo_glyph_t> m_glyphs;
+
+        cairo_text_extents_t m_extents{};
+    };
+
+    // Converts the text to glyphs once, later calls with the same text are served from a small LRU
+    [[nodiscard]] auto get_text_layout(const std::string& text) const -> const TextLayout&;
+
    private:
     const Config& m_config;
 
+    FontRegistry* m_font_registry{};
+
     cairo_subpixel_order_t m_subpixel;
 
     std::unique_ptr<CairoState> m_font_cairo_state{};
@@ -43,5 +75,18 @@ class CairoFontCache {
     std::string m_font_family{};
 
     double m_font_size{};
+
+    cairo_scaled_font_t* m_scaled_font{};
+
+    cairo_font_extents_t m_font_extents{};
+
+    // Layouts are only valid for the current scaled font, they are cleared whenever the font changes. The overlay only shows a few
+    // strings, e.g. the clock, the state message and the bar, so only the latest ones are kept.
+    static constexpr size_t k_max_text_layouts = 16;
+
+    // Lookups happen while measuring and drawing through const references, the cache is not part of the observable state
+    mutable std::list<std::pair<std::string, TextLayout>> m_text_layouts;
+
+    mutable std::unordered_map<std::string, std::list<std::pair<std::string, TextLayout>>::iterator> m_text_layout_index;
 };
 }  // namespace wall
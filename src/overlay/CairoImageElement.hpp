@@ -1,39 +1,47 @@
 #pragma once
 
 #include <cairo/cairo.h>
-#include <gdk-pixbuf/gdk-pixbuf-core.h>
-#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <cstdint>
 #include <filesystem>
 #include "conf/Config.hpp"
+#include "registry/ImageRegistry.hpp"
 
 namespace wall {
 class CairoImageElement {
    public:
-    explicit CairoImageElement(const Config& config);
+    CairoImageElement(const Config& config, ImageRegistry* image_registry);
 
     virtual ~CairoImageElement();
 
-    auto draw(cairo_t* cairo, double center_x, double center_y, double radius) const -> void;
+    CairoImageElement(CairoImageElement&&) = delete;
+    CairoImageElement(const CairoImageElement&) = delete;
+    auto operator=(const CairoImageElement&) -> CairoImageElement = delete;
+    auto operator=(CairoImageElement&&) -> CairoImageElement = delete;
+
+    // Fills the circle with the image. It is scaled once for the circle's size in pixels and then copied without any filtering.
+    auto draw(cairo_t* cairo, double center_x, double center_y, double radius) -> void;
 
     auto update_settings() -> void;
 
    protected:
-    auto premultiply_alpha(const guint8* gdkpix, cairo_surface_t* cairo_surface, int width, int height, int stride) const -> void;
-
     [[nodiscard]] auto get_config() const -> const Config&;
 
-    [[nodiscard]] auto load_image(const std::filesystem::path& file_path) const -> cairo_surface_t*;
+    // Swaps the image for one with the given size, does nothing if the current one already has it
+    auto update_image(int32_t diameter, double scale) -> void;
 
-    [[nodiscard]] auto buffer_to_surface(GdkPixbuf* gdkbuf) const -> cairo_surface_t*;
+    auto release_image() -> void;
 
    private:
     const Config& m_config;
 
+    ImageRegistry* m_image_registry{};
+
     std::filesystem::path m_image_path;
 
     cairo_surface_t* m_image{};
 
-    double m_image_width{};
-    double m_image_height{};
+    // Size the image was requested for, also set if it could not be loaded so it is not tried again on every draw
+    int32_t m_image_diameter{};
+    double m_image_scale{};
 };
 }  // namespace wall
@@ -1,5 +1,7 @@
 #include "overlay/CairoIndicatorElement.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <numbers>
 
@@ -10,7 +12,12 @@ namespace wall {
 class Config;
 }  // namespace wall
 
-wall::CairoIndicatorElement::CairoIndicatorElement(const Config& config) : m_config{config}, m_image{config} { update_settings(); }
+wall::CairoIndicatorElement::CairoIndicatorElement(const Config& config, ImageRegistry* image_registry)
+    : m_config{config}, m_image{config, image_registry} {
+    update_settings();
+}
+
+wall::CairoIndicatorElement::~CairoIndicatorElement() { clear_layers(); }
 
 auto wall::CairoIndicatorElement::update_settings() -> void {
     m_is_ring_enabled = wall_conf_get(get_config(), lock_indicator, ring_enabled);
@@ -46,6 +53,9 @@ auto wall::CairoIndicatorElement::update_settings() -> void {
     m_ring_highlight_border_color = wall_conf_get_with_fallback(get_config(), lock_indicator, ring_highlight_border_color, border, color);
 
     m_image.update_settings();
+    m_drawn = DrawnState{};
+    clear_layers();
+    m_layers.m_bounds.reset();
 }
 
 auto wall::CairoIndicatorElement::get_radius() const -> double { return m_ring_radius; }
@@ -92,14 +102,106 @@ auto wall::CairoIndicatorElement::on_state_change(State state) -> void {
 
 auto wall::CairoIndicatorElement::update_highlight_arc_start() -> void { m_ring_highlight_start = ((rand() % 1024) + 512) % 2048; }
 
-auto wall::CairoIndicatorElement::draw(cairo_t* cairo, double center_x, double center_y) -> std::chrono::milliseconds {
-    draw_inner_circle(cairo, center_x, center_y);
-    m_image.draw(cairo, center_x, center_y, get_radius());
-    draw_outer_ring(cairo, center_x, center_y);
+auto wall::CairoIndicatorElement::draw(cairo_t* cairo, double center_x, double center_y) -> void {
+    update_layer_bounds(center_x, center_y);
+
+    const auto& bounds = m_layers.m_bounds;
+    cairo_set_source_surface(cairo, get_base_layer(cairo, center_x, center_y), bounds.get_x_pos(), bounds.get_y_pos());
+    cairo_rectangle(cairo, bounds.get_x_pos(), bounds.get_y_pos(), bounds.get_size(), bounds.get_size());
+    cairo_fill(cairo);
+
     draw_highlight(cairo, center_x, center_y);
-    draw_borders(cairo, center_x, center_y);
 
-    return std::chrono::milliseconds::zero();
+    Color::set_cairo_color(cairo, m_ring_border_color.get(m_state));
+    cairo_mask_surface(cairo, get_border_layer(cairo, center_x, center_y), bounds.get_x_pos(), bounds.get_y_pos());
+
+    m_drawn = DrawnState{
+        .m_is_valid = true,
+        .m_state = m_state,
+        .m_is_draw_ring_highlight = m_is_draw_ring_highlight,
+        .m_highlight_state = m_highlight_state,
+        .m_ring_highlight_start = m_ring_highlight_start,
+    };
+}
+
+auto wall::CairoIndicatorElement::add_damage(CairoDamage* damage, double center_x, double center_y) const -> void {
+    if (!m_drawn.m_is_valid || !is_same_colors(m_drawn.m_state, m_state)) {
+        const auto border_width = std::max(m_ring_border_width, m_ring_inner_border_width);
+        damage->add_circle(center_x, center_y, get_radius() + (get_thickness() / 2.0) + border_width);
+        return;
+    }
+
+    if (m_drawn.m_is_draw_ring_highlight == m_is_draw_ring_highlight && m_drawn.m_highlight_state == m_highlight_state &&
+        m_drawn.m_ring_highlight_start == m_ring_highlight_start) {
+        return;
+    }
+
+    // typing only moves the highlight, repaint where it was and where it will be
+    if (m_drawn.m_is_draw_ring_highlight) {
+        add_highlight_damage(damage, center_x, center_y, m_drawn.m_ring_highlight_start);
+    }
+
+    if (m_is_draw_ring_highlight) {
+        add_highlight_damage(damage, center_x, center_y, m_ring_highlight_start);
+    }
+}
+
+auto wall::CairoIndicatorElement::add_highlight_damage(CairoDamage* damage, double center_x, double center_y, double highlight_start) const
+    -> void {
+    const auto arc_start = highlight_start * (std::numbers::pi / 1024.0);
+    const auto arc_end = arc_start + m_ring_highlight_arc + m_ring_highlight_arc_border_thickness;
+    damage->add_arc(center_x, center_y, get_radius(), arc_start, arc_end, get_thickness());
+}
+
+auto wall::CairoIndicatorElement::is_same_colors(State state, State other_state) const -> bool {
+    return m_ring_inner_fill_color.get(state) == m_ring_inner_fill_color.get(other_state) &&
+           m_ring_fill_color.get(state) == m_ring_fill_color.get(other_state) &&
+           m_ring_border_color.get(state) == m_ring_border_color.get(other_state);
+}
+
+auto wall::CairoIndicatorElement::get_base_layer(cairo_t* cairo, double center_x, double center_y) -> cairo_surface_t* {
+    auto& layer = m_layers.m_base.at(ColorSet::get_index(m_state));
+    if (layer != nullptr) {
+        return layer;
+    }
+
+    auto* layer_cairo = m_layers.m_bounds.create_cairo(cairo, CAIRO_FORMAT_ARGB32);
+    draw_inner_circle(layer_cairo, center_x, center_y);
+    m_image.draw(layer_cairo, center_x, center_y, get_radius());
+    draw_outer_ring(layer_cairo, center_x, center_y);
+
+    layer = cairo_surface_reference(cairo_get_target(layer_cairo));
+    cairo_destroy(layer_cairo);
+    return layer;
+}
+
+auto wall::CairoIndicatorElement::get_border_layer(cairo_t* cairo, double center_x, double center_y) -> cairo_surface_t* {
+    if (m_layers.m_borders != nullptr) {
+        return m_layers.m_borders;
+    }
+
+    // overlapping borders add up to the same coverage as stroking them one after another in the same color
+    auto* layer_cairo = m_layers.m_bounds.create_mask_cairo(cairo);
+    draw_borders(layer_cairo, center_x, center_y);
+
+    m_layers.m_borders = cairo_surface_reference(cairo_get_target(layer_cairo));
+    cairo_destroy(layer_cairo);
+    return m_layers.m_borders;
+}
+
+auto wall::CairoIndicatorElement::update_layer_bounds(double center_x, double center_y) -> void {
+    const auto border_width = std::max(m_ring_border_width, m_ring_inner_border_width);
+    const auto extent = get_radius() + (get_thickness() / 2.0) + (border_width / 2.0);
+    if (m_layers.m_bounds.update(center_x, center_y, extent)) {
+        clear_layers();
+    }
+}
+
+auto wall::CairoIndicatorElement::clear_layers() -> void {
+    for (auto*& layer : m_layers.m_base) {
+        CairoLayerBounds::destroy_surfaces({&layer});
+    }
+    CairoLayerBounds::destroy_surfaces({&m_layers.m_borders});
 }
 
 auto wall::CairoIndicatorElement::draw_inner_circle(cairo_t* cairo, double center_x, double center_y) -> void {
@@ -127,13 +229,11 @@ auto wall::CairoIndicatorElement::draw_outer_ring(cairo_t* cairo, double center_
 
 auto wall::CairoIndicatorElement::draw_borders(cairo_t* cairo, double center_x, double center_y) -> void {
     // draw outer border
-    Color::set_cairo_color(cairo, m_ring_border_color.get(m_state));
     cairo_set_line_width(cairo, m_ring_border_width);
     cairo_arc(cairo, center_x, center_y, get_radius() + get_thickness() / 2.0, 0, 2.0 * std::numbers::pi);
     cairo_stroke(cairo);
 
     // draw inner border
-    Color::set_cairo_color(cairo, m_ring_border_color.get(m_state));
     cairo_set_line_width(cairo, m_ring_inner_border_width);
     cairo_arc(cairo, center_x, center_y, get_radius() - (get_thickness() / 2.0), 0, 2.0 * std::numbers::pi);
     cairo_stroke(cairo);
@@ -1,20 +1,31 @@
 #pragma once
 
 #include <cairo.h>
+#include <array>
 #include "conf/Config.hpp"
+#include "overlay/CairoDamage.hpp"
 #include "overlay/CairoImageElement.hpp"
+#include "overlay/CairoLayerBounds.hpp"
 #include "overlay/Color.hpp"
 #include "overlay/ColorSet.hpp"
 
 namespace wall {
 class CairoIndicatorElement {
    public:
-    CairoIndicatorElement(const Config& config);
-    ~CairoIndicatorElement() = default;
+    CairoIndicatorElement(const Config& config, ImageRegistry* image_registry);
+    ~CairoIndicatorElement();
+
+    CairoIndicatorElement(CairoIndicatorElement&&) = delete;
+    CairoIndicatorElement(const CairoIndicatorElement&) = delete;
+    auto operator=(const CairoIndicatorElement&) -> CairoIndicatorElement = delete;
+    auto operator=(CairoIndicatorElement&&) -> CairoIndicatorElement = delete;
 
     auto update_settings() -> void;
 
-    auto draw(cairo_t* cairo, double center_x, double center_y) -> std::chrono::milliseconds;
+    auto draw(cairo_t* cairo, double center_x, double center_y) -> void;
+
+    // Adds what the next draw changes compared to the last one
+    auto add_damage(CairoDamage* damage, double center_x, double center_y) const -> void;
 
     [[nodiscard]] auto get_highlight_start() const -> double;
 
@@ -31,12 +42,28 @@ class CairoIndicatorElement {
 
     auto draw_outer_ring(cairo_t* cairo, double center_x, double center_y) -> void;
 
+    // Only strokes the borders, the source is set by the caller
     auto draw_borders(cairo_t* cairo, double center_x, double center_y) -> void;
 
     auto draw_highlight(cairo_t* cairo, double center_x, double center_y) -> void;
 
     auto update_highlight_arc_start() -> void;
 
+    auto add_highlight_damage(CairoDamage* damage, double center_x, double center_y, double highlight_start) const -> void;
+
+    [[nodiscard]] auto is_same_colors(State state, State other_state) const -> bool;
+
+    // Inner circle, image and ring for the current state's colors, rendered on first use
+    [[nodiscard]] auto get_base_layer(cairo_t* cairo, double center_x, double center_y) -> cairo_surface_t*;
+
+    // Coverage of the borders, painted through with the current state's border color
+    [[nodiscard]] auto get_border_layer(cairo_t* cairo, double center_x, double center_y) -> cairo_surface_t*;
+
+    // Drops the layers if they were rendered for another position, the layers cover the ring and its borders around the center
+    auto update_layer_bounds(double center_x, double center_y) -> void;
+
+    auto clear_layers() -> void;
+
    private:
     const Config& m_config;
 
@@ -67,5 +94,27 @@ class CairoIndicatorElement {
     CairoImageElement m_image;
 
     State m_state{State::None};
+
+    // What was shown by the last draw
+    struct DrawnState {
+        bool m_is_valid{false};
+        State m_state{State::None};
+        bool m_is_draw_ring_highlight{};
+        State m_highlight_state{State::None};
+        double m_ring_highlight_start{};
+    };
+
+    DrawnState m_drawn{};
+
+    // Parts of the indicator that only change with the state's colors. Only the highlight moves while typing, so everything else is
+    // rendered once and composited each frame.
+    struct Layers {
+        CairoLayerBounds m_bounds{};
+
+        std::array<cairo_surface_t*, ColorSet::k_size> m_base{};
+        cairo_surface_t* m_borders{};
+    };
+
+    Layers m_layers{};
 };
 }  // namespace wall
@@ -1,5 +1,6 @@
 #include "overlay/CairoIndicatorMessage.hpp"
 #include <chrono>
+#include "util/ClockUtils.hpp"
 #include "util/Formatter.hpp"
 
 wall::CairoIndicatorMessage::CairoIndicatorMessage(const Config& config) : m_config{config} { update_settings(); }
@@ -10,6 +11,7 @@ auto wall::CairoIndicatorMessage::get_message() const -> const std::string& { re
 
 auto wall::CairoIndicatorMessage::update_settings() -> void {
     m_is_clock_enabled = wall_conf_get(get_config(), lock_indicator, clock_enabled);
+    m_clock_period = ClockUtils::get_format_period(wall_conf_get(get_config(), lock_indicator, clock_format));
     m_message_input = wall_conf_get(get_config(), lock_indicator, message_input);
     m_message_cleared = wall_conf_get(get_config(), lock_indicator, message_cleared);
     m_message_caps_lock = wall_conf_get(get_config(), lock_indicator, message_caps_lock);
@@ -33,6 +35,7 @@ auto wall::CairoIndicatorMessage::update_settings() -> void {
     m_font_color.m_caps_lock = wall_conf_get_with_fallback(get_config(), lock_indicator, font_color_caps_lock, font, color);
     m_font_color.m_verifying = wall_conf_get(get_config(), lock_indicator, font_color_verifying);
     m_font_color.m_wrong = wall_conf_get(get_config(), lock_indicator, font_color_wrong);
+    m_drawn = DrawnState{};
 }
 
 auto wall::CairoIndicatorMessage::update_message(State state, std::chrono::time_point<std::chrono::system_clock> now) -> void {
@@ -45,6 +48,15 @@ auto wall::CairoIndicatorMessage::update_message(State state, std::chrono::time_
     }
 }
 
+auto wall::CairoIndicatorMessage::get_time_to_redraw(State state, std::chrono::time_point<std::chrono::system_clock> now) const
+    -> std::chrono::milliseconds {
+    if (!m_is_clock_enabled || !get_message_format(state).empty()) {
+        return std::chrono::milliseconds::zero();
+    }
+
+    return ClockUtils::get_time_to_next_tick(now, m_clock_period);
+}
+
 auto wall::CairoIndicatorMessage::get_message_format(State state) const -> const std::string& {
     switch (state) {
         case State::Input:
@@ -62,41 +74,56 @@ auto wall::CairoIndicatorMessage::get_message_format(State state) const -> const
     }
 }
 
-auto wall::CairoIndicatorMessage::draw(cairo_t* cairo, State state, const CairoFontCache& font_cache, double x_pos, double y_pos)
-    -> std::chrono::milliseconds {
+auto wall::CairoIndicatorMessage::draw(cairo_t* cairo, State state, const CairoFontCache& font_cache, double x_pos, double y_pos) -> void {
     if (m_message.empty()) {
-        return std::chrono::milliseconds::zero();
+        m_drawn = DrawnState{};
+        return;
     }
 
-    cairo_set_font_face(cairo, font_cache.get_font_face());
-    cairo_set_font_size(cairo, font_cache.get_font_size());
-
     Color::set_cairo_color(cairo, m_font_color.get(state));
 
     cairo_text_extents_t text_extents;
-    cairo_font_extents_t font_extents;
-    cairo_text_extents(cairo, m_message.c_str(), &text_extents);
-    cairo_font_extents(cairo, &font_extents);
-    auto text_x = x_pos - (text_extents.width / 2.0) + text_extents.x_bearing;
-    auto text_y = y_pos + (font_extents.height / 2.0) - font_extents.descent;
-    cairo_move_to(cairo, text_x, text_y);
-    cairo_show_text(cairo, m_message.c_str());
-
-    return m_is_clock_enabled ? std::chrono::milliseconds{1000} : std::chrono::milliseconds::zero();
+    const auto [text_x, text_y] = layout_text(font_cache, x_pos, y_pos, &text_extents);
+    font_cache.show_text(cairo, m_message, text_x, text_y);
+
+    m_drawn = DrawnState{
+        .m_is_valid = true,
+        .m_message = m_message,
+        .m_color = m_font_color.get(state),
+        .m_rect = {text_x + text_extents.x_bearing, text_y + text_extents.y_bearing, text_extents.width, text_extents.height},
+    };
 }
 
-auto wall::CairoIndicatorMessage::get_text_width(const CairoFontCache& font_cache) const -> double {
-    auto* cairo = font_cache.get_font_cairo_state()->get_cairo();
-    cairo_set_antialias(cairo, CAIRO_ANTIALIAS_BEST);
+auto wall::CairoIndicatorMessage::add_damage(CairoDamage* damage, State state, const CairoFontCache& font_cache, double x_pos, double y_pos) const
+    -> void {
+    if (m_drawn.m_is_valid && m_drawn.m_message == m_message && m_drawn.m_color == m_font_color.get(state)) {
+        return;
+    }
 
-    cairo_set_font_face(cairo, font_cache.get_font_face());
-    cairo_set_font_size(cairo, font_cache.get_font_size());
+    if (m_drawn.m_is_valid) {
+        damage->add_rect(m_drawn.m_rect.x, m_drawn.m_rect.y, m_drawn.m_rect.width, m_drawn.m_rect.height);
+    }
 
     if (!m_message.empty()) {
         cairo_text_extents_t text_extents;
+        const auto [text_x, text_y] = layout_text(font_cache, x_pos, y_pos, &text_extents);
+        damage->add_rect(text_x + text_extents.x_bearing, text_y + text_extents.y_bearing, text_extents.width, text_extents.height);
+    }
+}
+
+auto wall::CairoIndicatorMessage::layout_text(const CairoFontCache& font_cache, double x_pos, double y_pos, cairo_text_extents_t* text_extents) const
+    -> std::pair<double, double> {
+    *text_extents = font_cache.get_text_extents(m_message);
+    const auto& font_extents = font_cache.get_font_extents();
+    const auto text_x = x_pos - (text_extents->width / 2.0) + text_extents->x_bearing;
+    const auto text_y = y_pos + (font_extents.height / 2.0) - font_extents.descent;
 
-        cairo_text_extents(cairo, m_message.c_str(), &text_extents);
-        return text_extents.width;
+    return {text_x, text_y};
+}
+
+auto wall::CairoIndicatorMessage::get_text_width(const CairoFontCache& font_cache) const -> double {
+    if (!m_message.empty()) {
+        return font_cache.get_text_extents(m_message).width;
     }
 
     return 0.0;
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <cairo.h>
+#include <utility>
 #include "State.hpp"
 #include "conf/Config.hpp"
+#include "overlay/CairoDamage.hpp"
 #include "overlay/CairoFontCache.hpp"
 #include "overlay/ColorSet.hpp"
 
@@ -18,7 +20,13 @@ class CairoIndicatorMessage {
 
     [[nodiscard]] auto get_text_width(const CairoFontCache& font_cache) const -> double;
 
-    auto draw(cairo_t* cairo, State state, const CairoFontCache& font_cache, double x_pos, double y_pos) -> std::chrono::milliseconds;
+    auto draw(cairo_t* cairo, State state, const CairoFontCache& font_cache, double x_pos, double y_pos) -> void;
+
+    // Time until the clock shown in the given state ticks, zero if the state shows a message instead
+    [[nodiscard]] auto get_time_to_redraw(State state, std::chrono::time_point<std::chrono::system_clock> now) const -> std::chrono::milliseconds;
+
+    // Adds the old and new text bounds if the next draw shows a different text or color than the last one
+    auto add_damage(CairoDamage* damage, State state, const CairoFontCache& font_cache, double x_pos, double y_pos) const -> void;
 
     [[nodiscard]] auto get_message() const -> const std::string&;
 
@@ -27,11 +35,17 @@ class CairoIndicatorMessage {
 
     [[nodiscard]] auto get_message_format(State state) const -> const std::string&;
 
+    // Returns where to draw the message for it to be centered on the given position, and its extents
+    auto layout_text(const CairoFontCache& font_cache, double x_pos, double y_pos, cairo_text_extents_t* text_extents) const
+        -> std::pair<double, double>;
+
    private:
     const Config& m_config;
 
     bool m_is_clock_enabled{};
 
+    std::chrono::seconds m_clock_period{};
+
     std::string m_message{};
     std::string m_message_input{};
     std::string m_message_cleared{};
@@ -40,5 +54,14 @@ class CairoIndicatorMessage {
     std::string m_message_wrong{};
 
     ColorSet m_font_color{};
+
+    struct DrawnState {
+        bool m_is_valid{false};
+        std::string m_message{};
+        Color m_color{};
+        cairo_rectangle_t m_rect{};
+    };
+
+    DrawnState m_drawn{};
 };
 }  // namespace wall
@@ -9,16 +9,18 @@
 #include "util/StringUtils.hpp"
 
 wall::CairoIndicatorSurface::CairoIndicatorSurface(const Config& config, Surface* surface, wl_output_subpixel subpixel)
-    : CairoSurface(config, surface, subpixel), m_indicator{config}, m_indicator_message{config}, m_analog_clock{config} {
+    : CairoSurface(config, surface, subpixel), m_indicator{config, surface->get_registry()->get_image_registry_mut()},
+      m_indicator_message{config}, m_analog_clock{config} {
     update_settings();
 
     m_last_state = StateCheck{};
     set_state(State::Idle);
 }
 
-wall::CairoIndicatorSurface::~CairoIndicatorSurface() = default;
+wall::CairoIndicatorSurface::~CairoIndicatorSurface() { cancel_render(); }
 
 auto wall::CairoIndicatorSurface::update_settings() -> void {
+    cancel_render();
     m_is_lock_enabled = wall_conf_get(get_config(), lock_indicator, enabled);
     m_is_wallpaper_enabled = wall_conf_get(get_config(), wallpaper, indicator_enabled);
     const auto monitor = wall_conf_get(get_config(), lock_indicator, monitor);
@@ -38,8 +40,9 @@ auto wall::CairoIndicatorSurface::update_settings() -> void {
     m_last_state = StateCheck{};
 
     // set last activity to zero
-    set_last_activity_time(std::chrono::system_clock::time_point{});
+    set_last_activity_time(loop::Clock::time_point{});
     set_last_draw_time(std::chrono::system_clock::time_point{});
+    request_redraw();
 }
 
 auto wall::CairoIndicatorSurface::update_message() -> void {
@@ -53,8 +56,8 @@ auto wall::CairoIndicatorSurface::update_message() -> void {
     m_indicator_message.update_message(get_state(), get_now());
 }
 
-auto wall::CairoIndicatorSurface::on_state_change(State state) -> void {
-    CairoSurface::on_state_change(state);
+auto wall::CairoIndicatorSurface::apply_state_change(State state) -> void {
+    CairoSurface::apply_state_change(state);
     m_indicator.on_state_change(state);
 }
 
@@ -77,10 +80,9 @@ auto wall::CairoIndicatorSurface::should_draw() -> bool {
         return false;
     }
 
-    if (m_is_analog_clock_enabled &&
-        m_analog_clock.should_redraw(std::chrono::duration_cast<std::chrono::milliseconds>(get_now() - get_last_draw_time()))) {
+    if (m_is_analog_clock_enabled && m_analog_clock.should_redraw(get_last_draw_time(), get_now())) {
         // force redraw if analog clock needs to be updated
-        m_last_state = StateCheck{};
+        m_is_clock_redraw_due = true;
         return true;
     }
 
@@ -93,10 +95,15 @@ auto wall::CairoIndicatorSurface::draw_frame(int32_t width, int32_t height) -> s
     }
 
     update_message();
+    const auto is_analog_clock_drawn = m_indicator_message.get_message().empty() && m_is_analog_clock_enabled;
+    const auto time_to_redraw = is_analog_clock_drawn ? m_analog_clock.get_time_to_redraw(get_now())
+                                                      : m_indicator_message.get_time_to_redraw(get_state(), get_now());
+
     StateCheck current_state{width, height, m_indicator.get_highlight_start(), get_state(), m_indicator_message.get_message()};
-    if (m_last_state == current_state) {
-        return std::chrono::milliseconds::zero();
+    if (m_last_state == current_state && !m_is_clock_redraw_due) {
+        return time_to_redraw;
     }
+    m_is_clock_redraw_due = false;
 
     const auto radius = m_indicator.get_radius();
     const auto thickness = m_indicator.get_thickness();
@@ -107,33 +114,54 @@ auto wall::CairoIndicatorSurface::draw_frame(int32_t width, int32_t height) -> s
         LOG_FATAL("Invalid buffer size for indicator");
     }
 
-    create_cairo_surface(buffer_width, buffer_height, get_pixel_width());
-    auto* cairo = get_cairo_state()->get_cairo();
-
     const auto center_x = buffer_width / 2.0;
     const auto center_y = buffer_height / 2.0;
 
-    const auto min_indicator_redraw_time = m_indicator.draw(cairo, center_x, center_y);
-    auto min_msg_redraw_time = m_indicator_message.draw(cairo, get_state(), get_font_cache(), buffer_width / 2.0, buffer_height / 2.0);
-    if (m_indicator_message.get_message().empty() && m_is_analog_clock_enabled) {
-        min_msg_redraw_time = m_analog_clock.draw(cairo, center_x, center_y, get_state());
+    auto* damage = get_damage_mut();
+    if (m_last_state.m_width != width || m_last_state.m_height != height || m_last_state.m_indicator_state != get_state() ||
+        m_was_analog_clock_drawn != is_analog_clock_drawn) {
+        damage->add_full();
+    } else {
+        m_indicator.add_damage(damage, center_x, center_y);
+        m_indicator_message.add_damage(damage, get_state(), get_font_cache(), center_x, center_y);
+        if (is_analog_clock_drawn) {
+            m_analog_clock.add_damage(damage, center_x, center_y, get_state(), get_now());
+        }
+
+        // nothing visible changed, e.g. the analog clock is due but its hands did not move
+        if (damage->is_empty()) {
+            m_last_state = current_state;
+            return time_to_redraw;
+        }
     }
 
-    auto min_redraw_time = min_indicator_redraw_time;
-    if (min_redraw_time.count() == 0) {
-        min_redraw_time = min_msg_redraw_time;
-    } else if (min_msg_redraw_time.count() > 0) {
-        min_redraw_time = std::min(min_redraw_time, min_msg_redraw_time);
+    // the frame is drawn again once a buffer is released
+    if (!create_cairo_surface(buffer_width, buffer_height, get_pixel_width())) {
+        return time_to_redraw;
     }
 
     const auto subsurf_xpos = static_cast<int32_t>((width / 2.0) - (buffer_width / 2.0) + 2.0);
     const auto subsurf_ypos = static_cast<int32_t>((height / 2.0) - (radius + thickness));
 
-    update_surface(get_surface()->get_wl_indicator_surface(), get_surface()->get_wl_indicator_subsurface(), subsurf_xpos, subsurf_ypos,
-                   get_cairo_state()->get_buffer());
     m_last_state = current_state;
+    m_was_analog_clock_drawn = is_analog_clock_drawn;
     set_last_draw_time(get_now());
-    return min_redraw_time;
+
+    const auto state = get_state();
+    const auto now = get_now();
+    render_frame(
+        [this, center_x, center_y, state, now, is_analog_clock_drawn](cairo_t* cairo) {
+            m_indicator.draw(cairo, center_x, center_y);
+            m_indicator_message.draw(cairo, state, get_font_cache(), center_x, center_y);
+            if (is_analog_clock_drawn) {
+                m_analog_clock.draw(cairo, center_x, center_y, state, now);
+            }
+        },
+        [this, subsurf_xpos, subsurf_ypos]() {
+            update_surface(get_surface()->get_wl_indicator_surface(), get_surface()->get_wl_indicator_subsurface(), subsurf_xpos, subsurf_ypos,
+                           get_cairo_state()->get_buffer());
+        });
+    return time_to_redraw;
 }
 
 auto wall::CairoIndicatorSurface::get_buffer_size(int32_t buffer_diameter) -> std::pair<int32_t, int32_t> {
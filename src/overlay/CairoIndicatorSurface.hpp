@@ -19,9 +19,9 @@ class CairoIndicatorSurface : public CairoSurface {
 
     auto update_settings() -> void;
 
-    auto on_state_change(State state) -> void override;
-
    protected:
+    auto apply_state_change(State state) -> void override;
+
     auto draw_frame(int32_t width, int32_t height) -> std::chrono::milliseconds override;
 
     virtual auto get_buffer_size(int32_t buffer_diameter) -> std::pair<int32_t, int32_t>;
@@ -60,5 +60,9 @@ class CairoIndicatorSurface : public CairoSurface {
     CairoAnalogClockElement m_analog_clock;
 
     struct StateCheck m_last_state {};
+
+    bool m_is_clock_redraw_due{false};
+
+    bool m_was_analog_clock_drawn{false};
 };
 }  // namespace wall
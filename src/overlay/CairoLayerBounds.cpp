@@ -0,0 +1,67 @@
+#include "overlay/CairoLayerBounds.hpp"
+
+#include <cmath>
+
+auto wall::CairoLayerBounds::update(double center_x, double center_y, double extent) -> bool {
+    if (m_size > 0 && m_center_x == center_x && m_center_y == center_y) {
+        return false;
+    }
+
+    const auto margin_extent = extent + k_margin;
+
+    m_center_x = center_x;
+    m_center_y = center_y;
+    m_x_pos = static_cast<int32_t>(std::floor(center_x - margin_extent));
+    m_y_pos = static_cast<int32_t>(std::floor(center_y - margin_extent));
+    m_size = static_cast<int32_t>(std::ceil(margin_extent * 2.0)) + 1;
+    return true;
+}
+
+auto wall::CairoLayerBounds::reset() -> void { m_size = 0; }
+
+auto wall::CairoLayerBounds::create_cairo(cairo_t* target, cairo_format_t format) const -> cairo_t* {
+    auto* surface = cairo_image_surface_create(format, m_size, m_size);
+    auto* layer_cairo = cairo_create(surface);
+    cairo_surface_destroy(surface);
+
+    cairo_translate(layer_cairo, -m_x_pos, -m_y_pos);
+    cairo_set_antialias(layer_cairo, cairo_get_antialias(target));
+    cairo_set_operator(layer_cairo, cairo_get_operator(target));
+    return layer_cairo;
+}
+
+auto wall::CairoLayerBounds::create_mask_cairo(cairo_t* target) const -> cairo_t* {
+    auto* layer_cairo = create_mask_cairo(target, m_size, m_size);
+    cairo_translate(layer_cairo, -m_x_pos, -m_y_pos);
+    return layer_cairo;
+}
+
+auto wall::CairoLayerBounds::create_mask_cairo(cairo_t* target, int32_t width, int32_t height) -> cairo_t* {
+    auto* surface = cairo_image_surface_create(CAIRO_FORMAT_A8, width, height);
+    auto* layer_cairo = cairo_create(surface);
+    cairo_surface_destroy(surface);
+
+    cairo_set_antialias(layer_cairo, cairo_get_antialias(target));
+    cairo_set_operator(layer_cairo, CAIRO_OPERATOR_OVER);
+    cairo_set_source_rgba(layer_cairo, 0.0, 0.0, 0.0, 1.0);
+    return layer_cairo;
+}
+
+auto wall::CairoLayerBounds::destroy_surfaces(std::initializer_list<cairo_surface_t**> surfaces) -> void {
+    for (auto** surface : surfaces) {
+        if (*surface != nullptr) {
+            cairo_surface_destroy(*surface);
+            *surface = nullptr;
+        }
+    }
+}
+
+auto wall::CairoLayerBounds::get_center_x() const -> double { return m_center_x; }
+
+auto wall::CairoLayerBounds::get_center_y() const -> double { return m_center_y; }
+
+auto wall::CairoLayerBounds::get_x_pos() const -> int32_t { return m_x_pos; }
+
+auto wall::CairoLayerBounds::get_y_pos() const -> int32_t { return m_y_pos; }
+
+auto wall::CairoLayerBounds::get_size() const -> int32_t { return m_size; }
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cairo.h>
+#include <cstdint>
+#include <initializer_list>
+
+namespace wall {
+
+// Square area of the buffer around an element's center that its static parts are rendered into once. The layers are composited at the
+// bounds' position each frame and have to be rendered again once the element moves.
+class CairoLayerBounds {
+   public:
+    // antialiasing, and filtering rotated layers, touches pixels slightly outside of the geometry
+    static constexpr auto k_margin = 2.0;
+
+    // Covers extent around the center plus the margin. Returns true if the bounds changed, the layers rendered before are dropped then.
+    auto update(double center_x, double center_y, double extent) -> bool;
+
+    auto reset() -> void;
+
+    // Layer of the bounds' size, drawn in buffer coordinates and with the same settings as the target, so compositing it matches drawing
+    // directly
+    [[nodiscard]] auto create_cairo(cairo_t* target, cairo_format_t format) const -> cairo_t*;
+
+    // Coverage layer of the bounds' size in buffer coordinates, see the sized overload
+    [[nodiscard]] auto create_mask_cairo(cairo_t* target) const -> cairo_t*;
+
+    // Only coverage is rendered, the target's operator applies when it is painted through with a color
+    [[nodiscard]] static auto create_mask_cairo(cairo_t* target, int32_t width, int32_t height) -> cairo_t*;
+
+    // Destroys the surfaces that are set and nulls them
+    static auto destroy_surfaces(std::initializer_list<cairo_surface_t**> surfaces) -> void;
+
+    [[nodiscard]] auto get_center_x() const -> double;
+
+    [[nodiscard]] auto get_center_y() const -> double;
+
+    [[nodiscard]] auto get_x_pos() const -> int32_t;
+
+    [[nodiscard]] auto get_y_pos() const -> int32_t;
+
+    [[nodiscard]] auto get_size() const -> int32_t;
+
+   private:
+    double m_center_x{};
+    double m_center_y{};
+
+    int32_t m_x_pos{};
+    int32_t m_y_pos{};
+    int32_t m_size{};
+};
+}  // namespace wall
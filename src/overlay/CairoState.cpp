@@ -26,8 +26,14 @@ auto wall::CairoState::get_surface() const -> cairo_surface_t* { return m_surfac
 
 auto wall::CairoState::get_buffer() const -> Buffer* { return m_buffer.get(); }
 
+auto wall::CairoState::take_buffer() -> std::unique_ptr<Buffer> { return std::move(m_buffer); }
+
 auto wall::CairoState::get_width() const -> int32_t { return m_width; }
 
 auto wall::CairoState::get_height() const -> int32_t { return m_height; }
 
 auto wall::CairoState::get_pixel_width() const -> int32_t { return m_pixel_width; }
+
+auto wall::CairoState::get_frame() const -> uint64_t { return m_frame; }
+
+auto wall::CairoState::set_frame(uint64_t frame) -> void { m_frame = frame; }
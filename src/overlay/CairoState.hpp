@@ -19,18 +19,28 @@ class CairoState {
 
     [[nodiscard]] auto get_buffer() const -> Buffer*;
 
+    // Takes the buffer out of the state so it can be returned to the buffer pool
+    [[nodiscard]] auto take_buffer() -> std::unique_ptr<Buffer>;
+
     [[nodiscard]] auto get_width() const -> int32_t;
 
     [[nodiscard]] auto get_height() const -> int32_t;
 
     [[nodiscard]] auto get_pixel_width() const -> int32_t;
 
+    // Frame the buffer was last drawn for, 0 if its contents are unknown
+    [[nodiscard]] auto get_frame() const -> uint64_t;
+
+    auto set_frame(uint64_t frame) -> void;
+
    protected:
    private:
     int32_t m_width{};
     int32_t m_height{};
     int32_t m_pixel_width{};
 
+    uint64_t m_frame{0UL};
+
     cairo_t* m_cairo{};
 
     cairo_surface_t* m_surface{};
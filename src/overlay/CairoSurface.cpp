@@ -3,25 +3,53 @@
 #include <cairo.h>
 #include <wayland-client-protocol.h>
 #include <wayland-client.h>
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include "display/Display.hpp"
 #include "registry/Registry.hpp"
+#include "render/OverlayCompositor.hpp"
 #include "surface/Surface.hpp"
 #include "util/Log.hpp"
 
 namespace {
 constexpr auto k_pixel_width = 4;
+
+auto clear_cairo(cairo_t* cairo) -> void {
+    cairo_set_source_rgba(cairo, 0, 0, 0, 0);
+    cairo_set_operator(cairo, CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cairo);
+}
 }  // namespace
 
+const wl_callback_listener wall::CairoSurface::k_frame_listener = {
+    .done =
+        [](void* data, wl_callback* callback, uint32_t /* time */) {
+            wl_callback_destroy(callback);
+            auto* cairo_surface = static_cast<CairoSurface*>(data);
+            cairo_surface->m_frame_callback = nullptr;
+            cairo_surface->draw_if_due(cairo_surface->m_last_width, cairo_surface->m_last_height);
+        },
+};
+
 wall::CairoSurface::CairoSurface(const Config& config, Surface* surface, wl_output_subpixel subpixel)
-    : m_config{config}, m_font_cache{config, wl_subpixel_to_cairo_subpixel(subpixel)}, m_surface{surface} {}
+    : m_config{config},
+      m_font_cache{config, surface->get_registry()->get_font_registry_mut(), wl_subpixel_to_cairo_subpixel(subpixel)},
+      m_surface{surface} {}
 
 wall::CairoSurface::~CairoSurface() {
+    cancel_render();
+    if (m_surface->get_overlay_compositor_mut() != nullptr) {
+        m_surface->get_overlay_compositor_mut()->remove_layer(this);
+    }
     if (m_redraw_timer != nullptr) {
         m_redraw_timer->close();
         m_redraw_timer = nullptr;
     }
+    if (m_frame_callback != nullptr) {
+        wl_callback_destroy(m_frame_callback);
+        m_frame_callback = nullptr;
+    }
 }
 
 auto wall::CairoSurface::get_font_cache() const -> const CairoFontCache& { return m_font_cache; }
@@ -32,11 +60,15 @@ auto wall::CairoSurface::get_now() const -> std::chrono::system_clock::time_poin
 
 auto wall::CairoSurface::set_now(std::chrono::system_clock::time_point now) -> void { m_now = now; }
 
+auto wall::CairoSurface::get_monotonic_now() const -> loop::Clock::time_point { return m_monotonic_now; }
+
+auto wall::CairoSurface::set_monotonic_now(loop::Clock::time_point now) -> void { m_monotonic_now = now; }
+
 auto wall::CairoSurface::get_last_draw_time() const -> std::chrono::system_clock::time_point { return m_last_draw_time; }
 
-auto wall::CairoSurface::get_last_activity_time() const -> std::chrono::system_clock::time_point { return m_last_activity_time; }
+auto wall::CairoSurface::get_last_activity_time() const -> loop::Clock::time_point { return m_last_activity_time; }
 
-auto wall::CairoSurface::get_cairo_state() const -> CairoState* { return m_cairo_state.get(); }
+auto wall::CairoSurface::get_cairo_state() const -> CairoState* { return m_cairo_state; }
 
 auto wall::CairoSurface::get_config() const -> const Config& { return m_config; }
 
@@ -67,10 +99,12 @@ auto wall::CairoSurface::wl_subpixel_to_cairo_subpixel(wl_output_subpixel subpix
     return cario_subpixel;
 }
 
-auto wall::CairoSurface::set_last_activity_time(std::chrono::system_clock::time_point now) -> void { m_last_activity_time = now; }
+auto wall::CairoSurface::set_last_activity_time(loop::Clock::time_point now) -> void { m_last_activity_time = now; }
 
 auto wall::CairoSurface::set_last_draw_time(std::chrono::system_clock::time_point now) -> void { m_last_draw_time = now; }
 
+auto wall::CairoSurface::request_redraw() -> void { m_is_redraw_due = true; }
+
 auto wall::CairoSurface::set_idle_timeout(std::chrono::milliseconds idle_timeout) -> void { m_idle_timeout = idle_timeout; }
 
 auto wall::CairoSurface::set_is_visible_on_idle(bool is_visible_on_idle) -> void { m_is_visible_on_idle = is_visible_on_idle; }
@@ -80,6 +114,15 @@ auto wall::CairoSurface::set_state(State state) -> void { m_state = state; }
 auto wall::CairoSurface::get_state() const -> State { return m_state; }
 
 auto wall::CairoSurface::on_state_change(State state) -> void {
+    if (m_render_job != nullptr) {
+        m_pending_states.push_back(state);
+        return;
+    }
+
+    apply_state_change(state);
+}
+
+auto wall::CairoSurface::apply_state_change(State state) -> void {
     set_last_draw_time({});
     switch (state) {
         case State::None:
@@ -91,10 +134,10 @@ auto wall::CairoSurface::on_state_change(State state) -> void {
             if (get_state() == State::Idle || get_state() == State::Cleared || get_state() == State::Wrong) {
                 set_state(State::Input);
             }
-            set_last_activity_time(get_now());
+            set_last_activity_time(get_monotonic_now());
             break;
         case State::Wrong:
-            set_last_activity_time(get_now());
+            set_last_activity_time(get_monotonic_now());
             [[fallthrough]];
         case State::Cleared:
             [[fallthrough]];
@@ -115,7 +158,7 @@ auto wall::CairoSurface::on_state_change(State state) -> void {
 }
 
 auto wall::CairoSurface::should_draw_frame_on_idle(wl_surface* surface, wl_subsurface* subsurface) -> bool {
-    const auto time_since_last_activity = get_now() - m_last_activity_time;
+    const auto time_since_last_activity = get_monotonic_now() - m_last_activity_time;
     if (m_last_activity_time.time_since_epoch().count() != 0 && time_since_last_activity >= m_idle_timeout && m_state != State::Idle &&
         m_state != State::Verifying && m_state != State::Wrong) {
         set_state(State::Idle);
@@ -130,6 +173,18 @@ auto wall::CairoSurface::update_surface(wl_surface* child_surface,
                                         int32_t subsurf_xpos,
                                         int32_t subsurf_ypos,
                                         Buffer* buffer) -> void {
+    auto* overlay_compositor = m_surface->get_overlay_compositor_mut();
+    if (overlay_compositor != nullptr && buffer != nullptr) {
+        // blended into the next wallpaper frame instead, which has to be rendered even if mpv has nothing new
+        overlay_compositor->set_layer(this, buffer, subsurf_xpos, subsurf_ypos, m_frame_damage);
+        m_frame_damage.clear();
+        // a layer set while the wallpaper presents is blended into that very frame
+        if (!m_surface->is_presenting() && m_surface->get_renderer_mut() != nullptr) {
+            m_surface->get_renderer_mut()->set_is_dirty(true);
+        }
+        return;
+    }
+
     if (child_surface == nullptr || buffer == nullptr) {
         return;
     }
@@ -138,58 +193,224 @@ auto wall::CairoSurface::update_surface(wl_surface* child_surface,
 
     wl_surface_set_buffer_scale(child_surface, 1);  // this is always 1 since we use fractional scaling + viewport
     wl_surface_attach(child_surface, buffer->m_buffer, 0, 0);
-    wl_surface_damage_buffer(child_surface, 0, 0, INT32_MAX, INT32_MAX);
+    buffer->m_is_free = false;
+    if (m_frame_damage.is_empty() || m_frame_damage.is_full()) {
+        wl_surface_damage_buffer(child_surface, 0, 0, INT32_MAX, INT32_MAX);
+    } else {
+        for (const auto& rect : m_frame_damage.get_rects()) {
+            wl_surface_damage_buffer(child_surface, rect.x, rect.y, rect.width, rect.height);
+        }
+    }
+    m_frame_damage.clear();
+    if (m_frame_callback == nullptr) {
+        m_frame_callback = wl_surface_frame(child_surface);
+        wl_callback_add_listener(m_frame_callback, &k_frame_listener, this);
+    }
     wl_surface_commit(child_surface);
-    wl_surface_commit(m_surface->get_wl_surface());
+
+    // the subsurface is synchronized, while the wallpaper presents its own commit applies the overlay together with the video frame
+    if (!m_surface->is_presenting()) {
+        wl_surface_commit(m_surface->get_wl_surface());
+    }
 }
 
-auto wall::CairoSurface::clear() -> void {
+auto wall::CairoSurface::clear_surface(wl_surface* surface, wl_subsurface* subsurface) -> void {
     if (m_cairo_state == nullptr) {
         return;
     }
 
-    auto* cairo = m_cairo_state->get_cairo();
-    cairo_set_source_rgba(cairo, 0, 0, 0, 0);
-    cairo_set_operator(cairo, CAIRO_OPERATOR_SOURCE);
-    cairo_paint(cairo);
-
-    if (m_redraw_timer != nullptr) {
-        m_redraw_timer->close();
-        m_redraw_timer = nullptr;
+    m_damage.add_full();
+    if (create_cairo_surface(m_cairo_state->get_width(), m_cairo_state->get_height(), m_cairo_state->get_pixel_width())) {
+        update_surface(surface, subsurface, 0, 0, m_cairo_state->get_buffer());
+    } else if (m_surface->get_overlay_compositor_mut() != nullptr) {
+        m_surface->get_overlay_compositor_mut()->remove_layer(this);
+        if (m_surface->get_renderer_mut() != nullptr) {
+            m_surface->get_renderer_mut()->set_is_dirty(true);
+        }
+    } else if (surface != nullptr) {
+        // every buffer is still in use, unmap the surface instead of waiting for one to clear
+        wl_surface_attach(surface, nullptr, 0, 0);
+        wl_surface_commit(surface);
+        wl_surface_commit(m_surface->get_wl_surface());
     }
 }
 
-auto wall::CairoSurface::clear_surface(wl_surface* surface, wl_subsurface* subsurface) -> void {
-    // clear buffer
-    if (m_cairo_state != nullptr) {
-        clear();
-        update_surface(surface, subsurface, 0, 0, m_cairo_state->get_buffer());
+auto wall::CairoSurface::create_cairo_surface(int32_t width, int32_t height, int32_t pixel_size) -> bool {
+    const auto is_free = [](const std::unique_ptr<CairoState>& state) { return state == nullptr || state->get_buffer()->m_is_free; };
+    const auto is_same_size = [&](const std::unique_ptr<CairoState>& state) {
+        return state != nullptr && state->get_width() == width && state->get_height() == height && state->get_pixel_width() == pixel_size;
+    };
+
+    // prefer a released buffer of the right size, then an empty slot, then a released buffer of another size
+    auto slot = std::ranges::find_if(m_cairo_states, [&](const auto& state) { return is_same_size(state) && is_free(state); });
+    if (slot != m_cairo_states.end()) {
+        begin_frame(slot->get());
+        return true;
+    }
+
+    slot = std::ranges::find_if(m_cairo_states, [](const auto& state) { return state == nullptr; });
+    if (slot == m_cairo_states.end()) {
+        slot = std::ranges::find_if(m_cairo_states, is_free);
+    }
+
+    if (slot == m_cairo_states.end()) {
+        LOG_DEBUG("All overlay buffers are in use, deferring draw");
+        m_is_redraw_due = true;
+        m_damage.clear();
+        return false;
     }
+
+    auto* buffer_pool = m_surface->get_registry()->get_buffer_pool_mut();
+    if (*slot != nullptr) {
+        // the overlay changes between a few sizes as the text changes, keep the old buffer around for when it switches back
+        if (m_cairo_state == slot->get()) {
+            m_cairo_state = nullptr;
+        }
+        auto old_buffer = (*slot)->take_buffer();
+        *slot = nullptr;
+        buffer_pool->release_buffer(std::move(old_buffer));
+    }
+
+    auto buffer = buffer_pool->acquire_buffer(width, height, pixel_size, WL_SHM_FORMAT_ARGB8888);
+    if (buffer == nullptr) {
+        LOG_FATAL("Failed to create buffer");
+    }
+    buffer->m_on_release = [this]() { on_buffer_release(); };
+
+    auto* surface = cairo_image_surface_create_for_data((unsigned char*)buffer->m_data, CAIRO_FORMAT_ARGB32, width, height, pixel_size * width);
+    auto* cairo = cairo_create(surface);
+    *slot = std::make_unique<CairoState>(width, height, pixel_size, cairo, surface, std::move(buffer));
+
+    cairo_set_antialias(cairo, CAIRO_ANTIALIAS_BEST);
+
+    begin_frame(slot->get());
+    return true;
 }
 
-auto wall::CairoSurface::create_cairo_surface(int32_t width, int32_t height, int32_t pixel_size) -> void {
-    if (m_cairo_state != nullptr && m_cairo_state->get_width() == width && m_cairo_state->get_height() == height &&
-        m_cairo_state->get_pixel_width() == pixel_size) {
-        clear();
+auto wall::CairoSurface::begin_frame(CairoState* state) -> void {
+    // nothing reported means everything may have changed, element damage is also meaningless if the overlay changed size
+    if (m_damage.is_empty() || m_cairo_state == nullptr || m_cairo_state->get_width() != state->get_width() ||
+        m_cairo_state->get_height() != state->get_height()) {
+        m_damage.add_full();
+    }
+
+    // the buffer still holds the frame it was last drawn for, everything damaged since then has to be repainted as well. Buffers from
+    // the pool or older than the damage history are repainted completely.
+    const auto frame = m_frame + 1;
+    CairoDamage repaint;
+    if (state->get_frame() == 0 || frame - state->get_frame() > k_max_buffers + 1) {
+        repaint.add_full();
     } else {
-        auto buffer = m_surface->get_registry()->get_buffer_pool_mut()->create_buffer(width, height, pixel_size, WL_SHM_FORMAT_ARGB8888);
-        if (buffer == nullptr) {
-            LOG_FATAL("Failed to create buffer");
+        for (auto past_frame = state->get_frame() + 1; past_frame < frame; past_frame++) {
+            repaint.add(m_damage_history.at(past_frame % k_max_buffers));
         }
+        repaint.add(m_damage);
+    }
+
+    auto* cairo = state->get_cairo();
+    cairo_reset_clip(cairo);
+    if (!repaint.is_full()) {
+        for (const auto& rect : repaint.get_rects()) {
+            cairo_rectangle(cairo, rect.x, rect.y, rect.width, rect.height);
+        }
+        cairo_clip(cairo);
+    }
+    clear_cairo(cairo);
+
+    // drawing stays clipped to the repainted area until the next frame
+    m_frame = frame;
+    m_damage_history.at(m_frame % k_max_buffers) = m_damage;
+    m_frame_damage = std::move(m_damage);
+    m_damage.clear();
+
+    state->set_frame(m_frame);
+    m_cairo_state = state;
+}
+
+auto wall::CairoSurface::get_damage_mut() -> CairoDamage* { return &m_damage; }
+
+auto wall::CairoSurface::render_frame(std::function<void(cairo_t*)> rasterize, std::function<void()> present) -> void {
+    auto job = std::make_shared<RenderJob>();
+    m_render_job = job;
+
+    auto* cairo = m_cairo_state->get_cairo();
+    m_surface->get_registry()->get_overlay_worker_pool_mut()->post(
+        [job, cairo, rasterize = std::move(rasterize)]() {
+            rasterize(cairo);
+            cairo_surface_flush(cairo_get_target(cairo));
+
+            std::lock_guard<std::mutex> lock(job->m_guard);
+            job->m_is_done = true;
+            job->m_done.notify_all();
+        },
+        [this, job, present = std::move(present)]() {
+            if (job->m_is_cancelled) {
+                return;
+            }
+
+            m_render_job = nullptr;
+            present();
+            on_render_done();
+        });
+}
+
+auto wall::CairoSurface::cancel_render() -> void {
+    if (m_render_job == nullptr) {
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_render_job->m_guard);
+        m_render_job->m_done.wait(lock, [this]() { return m_render_job->m_is_done; });
+    }
+    m_render_job->m_is_cancelled = true;
+    m_render_job = nullptr;
+
+    // the states held back belong before any that arrive from now on, and the cancelled frame still has to be drawn
+    apply_pending_states();
+    m_is_redraw_due = true;
+}
+
+auto wall::CairoSurface::on_render_done() -> void {
+    apply_pending_states();
+    draw_if_due(m_last_width, m_last_height);
+}
+
+auto wall::CairoSurface::apply_pending_states() -> void {
+    auto pending_states = std::move(m_pending_states);
+    m_pending_states.clear();
+    for (const auto state : pending_states) {
+        apply_state_change(state);
+    }
+}
 
-        auto* surface = cairo_image_surface_create_for_data((unsigned char*)buffer->m_data, CAIRO_FORMAT_ARGB32, width, height, pixel_size * width);
-        auto* cairo = cairo_create(surface);
-        auto cairo_state = std::make_unique<CairoState>(width, height, pixel_size, cairo, surface, std::move(buffer));
+auto wall::CairoSurface::on_buffer_release() -> void { draw_if_due(m_last_width, m_last_height); }
 
-        cairo_set_antialias(cairo, CAIRO_ANTIALIAS_BEST);
+auto wall::CairoSurface::is_frame_in_flight() const -> bool {
+    if (m_frame_callback != nullptr) {
+        return true;
+    }
+
+    auto* overlay_compositor = m_surface->get_overlay_compositor_mut();
+    return overlay_compositor != nullptr && overlay_compositor->is_layer_pending(this);
+}
 
-        m_cairo_state = std::move(cairo_state);
+auto wall::CairoSurface::draw_if_due(int32_t width, int32_t height) -> void {
+    if (!m_is_redraw_due && width == m_last_width && height == m_last_height) {
+        return;
     }
+
+    draw(width, height);
 }
 
 auto wall::CairoSurface::draw(int32_t width, int32_t height) -> void {
     m_last_width = width;
     m_last_height = height;
+    if (m_render_job != nullptr || is_frame_in_flight()) {
+        m_is_redraw_due = true;
+        return;
+    }
+
     // this happens when we've switched to the main desktop
     if (get_state() == State::Valid) {
         return;
@@ -201,25 +422,63 @@ auto wall::CairoSurface::draw(int32_t width, int32_t height) -> void {
     }
 
     if (!m_surface->is_ready_to_draw()) {
+        m_is_redraw_due = true;
         return;
     }
 
+    m_is_redraw_due = false;
     m_now = std::chrono::system_clock::now();
+    m_monotonic_now = loop::Clock::now();
+
+    const auto time_to_change = draw_frame(width, height);
+    const auto time_to_idle = get_time_to_idle();
+    if (time_to_change.count() == 0 || time_to_idle.count() == 0) {
+        schedule_redraw(std::max(time_to_change, time_to_idle));
+    } else {
+        schedule_redraw(std::min(time_to_change, time_to_idle));
+    }
+}
+
+auto wall::CairoSurface::get_time_to_idle() const -> std::chrono::milliseconds {
+    // mirrors should_draw_frame_on_idle
+    if (m_last_activity_time.time_since_epoch().count() == 0 || m_state == State::Idle || m_state == State::Verifying ||
+        m_state == State::Wrong) {
+        return std::chrono::milliseconds::zero();
+    }
 
-    const auto min_redraw_time = draw_frame(width, height);
-    setup_redraw_timer(min_redraw_time);
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(m_last_activity_time + m_idle_timeout - m_monotonic_now);
+    return std::max(remaining, std::chrono::milliseconds{1});
 }
 
-auto wall::CairoSurface::setup_redraw_timer(std::chrono::milliseconds min_redraw_time) -> void {
-    if (min_redraw_time.count() > 0 && m_surface->get_display() != nullptr && m_surface->get_display()->get_loop() != nullptr) {
+auto wall::CairoSurface::schedule_redraw(std::chrono::milliseconds delay) -> void {
+    if (delay.count() == 0) {
+        // nothing changes on its own, the timer stays around disarmed instead of waking the loop
         if (m_redraw_timer != nullptr) {
-            if (m_redraw_timer->get_expiration() > (m_now + min_redraw_time)) {
-                m_redraw_timer->set_expiration(m_now + min_redraw_time);
-                m_redraw_timer->set_interval(min_redraw_time);
-            }
-        } else {
-            m_redraw_timer = m_surface->get_display()->get_loop()->add_timer(min_redraw_time, min_redraw_time,
-                                                                             [this](loop::Timer* /* timer */) { draw(m_last_width, m_last_height); });
+            m_redraw_timer->set_expiration(loop::Clock::time_point::max());
         }
+        return;
     }
+
+    if (m_surface->get_display() == nullptr || m_surface->get_display()->get_loop() == nullptr) {
+        return;
+    }
+
+    // loop timers run on the loop's monotonic clock, the delay was computed from wall time for the clock display. The loop's cached time
+    // lags behind after long callbacks, so the expiration is taken from the clock on every arm, otherwise the redraw fires before the tick.
+    const auto expiration = loop::Clock::now() + delay;
+    if (m_redraw_timer == nullptr) {
+        m_redraw_timer = m_surface->get_display()->get_loop()->add_timer(std::chrono::milliseconds::zero(), std::chrono::milliseconds::zero(),
+                                                                         [this](loop::Timer* /* timer */) { on_redraw_timer(); });
+    }
+    m_redraw_timer->set_expiration(expiration);
+}
+
+auto wall::CairoSurface::on_redraw_timer() -> void {
+    // the wallpaper is about to present a new frame anyway, the overlay is drawn along with it from Surface::draw_overlay
+    if (m_surface->is_frame_pending()) {
+        m_is_redraw_due = true;
+        return;
+    }
+
+    draw(m_last_width, m_last_height);
 }
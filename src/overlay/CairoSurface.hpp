@@ -2,9 +2,16 @@
 
 #include <cairo.h>
 #include <wayland-client-protocol.h>
+#include <array>
 #include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "State.hpp"
 #include "conf/Config.hpp"
+#include "overlay/CairoDamage.hpp"
 #include "overlay/CairoFontCache.hpp"
 #include "overlay/CairoState.hpp"
 #include "registry/BufferPool.hpp"
@@ -24,18 +31,24 @@ class CairoSurface {
     CairoSurface(CairoSurface&&) = delete;
     auto operator=(CairoSurface&&) -> CairoSurface& = delete;
 
+    // Draws the overlay unless the last frame is still on its way to the screen, in which case it is drawn once that frame is shown
     auto draw(int32_t width, int32_t height) -> void;
 
-    virtual auto on_state_change(State state) -> void;
+    // Draws the overlay if a redraw is due or its size changed, called when the wallpaper presents a frame so the overlay goes along
+    auto draw_if_due(int32_t width, int32_t height) -> void;
+
+    // Held back while a frame is being rendered on a worker thread, the changes are applied once it is presented
+    auto on_state_change(State state) -> void;
 
     [[nodiscard]] auto get_pixel_width() const -> int32_t;
 
    protected:
     static auto wl_subpixel_to_cairo_subpixel(wl_output_subpixel subpixel) -> cairo_subpixel_order_t;
 
+    // Returns the time until the overlay changes on its own, e.g. the next clock tick, zero if it only changes on state changes
     virtual auto draw_frame(int32_t width, int32_t height) -> std::chrono::milliseconds = 0;
 
-    auto setup_redraw_timer(std::chrono::milliseconds min_redraw_time) -> void;
+    virtual auto apply_state_change(State state) -> void;
 
     [[nodiscard]] auto should_draw_frame_on_idle(wl_surface* surface, wl_subsurface* subsurface) -> bool;
 
@@ -49,16 +62,22 @@ class CairoSurface {
 
     [[nodiscard]] auto get_font_cache_mut() -> CairoFontCache*;
 
+    // Wall time of the current draw, only for what clocks display
     [[nodiscard]] auto get_now() const -> std::chrono::time_point<std::chrono::system_clock>;
 
+    // Loop time of the current draw, the idle timeout is measured on it so wall clock steps do not move it
+    [[nodiscard]] auto get_monotonic_now() const -> loop::Clock::time_point;
+
     [[nodiscard]] auto get_state() const -> State;
 
     [[nodiscard]] auto get_last_draw_time() const -> std::chrono::time_point<std::chrono::system_clock>;
 
-    [[nodiscard]] auto get_last_activity_time() const -> std::chrono::time_point<std::chrono::system_clock>;
+    [[nodiscard]] auto get_last_activity_time() const -> loop::Clock::time_point;
 
     auto set_now(std::chrono::time_point<std::chrono::system_clock> now) -> void;
 
+    auto set_monotonic_now(loop::Clock::time_point now) -> void;
+
     auto set_idle_timeout(std::chrono::milliseconds idle_timeout) -> void;
 
     auto set_is_visible_on_idle(bool is_visible_on_idle) -> void;
@@ -67,18 +86,64 @@ class CairoSurface {
 
     auto set_last_draw_time(std::chrono::time_point<std::chrono::system_clock> now) -> void;
 
-    auto set_last_activity_time(std::chrono::time_point<std::chrono::system_clock> now) -> void;
+    auto set_last_activity_time(loop::Clock::time_point now) -> void;
+
+    // Makes the next draw_if_due draw
+    auto request_redraw() -> void;
 
     virtual auto update_surface(wl_surface* child_surface, wl_subsurface* subsurface, int32_t subsurf_xpos, int32_t subsurf_ypos, Buffer* buffer)
         -> void;
 
-    auto create_cairo_surface(int32_t width, int32_t height, int32_t pixel_size) -> void;
+    // Makes a cairo state the current one, backed by a buffer the compositor is not reading. Overlays rotate through up to
+    // k_max_buffers buffers, if all of them are still in use nothing is drawn and the frame is drawn again once one is released.
+    // Only the areas added to get_damage_mut() before the call are cleared and left unclipped, with no damage the whole buffer is.
+    [[nodiscard]] auto create_cairo_surface(int32_t width, int32_t height, int32_t pixel_size) -> bool;
 
-    auto clear() -> void;
+    // Damage of the next frame
+    [[nodiscard]] auto get_damage_mut() -> CairoDamage*;
 
     auto clear_surface(wl_surface* surface, wl_subsurface* subsurface) -> void;
 
+    // Rasterizes into the current cairo state on an overlay worker thread, or right away if there are none. Present then runs on the
+    // loop thread to attach the buffer. Until then the overlay, its elements and its font cache belong to the worker, draws and state
+    // changes are held back.
+    auto render_frame(std::function<void(cairo_t*)> rasterize, std::function<void()> present) -> void;
+
+    // Waits for a frame being rendered and drops its present, has to be called before anything used by rasterize is changed or destroyed.
+    // State changes held back for the frame are applied and the overlay is drawn again on the next draw_if_due.
+    auto cancel_render() -> void;
+
    private:
+    static constexpr size_t k_max_buffers = 3;
+
+    auto on_buffer_release() -> void;
+
+    auto begin_frame(CairoState* state) -> void;
+
+    auto on_render_done() -> void;
+
+    auto apply_pending_states() -> void;
+
+    // True while the last frame has not reached the screen yet, drawing again before that would only replace it unseen
+    [[nodiscard]] auto is_frame_in_flight() const -> bool;
+
+    // Arms the redraw timer for the given delay, disarms it for zero
+    auto schedule_redraw(std::chrono::milliseconds delay) -> void;
+
+    auto on_redraw_timer() -> void;
+
+    // Time until the overlay hides itself for being idle, zero if it never does from its current state
+    [[nodiscard]] auto get_time_to_idle() const -> std::chrono::milliseconds;
+
+    static const wl_callback_listener k_frame_listener;
+
+    struct RenderJob {
+        std::mutex m_guard;
+        std::condition_variable m_done;
+        bool m_is_done{false};
+        bool m_is_cancelled{false};
+    };
+
     const Config& m_config;
 
     CairoFontCache m_font_cache;
@@ -87,7 +152,32 @@ class CairoSurface {
 
     loop::Timer* m_redraw_timer{};
 
-    std::unique_ptr<CairoState> m_cairo_state{};
+    std::array<std::unique_ptr<CairoState>, k_max_buffers> m_cairo_states{};
+
+    // State last drawn into, one of m_cairo_states
+    CairoState* m_cairo_state{};
+
+    // Set when a draw was held back, it happens once whatever held it back is done
+    bool m_is_redraw_due{true};
+
+    // Frame callback of the overlay's subsurface, pending until the compositor shows the last attached buffer
+    wl_callback* m_frame_callback{};
+
+    // Frame being rendered on a worker thread
+    std::shared_ptr<RenderJob> m_render_job;
+
+    // State changes that arrived while a frame was being rendered
+    std::vector<State> m_pending_states;
+
+    uint64_t m_frame{0UL};
+
+    CairoDamage m_damage;
+
+    // Damage of the frame being drawn, sent to the compositor by update_surface
+    CairoDamage m_frame_damage;
+
+    // Damage of the last frames indexed by frame number, to bring older buffers up to date
+    std::array<CairoDamage, k_max_buffers> m_damage_history{};
 
     int32_t m_last_width{};
 
@@ -100,7 +190,8 @@ class CairoSurface {
     State m_state{};
 
     std::chrono::time_point<std::chrono::system_clock> m_now{};
-    std::chrono::time_point<std::chrono::system_clock> m_last_activity_time{};
+    loop::Clock::time_point m_monotonic_now{};
+    loop::Clock::time_point m_last_activity_time{};
     std::chrono::time_point<std::chrono::system_clock> m_last_draw_time{};
 };
 }  // namespace wall
@@ -24,6 +24,8 @@ struct Color {
     static auto set_cairo_color(cairo_t* cairo, const Color& color) -> void;
 
     [[nodiscard]] auto to_string() const -> std::string;
+
+    auto operator==(const Color& other) const -> bool = default;
 };
 
 }  // namespace wall
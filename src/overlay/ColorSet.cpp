@@ -18,3 +18,18 @@ auto wall::ColorSet::get(wall::State state) const -> wall::Color {
             return m_input;
     }
 }
+
+auto wall::ColorSet::get_index(wall::State state) -> size_t {
+    switch (state) {
+        case State::Cleared:
+            return 1;
+        case State::CapsLock:
+            return 2;
+        case State::Verifying:
+            return 3;
+        case State::Wrong:
+            return 4;
+        default:
+            return 0;
+    }
+}
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <cstddef>
 #include "State.hpp"
 #include "overlay/Color.hpp"
 
 namespace wall {
 struct ColorSet {
+    static constexpr size_t k_size = 5;
+
     Color m_input;
     Color m_cleared;
     Color m_caps_lock;
@@ -12,5 +15,8 @@ struct ColorSet {
     Color m_wrong;
 
     [[nodiscard]] auto get(State state) const -> Color;
+
+    // States that share a color share an index
+    [[nodiscard]] static auto get_index(State state) -> size_t;
 };
 }  // namespace wall
@@ -17,7 +17,7 @@ wall::PasswordManager::PasswordManager(Loop* loop) : m_loop{loop}, m_passwd(getp
         .appdata_ptr = this,
     };
 
-    m_auth_done_poll = m_loop->add_poll_pipe([this](loop::PollPipe*, const std::vector<uint8_t>&) {
+    m_auth_done_poll = m_loop->add_poll_event([this](loop::PollEvent*, uint64_t) {
         if (m_password_data != nullptr) {
             m_auth_thread.join();
 
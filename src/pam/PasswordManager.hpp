@@ -35,7 +35,7 @@ class PasswordManager {
 
     Loop* m_loop;
 
-    loop::PollPipe* m_auth_done_poll{};
+    loop::PollEvent* m_auth_done_poll{};
 
     std::unique_ptr<PasswordBuffer> m_password;
 
@@ -8,7 +8,7 @@
 #include <cerrno>
 #include <cstdlib>
 #include <cstring>
-#include <string>
+#include <utility>
 
 #include "util/Log.hpp"
 
@@ -17,16 +17,24 @@ struct wl_shm;
 
 namespace {
 constexpr auto k_stride = 4;
-constexpr auto k_file_prefix = "/wall-shared-";
+constexpr auto k_file_name = "wall-shared";
+constexpr auto k_fallback_dir = "/dev/shm";
 
 const wl_buffer_listener k_buffer_listener = {
     .release =
         [](void* data, wl_buffer* /* buffer */) {
             auto* buffer = static_cast<wall::Buffer*>(data);
             buffer->m_is_free = true;
+            if (buffer->m_on_release) {
+                buffer->m_on_release();
+            }
         },
 };
 
+auto is_same_size(const wall::Buffer& lhs, const wall::Buffer& rhs) -> bool {
+    return lhs.m_width == rhs.m_width && lhs.m_height == rhs.m_height && lhs.m_stride == rhs.m_stride && lhs.m_format == rhs.m_format;
+}
+
 }  // namespace
 
 wall::BufferSt::~BufferSt() {
@@ -46,33 +54,102 @@ auto wall::BufferPool::set_shm(wl_shm* shm) -> void { m_shm = shm; }
 auto wall::BufferPool::get_shm() const -> wl_shm* { return m_shm; }
 
 wall::BufferPool::~BufferPool() {
+    m_free_buffers.clear();
+
     if (m_shm != nullptr) {
         wl_shm_destroy(m_shm);
     }
 }
 
-auto wall::BufferPool::create_anonymous_file() -> int {
-    std::string temp;
-    int32_t file{};
-    auto attempts = 0U;
-    while (attempts < 10) {
-        temp = k_file_prefix + std::to_string(rand());
-        auto* tmp_file = const_cast<char*>(temp.c_str());
-
-        file = shm_open(tmp_file, O_RDWR | O_CREAT | O_EXCL, 600);
-        if (file >= 0) {
-            LOG_DEBUG("Created anonymous file: {}", tmp_file);
-            shm_unlink(tmp_file);
-            return file;
-        }
-        ++attempts;
+auto wall::BufferPool::create_anonymous_file(size_t size) -> int {
+    auto file = memfd_create(k_file_name, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (file < 0) {
+        LOG_DEBUG("memfd_create failed, error ({}): {}, falling back to O_TMPFILE", errno, strerror(errno));
+        auto* runtime_dir = std::getenv("XDG_RUNTIME_DIR");
+        file = open(runtime_dir != nullptr ? runtime_dir : k_fallback_dir, O_TMPFILE | O_RDWR | O_EXCL | O_CLOEXEC, 0600);
     }
 
-    LOG_ERROR("Failed to create anonymous file {}, error ({}): {}", file, errno, strerror(errno));
+    if (file < 0) {
+        LOG_ERROR("Failed to create anonymous file, error ({}): {}", errno, strerror(errno));
+        return -1;
+    }
+
+    if (ftruncate(file, static_cast<off_t>(size)) < 0) {
+        LOG_ERROR("Failed to resize anonymous file to {}, error ({}): {}", size, errno, strerror(errno));
+        close(file);
+        return -1;
+    }
+
+    // the compositor maps the file too, sealing the size means neither side can shrink it under the other. This only works for
+    // memfd, the O_TMPFILE fallback is used unsealed.
+    if (fcntl(file, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0) {
+        LOG_DEBUG("Failed to seal anonymous file, error ({}): {}", errno, strerror(errno));
+    }
 
     return file;
 }
 
+auto wall::BufferPool::acquire_buffer(int32_t width, int32_t height, int32_t stride, uint32_t fmt) -> std::unique_ptr<Buffer> {
+    // search newest first, recently released buffers are the most likely to be free already
+    for (auto iter = m_free_buffers.rbegin(); iter != m_free_buffers.rend(); ++iter) {
+        auto& free_buffer = *iter;
+        if (free_buffer->m_is_free && free_buffer->m_width == width && free_buffer->m_height == height && free_buffer->m_stride == stride &&
+            free_buffer->m_format == fmt) {
+            auto buffer = std::move(free_buffer);
+            m_free_buffers.erase(std::next(iter).base());
+            m_free_bytes -= buffer->m_size;
+            return buffer;
+        }
+    }
+
+    auto buffer = create_buffer(width, height, stride, fmt);
+    if (buffer != nullptr) {
+        buffer->m_width = width;
+        buffer->m_height = height;
+        buffer->m_stride = stride;
+        buffer->m_format = fmt;
+    }
+
+    return buffer;
+}
+
+auto wall::BufferPool::release_buffer(std::unique_ptr<Buffer> buffer) -> void {
+    if (buffer == nullptr) {
+        return;
+    }
+
+    buffer->m_on_release = nullptr;
+
+    // make room for the buffer in its size class by dropping the oldest buffer of the same size
+    auto oldest_same_size = m_free_buffers.end();
+    auto same_size_count = 0UL;
+    for (auto iter = m_free_buffers.begin(); iter != m_free_buffers.end(); ++iter) {
+        if (is_same_size(**iter, *buffer)) {
+            if (same_size_count == 0) {
+                oldest_same_size = iter;
+            }
+            same_size_count++;
+        }
+    }
+
+    if (same_size_count >= k_max_free_buffers_per_size) {
+        m_free_bytes -= (*oldest_same_size)->m_size;
+        m_free_buffers.erase(oldest_same_size);
+    }
+
+    m_free_bytes += buffer->m_size;
+    m_free_buffers.push_back(std::move(buffer));
+
+    while (m_free_bytes > k_max_free_bytes) {
+        m_free_bytes -= m_free_buffers.front()->m_size;
+        m_free_buffers.erase(m_free_buffers.begin());
+    }
+}
+
+auto wall::BufferPool::get_free_buffer_count() const -> size_t { return m_free_buffers.size(); }
+
+auto wall::BufferPool::get_free_buffer_bytes() const -> size_t { return m_free_bytes; }
+
 auto wall::BufferPool::create_buffer(int32_t width, int32_t height, int32_t stride, uint32_t fmt) -> std::unique_ptr<Buffer> {
     if (m_shm == nullptr) {
         return nullptr;
@@ -82,18 +159,20 @@ auto wall::BufferPool::create_buffer(int32_t width, int32_t height, int32_t stri
     auto buffer = std::make_unique<Buffer>();
 
     if (size > 0) {
-        const auto shm_file = create_anonymous_file();
+        const auto shm_file = create_anonymous_file(size);
         if (shm_file == -1) {
             return nullptr;
         }
 
-        if (ftruncate(shm_file, size) < 0) {
+        auto* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_file, 0);
+        if (data == MAP_FAILED) {
+            LOG_ERROR("Failed to map buffer of size {}, error ({}): {}", size, errno, strerror(errno));
             close(shm_file);
             return nullptr;
         }
 
         buffer->m_size = size;
-        buffer->m_data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_file, 0);
+        buffer->m_data = data;
         auto* pool = wl_shm_create_pool(m_shm, shm_file, size);
         buffer->m_buffer = wl_shm_pool_create_buffer(pool, 0, width, height, width * stride, fmt);
         wl_buffer_add_listener(buffer->m_buffer, &k_buffer_listener, buffer.get());
@@ -1,15 +1,25 @@
 #pragma once
 
 #include <wayland-client-protocol.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <vector>
 
 namespace wall {
 
 struct BufferSt {
     size_t m_size{};        // NOLINT
     wl_buffer* m_buffer{};  // NOLINT
-    bool m_is_free{false};  // NOLINT
+    bool m_is_free{true};   // NOLINT, false from attach until the compositor releases the buffer
     void* m_data{};         // NOLINT
+    int32_t m_width{};      // NOLINT
+    int32_t m_height{};     // NOLINT
+    int32_t m_stride{};     // NOLINT
+    uint32_t m_format{};    // NOLINT
+
+    std::function<void()> m_on_release;  // NOLINT, called after the compositor releases the buffer
 
     BufferSt() = default;
 
@@ -35,6 +45,17 @@ class BufferPool {
     BufferPool(const BufferPool& other) = delete;
     auto operator=(const BufferPool& other) -> BufferPool& = delete;
 
+    // Returns a released buffer of the same size and format from the free list, only creates a new buffer if there is none
+    auto acquire_buffer(int32_t width, int32_t height, int32_t stride, uint32_t fmt) -> std::unique_ptr<Buffer>;
+
+    // Gives a buffer back to the pool, it is reused once the compositor has released it. The oldest free buffers are destroyed when
+    // a size has more than k_max_free_buffers_per_size of them or all of them take more than k_max_free_bytes.
+    auto release_buffer(std::unique_ptr<Buffer> buffer) -> void;
+
+    [[nodiscard]] auto get_free_buffer_count() const -> size_t;
+
+    [[nodiscard]] auto get_free_buffer_bytes() const -> size_t;
+
     virtual auto create_buffer(int32_t width, int32_t height, int32_t stride, uint32_t fmt) -> std::unique_ptr<Buffer>;
 
     auto set_shm(wl_shm* shm) -> void;
@@ -42,9 +63,19 @@ class BufferPool {
     [[nodiscard]] auto get_shm() const -> wl_shm*;
 
    protected:
-    static auto create_anonymous_file() -> int;
+    // Returns a sealed memfd of the given size, or an unnamed O_TMPFILE file when memfd is not available
+    static auto create_anonymous_file(size_t size) -> int;
 
    private:
+    static constexpr size_t k_max_free_buffers_per_size = 3;
+
+    static constexpr size_t k_max_free_bytes = 32UL * 1024UL * 1024UL;
+
     wl_shm* m_shm{};
+
+    // Oldest first
+    std::vector<std::unique_ptr<Buffer>> m_free_buffers;
+
+    size_t m_free_bytes{0UL};
 };
 }  // namespace wall
@@ -0,0 +1,94 @@
+#include "registry/FontRegistry.hpp"
+
+#include <cairo-ft.h>
+#include <fontconfig/fontconfig.h>
+#include <spdlog/common.h>
+#include <string>
+
+#include "util/Log.hpp"
+
+wall::FontRegistry::~FontRegistry() {
+    // the faces have to go before fontconfig
+    m_font_faces.clear();
+
+    if (m_is_fontconfig_initialized) {
+        FcFini();
+    }
+}
+
+auto wall::FontRegistry::acquire_font_face(std::string_view font) -> cairo_font_face_t* {
+    return m_font_faces.acquire(std::string{font}, [this](const std::string& key) { return load_font_face(key); });
+}
+
+auto wall::FontRegistry::release_font_face(cairo_font_face_t* font_face) -> void {
+    if (font_face != nullptr && !m_font_faces.release(font_face)) {
+        LOG_ERROR("Released a font face that is not in use");
+    }
+}
+
+auto wall::FontRegistry::get_font_face_count() const -> size_t { return m_font_faces.get_size(); }
+
+/*
+ * This is taken from i3lock and modified to fit our needs.
+ *
+ * Returns the cairo_font_face_t for sans-serif
+ * if this thing returns NULL, then we're somehow on a system without a
+ * sans-serif font, or a system without fontconfig (but with cairo somehow)
+ */
+auto wall::FontRegistry::load_font_face(std::string_view font) -> cairo_font_face_t* {
+    FcResult result;
+
+    /*
+     * Loads the default config once, it is kept until the registry is destroyed
+     */
+    if (!m_is_fontconfig_initialized) {
+        if (FcInit() == FcFalse) {
+            LOG_DEBUG("Fontconfig init failed. No text will be shown.");
+            return nullptr;
+        }
+        m_is_fontconfig_initialized = true;
+    }
+
+    /*
+     * converts a font face name to a pattern for that face name
+     */
+    const auto font_name = std::string{font};
+    auto* pattern = FcNameParse((const unsigned char*)font_name.c_str());
+    if (pattern == nullptr) {
+        LOG_DEBUG("no sans-serif font available");
+        return nullptr;
+    }
+
+    /*
+     * Gets the default font for our pattern. (Gets the default sans-serif font face)
+     * Without these two calls, the FcFontMatch call will fail due to FcConfigGetCurrent()
+     * not giving it a valid/useful config.
+     */
+    FcDefaultSubstitute(pattern);
+    if (FcConfigSubstitute(FcConfigGetCurrent(), pattern, FcMatchPattern) == FcFalse) {
+        LOG_DEBUG("config sub failed?");
+        FcPatternDestroy(pattern);
+        return nullptr;
+    }
+
+    /*
+     * Looks up the font pattern and does some internal RenderPrepare work,
+     * then returns the resulting pattern that's ready for rendering.
+     */
+    auto* pattern_ready = FcFontMatch(FcConfigGetCurrent(), pattern, &result);
+
+    FcPatternDestroy(pattern);
+    pattern = nullptr;
+    if (pattern_ready == nullptr) {
+        LOG_DEBUG("no sans-serif font available\n");
+        return nullptr;
+    }
+
+    /*
+     * Passes the given pattern into cairo, which loads it into a cairo freetype font face.
+     */
+    auto* face = cairo_ft_font_face_create_for_pattern(pattern_ready);
+    FcPatternDestroy(pattern_ready);
+
+    return face;
+}
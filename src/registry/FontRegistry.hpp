@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cairo.h>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "registry/RefCountedCache.hpp"
+
+namespace wall {
+
+// Font faces shared by all overlays. Matching a font with fontconfig and opening it with FreeType is only done the first time a font is
+// used, and fontconfig stays initialized for as long as the registry lives.
+class FontRegistry {
+   public:
+    explicit FontRegistry() = default;
+    virtual ~FontRegistry();
+
+    FontRegistry(FontRegistry&& other) = delete;
+    auto operator=(FontRegistry&& other) -> FontRegistry& = delete;
+
+    FontRegistry(const FontRegistry& other) = delete;
+    auto operator=(const FontRegistry& other) -> FontRegistry& = delete;
+
+    // Returns the face for a fontconfig pattern like "sans-serif" or "FiraCode:bold", null if no font could be loaded. Every face returned
+    // has to be given back with release_font_face.
+    [[nodiscard]] auto acquire_font_face(std::string_view font) -> cairo_font_face_t*;
+
+    // Faces nobody uses anymore are kept, only the oldest k_max_unused_font_faces of them are destroyed
+    auto release_font_face(cairo_font_face_t* font_face) -> void;
+
+    [[nodiscard]] auto get_font_face_count() const -> size_t;
+
+   protected:
+    [[nodiscard]] virtual auto load_font_face(std::string_view font) -> cairo_font_face_t*;
+
+   private:
+    static constexpr size_t k_max_unused_font_faces = 4;
+
+    RefCountedCache<std::string, cairo_font_face_t*> m_font_faces{k_max_unused_font_faces, cairo_font_face_destroy};
+
+    bool m_is_fontconfig_initialized{false};
+};
+}  // namespace wall
@@ -0,0 +1,172 @@
+#include "registry/ImageRegistry.hpp"
+
+#include <gdk-pixbuf/gdk-pixbuf-core.h>
+#include <glib-object.h>
+#include <spdlog/common.h>
+#include <algorithm>
+#include <cmath>
+#include <system_error>
+
+#include "util/Log.hpp"
+#include "util/PixelUtils.hpp"
+
+wall::ImageRegistry::~ImageRegistry() {
+    for (auto& decoded : m_decoded_images) {
+        cairo_surface_destroy(decoded.m_surface);
+    }
+    m_decoded_images.clear();
+}
+
+auto wall::ImageRegistry::acquire_image(const std::filesystem::path& file_path, int32_t diameter, double scale) -> cairo_surface_t* {
+    if (file_path.empty() || diameter <= 0 || scale <= 0.0) {
+        return nullptr;
+    }
+
+    std::error_code error;
+    const auto modified_time = std::filesystem::last_write_time(file_path, error);
+    if (error) {
+        LOG_ERROR("Failed to load image ({}): {}", file_path.string(), error.message());
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_guard);
+    const ImageKey key{.m_file_path = file_path, .m_modified_time = modified_time, .m_diameter = diameter, .m_scale = scale};
+    return m_images.acquire(key, [this](const ImageKey& image_key) -> cairo_surface_t* {
+        auto* decoded = get_decoded_image(image_key.m_file_path, image_key.m_modified_time);
+        if (decoded == nullptr) {
+            return nullptr;
+        }
+
+        return scale_image(decoded, image_key.m_diameter, image_key.m_scale);
+    });
+}
+
+auto wall::ImageRegistry::release_image(cairo_surface_t* image) -> void {
+    if (image == nullptr) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_guard);
+    if (!m_images.release(image)) {
+        LOG_ERROR("Released an image that is not in use");
+    }
+}
+
+auto wall::ImageRegistry::get_image_count() const -> size_t {
+    std::lock_guard<std::mutex> lock(m_guard);
+    return m_images.get_size();
+}
+
+auto wall::ImageRegistry::get_decoded_image_count() const -> size_t {
+    std::lock_guard<std::mutex> lock(m_guard);
+    return m_decoded_images.size();
+}
+
+auto wall::ImageRegistry::get_decoded_image(const std::filesystem::path& file_path, std::filesystem::file_time_type modified_time)
+    -> cairo_surface_t* {
+    auto find_result = std::ranges::find_if(m_decoded_images, [&](const DecodedImage& decoded) {
+        return decoded.m_file_path == file_path && decoded.m_modified_time == modified_time;
+    });
+
+    if (find_result != m_decoded_images.end()) {
+        std::rotate(find_result, std::next(find_result), m_decoded_images.end());
+        return m_decoded_images.back().m_surface;
+    }
+
+    auto* surface = load_image(file_path);
+    if (surface == nullptr) {
+        return nullptr;
+    }
+
+    if (m_decoded_images.size() >= k_max_decoded_images) {
+        cairo_surface_destroy(m_decoded_images.front().m_surface);
+        m_decoded_images.erase(m_decoded_images.begin());
+    }
+
+    m_decoded_images.push_back(DecodedImage{.m_file_path = file_path, .m_modified_time = modified_time, .m_surface = surface});
+    return surface;
+}
+
+auto wall::ImageRegistry::load_image(const std::filesystem::path& file_path) -> cairo_surface_t* {
+    GError* err = nullptr;
+    GdkPixbuf* pixbuf = gdk_pixbuf_new_from_file(file_path.c_str(), &err);
+    if (pixbuf == nullptr) {
+        LOG_ERROR("Failed to load image ({}): {}", file_path.string(), err->message);
+        g_error_free(err);
+        return nullptr;
+    }
+
+    auto* image = buffer_to_surface(pixbuf);
+    g_object_unref(pixbuf);
+    return image;
+}
+
+/**
+ * Much of this code was taken from swaylock-effects
+ */
+auto wall::ImageRegistry::buffer_to_surface(GdkPixbuf* gdkbuf) -> cairo_surface_t* {
+    const auto chan = gdk_pixbuf_get_n_channels(gdkbuf);
+    if (chan < 3) {
+        return nullptr;
+    }
+
+    const guint8* gdkpix = gdk_pixbuf_read_pixels(gdkbuf);
+    if (gdkpix == nullptr) {
+        return nullptr;
+    }
+    const auto width = gdk_pixbuf_get_width(gdkbuf);
+    const auto height = gdk_pixbuf_get_height(gdkbuf);
+    int stride = gdk_pixbuf_get_rowstride(gdkbuf);
+
+    cairo_format_t fmt = (chan == 3) ? CAIRO_FORMAT_RGB24 : CAIRO_FORMAT_ARGB32;
+    cairo_surface_t* cairo_surface = cairo_image_surface_create(fmt, width, height);
+    if (cairo_surface_status(cairo_surface) != CAIRO_STATUS_SUCCESS) {
+        cairo_surface_destroy(cairo_surface);
+        return nullptr;
+    }
+    cairo_surface_flush(cairo_surface);
+
+    const auto cstride = cairo_image_surface_get_stride(cairo_surface);
+    unsigned char* cpix = cairo_image_surface_get_data(cairo_surface);
+
+    for (auto row = 0; row < height; row++) {
+        if (chan == 3) {
+            PixelUtils::rgb_to_xrgb(gdkpix, cpix, width);
+        } else {
+            PixelUtils::rgba_to_premultiplied_argb(gdkpix, cpix, width);
+        }
+        gdkpix += stride;
+        cpix += cstride;
+    }
+    cairo_surface_mark_dirty(cairo_surface);
+    return cairo_surface;
+}
+
+auto wall::ImageRegistry::scale_image(cairo_surface_t* decoded, int32_t diameter, double scale) -> cairo_surface_t* {
+    const auto width = cairo_image_surface_get_width(decoded);
+    const auto height = cairo_image_surface_get_height(decoded);
+    if (width <= 0 || height <= 0) {
+        return nullptr;
+    }
+
+    auto* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, diameter, diameter);
+    if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+        cairo_surface_destroy(surface);
+        return nullptr;
+    }
+
+    // the shorter side fills the diameter and the longer one is cropped evenly on both ends
+    const auto image_scale = static_cast<double>(diameter) / std::min(width, height);
+    auto* cairo = cairo_create(surface);
+    cairo_translate(cairo, (diameter - (width * image_scale)) / 2.0, (diameter - (height * image_scale)) / 2.0);
+    cairo_scale(cairo, image_scale, image_scale);
+    cairo_set_source_surface(cairo, decoded, 0.0, 0.0);
+    // the best filter averages every source pixel that falls into a target pixel when shrinking instead of sampling a few of them
+    cairo_pattern_set_filter(cairo_get_source(cairo), CAIRO_FILTER_BEST);
+    cairo_pattern_set_extend(cairo_get_source(cairo), CAIRO_EXTEND_PAD);
+    cairo_paint(cairo);
+    cairo_destroy(cairo);
+
+    cairo_surface_set_device_scale(surface, scale, scale);
+    return surface;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cairo.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <vector>
+#include "registry/RefCountedCache.hpp"
+
+namespace wall {
+
+// Images shared by all overlays, already scaled to the size they are shown at. A file is decoded once for as long as it does not change
+// on disk, and scaled once for every diameter and scale factor, so drawing it is a plain copy of its pixels. Overlays render on worker
+// threads, the registry can be used from any of them.
+class ImageRegistry {
+   public:
+    explicit ImageRegistry() = default;
+    virtual ~ImageRegistry();
+
+    ImageRegistry(ImageRegistry&& other) = delete;
+    auto operator=(ImageRegistry&& other) -> ImageRegistry& = delete;
+
+    ImageRegistry(const ImageRegistry& other) = delete;
+    auto operator=(const ImageRegistry& other) -> ImageRegistry& = delete;
+
+    // Returns a premultiplied square of diameter by diameter pixels, filled by the center of the image, with the scale factor as its
+    // device scale. Null if the image could not be loaded. Every image returned has to be given back with release_image.
+    [[nodiscard]] auto acquire_image(const std::filesystem::path& file_path, int32_t diameter, double scale) -> cairo_surface_t*;
+
+    // Like fonts, unused images are kept for a while and only the oldest k_max_unused_images of them are destroyed
+    auto release_image(cairo_surface_t* image) -> void;
+
+    [[nodiscard]] auto get_image_count() const -> size_t;
+
+    [[nodiscard]] auto get_decoded_image_count() const -> size_t;
+
+   protected:
+    // Decodes the whole file into a premultiplied surface
+    [[nodiscard]] virtual auto load_image(const std::filesystem::path& file_path) -> cairo_surface_t*;
+
+    [[nodiscard]] static auto buffer_to_surface(GdkPixbuf* gdkbuf) -> cairo_surface_t*;
+
+    [[nodiscard]] static auto scale_image(cairo_surface_t* decoded, int32_t diameter, double scale) -> cairo_surface_t*;
+
+   private:
+    struct DecodedImage {
+        std::filesystem::path m_file_path;
+        std::filesystem::file_time_type m_modified_time;
+        cairo_surface_t* m_surface{};
+    };
+
+    struct ImageKey {
+        std::filesystem::path m_file_path;
+        std::filesystem::file_time_type m_modified_time;
+        int32_t m_diameter{};
+        double m_scale{};
+
+        [[nodiscard]] auto operator==(const ImageKey& other) const -> bool = default;
+    };
+
+    static constexpr size_t k_max_unused_images = 4;
+
+    // Decoded images are only needed to scale them again, a couple of them covers switching between outputs with different scales
+    static constexpr size_t k_max_decoded_images = 2;
+
+    [[nodiscard]] auto get_decoded_image(const std::filesystem::path& file_path, std::filesystem::file_time_type modified_time)
+        -> cairo_surface_t*;
+
+    mutable std::mutex m_guard;
+
+    RefCountedCache<ImageKey, cairo_surface_t*> m_images{k_max_unused_images, cairo_surface_destroy};
+
+    // Most recently used at the back
+    std::vector<DecodedImage> m_decoded_images;
+};
+}  // namespace wall
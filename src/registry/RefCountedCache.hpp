@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace wall {
+
+// Pointers shared by reference count, loaded the first time their key is acquired. Values nobody uses anymore are kept for a while, so
+// swapping between lock and wallpaper overlays or reloading does not load them again, only the least recently released ones beyond
+// max_unused are destroyed. A key that failed to load is remembered as null and not loaded again. Not thread safe.
+template <typename Key, typename Value>
+class RefCountedCache {
+   public:
+    RefCountedCache(size_t max_unused, std::function<void(Value)> destroy) : m_max_unused{max_unused}, m_destroy{std::move(destroy)} {}
+
+    ~RefCountedCache() { clear(); }
+
+    RefCountedCache(RefCountedCache&& other) = delete;
+    auto operator=(RefCountedCache&& other) -> RefCountedCache& = delete;
+
+    RefCountedCache(const RefCountedCache& other) = delete;
+    auto operator=(const RefCountedCache& other) -> RefCountedCache& = delete;
+
+    // Returns the value of the key, loading it if it is not cached. Every value that is not null has to be given back with release.
+    [[nodiscard]] auto acquire(const Key& key, const std::function<Value(const Key&)>& load) -> Value {
+        auto find_result = std::ranges::find_if(m_entries, [&key](const Entry& entry) { return entry.m_key == key; });
+        if (find_result == m_entries.end()) {
+            m_entries.push_back(Entry{.m_key = key, .m_value = load(key)});
+            find_result = std::prev(m_entries.end());
+        }
+
+        if (find_result->m_value == nullptr) {
+            return nullptr;
+        }
+
+        find_result->m_ref_count++;
+        return find_result->m_value;
+    }
+
+    // Returns false if the value is not in use
+    auto release(Value value) -> bool {
+        auto find_result = std::ranges::find_if(m_entries, [value](const Entry& entry) { return entry.m_value == value; });
+        if (value == nullptr || find_result == m_entries.end() || find_result->m_ref_count == 0) {
+            return false;
+        }
+
+        find_result->m_ref_count--;
+        if (find_result->m_ref_count == 0) {
+            // unused entries are kept in the order they were released, oldest first
+            std::rotate(find_result, std::next(find_result), m_entries.end());
+            destroy_unused();
+        }
+        return true;
+    }
+
+    // Destroys every value, including the ones still in use
+    auto clear() -> void {
+        for (auto& entry : m_entries) {
+            if (entry.m_value != nullptr) {
+                m_destroy(entry.m_value);
+            }
+        }
+        m_entries.clear();
+    }
+
+    [[nodiscard]] auto get_size() const -> size_t { return m_entries.size(); }
+
+   private:
+    struct Entry {
+        Key m_key;
+        Value m_value{};
+        uint32_t m_ref_count{0U};
+    };
+
+    auto destroy_unused() -> void {
+        auto unused_count = std::ranges::count_if(m_entries, [](const Entry& entry) { return entry.m_ref_count == 0; });
+        for (auto iter = m_entries.begin(); iter != m_entries.end() && unused_count > static_cast<ptrdiff_t>(m_max_unused);) {
+            if (iter->m_ref_count != 0) {
+                ++iter;
+                continue;
+            }
+
+            if (iter->m_value != nullptr) {
+                m_destroy(iter->m_value);
+            }
+            iter = m_entries.erase(iter);
+            unused_count--;
+        }
+    }
+
+    size_t m_max_unused;
+
+    std::function<void(Value)> m_destroy;
+
+    std::vector<Entry> m_entries;
+};
+}  // namespace wall
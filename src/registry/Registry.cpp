@@ -1,6 +1,7 @@
 #include "registry/Registry.hpp"
 #include <wayland-client-core.h>
 #include <wayland-client-protocol.h>
+#include "conf/ConfigMacros.hpp"
 #include "display/Display.hpp"
 #include "display/Screen.hpp"
 #include "fractional-scale-v1-protocol.h"
@@ -32,6 +33,10 @@ wall::Registry::Registry(const Config& config, Display* display, Loop* loop, wl_
       m_lock_manager{std::make_unique<LockManager>(nullptr)},
       m_xdg_wm_base{std::make_unique<XdgBase>(nullptr)},
       m_buffer_pool{std::make_unique<BufferPool>()},
+      m_font_registry{std::make_unique<FontRegistry>()},
+      m_image_registry{std::make_unique<ImageRegistry>()},
+      m_overlay_worker_pool{std::make_unique<WorkerPool>(loop, wall_conf_get(config, general, overlay_render_threads))},
+      m_worker_pool{std::make_unique<WorkerPool>(loop, wall_conf_get(config, general, worker_threads))},
       m_seat{std::make_unique<Seat>(loop, nullptr)} {
     if (m_registry == nullptr) {
         LOG_ERROR("Failed to get registry");
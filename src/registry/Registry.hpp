@@ -10,12 +10,15 @@
 #include "input/Seat.hpp"
 #include "registry/BufferPool.hpp"
 #include "registry/Compositor.hpp"
+#include "registry/FontRegistry.hpp"
+#include "registry/ImageRegistry.hpp"
 #include "registry/LayerShell.hpp"
 #include "registry/Lock.hpp"
 #include "registry/LockManager.hpp"
 #include "registry/Subcompositor.hpp"
 #include "registry/XdgBase.hpp"
 #include "util/Loop.hpp"
+#include "util/WorkerPool.hpp"
 #include "viewporter-protocol.h"
 
 namespace wall {
@@ -45,6 +48,14 @@ class Registry {
 
     [[nodiscard]] virtual auto get_buffer_pool_mut() -> BufferPool* { return m_buffer_pool.get(); }
 
+    [[nodiscard]] auto get_font_registry_mut() -> FontRegistry* { return m_font_registry.get(); }
+
+    [[nodiscard]] auto get_image_registry_mut() -> ImageRegistry* { return m_image_registry.get(); }
+
+    [[nodiscard]] auto get_overlay_worker_pool_mut() -> WorkerPool* { return m_overlay_worker_pool.get(); }
+
+    [[nodiscard]] auto get_worker_pool_mut() -> WorkerPool* { return m_worker_pool.get(); }
+
     [[nodiscard]] virtual auto get_seat() const -> const Seat& { return *m_seat; }
 
     [[nodiscard]] virtual auto get_seat_mut() -> Seat* { return m_seat.get(); }
@@ -101,6 +112,16 @@ class Registry {
 
     std::unique_ptr<BufferPool> m_buffer_pool{};
 
+    // Declared before the screens so they outlive their overlays
+    std::unique_ptr<FontRegistry> m_font_registry{};
+
+    std::unique_ptr<ImageRegistry> m_image_registry{};
+
+    std::unique_ptr<WorkerPool> m_overlay_worker_pool{};
+
+    // Background work that is not drawing, such as encoding screenshots
+    std::unique_ptr<WorkerPool> m_worker_pool{};
+
     std::unique_ptr<Seat> m_seat;
 
     std::vector<std::unique_ptr<wall::Screen>> m_screens;
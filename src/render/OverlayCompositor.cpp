@@ -0,0 +1,190 @@
+#include "render/OverlayCompositor.hpp"
+
+#include <EGL/egl.h>
+#include <GL/gl.h>
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+wall::OverlayCompositor::~OverlayCompositor() {
+    std::vector<uint32_t> textures = std::move(m_unused_textures);
+    for (auto& layer : m_layers) {
+        if (layer.m_pending_buffer != nullptr) {
+            layer.m_pending_buffer->m_is_free = true;
+        }
+        if (layer.m_texture != 0U) {
+            textures.push_back(layer.m_texture);
+        }
+    }
+
+    // without a current context the textures are freed together with it
+    if (!textures.empty() && eglGetCurrentContext() != EGL_NO_CONTEXT) {
+        glDeleteTextures(static_cast<GLsizei>(textures.size()), textures.data());
+    }
+}
+
+auto wall::OverlayCompositor::set_layer(const CairoSurface* owner, Buffer* buffer, int32_t x_pos, int32_t y_pos, const CairoDamage& damage)
+    -> void {
+    auto layer = std::ranges::find_if(m_layers, [owner](const auto& other) { return other.m_owner == owner; });
+    if (layer == m_layers.end()) {
+        Layer new_layer;
+        new_layer.m_owner = owner;
+        layer = m_layers.insert(m_layers.end(), std::move(new_layer));
+    }
+
+    if (layer->m_pending_buffer != nullptr && layer->m_pending_buffer != buffer) {
+        // replaced before it was drawn, the owner draws again after presenting if it was waiting for a buffer so there is no need to
+        // notify it from here
+        layer->m_pending_buffer->m_is_free = true;
+    }
+
+    buffer->m_is_free = false;
+    layer->m_pending_buffer = buffer;
+    layer->m_x_pos = x_pos;
+    layer->m_y_pos = y_pos;
+    if (damage.is_empty()) {
+        layer->m_pending_damage.add_full();
+    } else {
+        layer->m_pending_damage.add(damage);
+    }
+}
+
+auto wall::OverlayCompositor::remove_layer(const CairoSurface* owner) -> void {
+    auto layer = std::ranges::find_if(m_layers, [owner](const auto& other) { return other.m_owner == owner; });
+    if (layer == m_layers.end()) {
+        return;
+    }
+
+    if (layer->m_pending_buffer != nullptr) {
+        layer->m_pending_buffer->m_is_free = true;
+    }
+    if (layer->m_texture != 0U) {
+        m_unused_textures.push_back(layer->m_texture);
+    }
+    m_layers.erase(layer);
+}
+
+auto wall::OverlayCompositor::get_layer_count() const -> size_t { return m_layers.size(); }
+
+auto wall::OverlayCompositor::is_layer_pending(const CairoSurface* owner) const -> bool {
+    return std::ranges::any_of(m_layers, [owner](const auto& layer) { return layer.m_owner == owner && layer.m_pending_buffer != nullptr; });
+}
+
+auto wall::OverlayCompositor::upload(Layer* layer) -> void {
+    auto* buffer = layer->m_pending_buffer;
+    if (layer->m_texture == 0U) {
+        glGenTextures(1, &layer->m_texture);
+        glBindTexture(GL_TEXTURE_2D, layer->m_texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    } else {
+        glBindTexture(GL_TEXTURE_2D, layer->m_texture);
+    }
+
+    // cairo's ARGB32 is a native endian 32 bit word, which is what BGRA with the reversed packed type reads on any endianness
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, buffer->m_width);
+    if (layer->m_texture_width != buffer->m_width || layer->m_texture_height != buffer->m_height || layer->m_pending_damage.is_full()) {
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+        glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, buffer->m_width, buffer->m_height, 0, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, buffer->m_data);
+        layer->m_texture_width = buffer->m_width;
+        layer->m_texture_height = buffer->m_height;
+    } else {
+        for (const auto& rect : layer->m_pending_damage.get_rects()) {
+            // damage is grown for antialiasing and can reach past the buffer
+            const auto x_start = std::clamp(rect.x, 0, buffer->m_width);
+            const auto y_start = std::clamp(rect.y, 0, buffer->m_height);
+            const auto x_end = std::clamp(rect.x + rect.width, 0, buffer->m_width);
+            const auto y_end = std::clamp(rect.y + rect.height, 0, buffer->m_height);
+            if (x_end <= x_start || y_end <= y_start) {
+                continue;
+            }
+
+            glPixelStorei(GL_UNPACK_SKIP_PIXELS, x_start);
+            glPixelStorei(GL_UNPACK_SKIP_ROWS, y_start);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, x_start, y_start, x_end - x_start, y_end - y_start, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV,
+                            buffer->m_data);
+        }
+    }
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+
+    layer->m_pending_damage.clear();
+    layer->m_pending_buffer = nullptr;
+    buffer->m_is_free = true;
+}
+
+auto wall::OverlayCompositor::draw(uint32_t width, uint32_t height, double scale) -> void {
+    if (!m_unused_textures.empty()) {
+        glDeleteTextures(static_cast<GLsizei>(m_unused_textures.size()), m_unused_textures.data());
+        m_unused_textures.clear();
+    }
+
+    if (m_layers.empty() || width == 0 || height == 0) {
+        return;
+    }
+
+    // release callbacks may draw the overlay again, which sets a new layer, so they only run once the layers are no longer iterated
+    std::vector<std::function<void()>> on_release;
+    for (auto& layer : m_layers) {
+        if (layer.m_pending_buffer != nullptr) {
+            if (layer.m_pending_buffer->m_on_release) {
+                on_release.push_back(layer.m_pending_buffer->m_on_release);
+            }
+            upload(&layer);
+        }
+    }
+
+    // mpv leaves its own state behind, the overlay is drawn with the fixed function pipeline in surface pixels with a top left origin
+    glViewport(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(0.0, width, height, 0.0, -1.0, 1.0);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+
+    // cairo's pixels are premultiplied
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable(GL_TEXTURE_2D);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+
+    for (const auto& layer : m_layers) {
+        if (layer.m_texture == 0U) {
+            continue;
+        }
+
+        const auto left = layer.m_x_pos * scale;
+        const auto top = layer.m_y_pos * scale;
+        const auto right = (layer.m_x_pos + layer.m_texture_width) * scale;
+        const auto bottom = (layer.m_y_pos + layer.m_texture_height) * scale;
+
+        glBindTexture(GL_TEXTURE_2D, layer.m_texture);
+        glBegin(GL_QUADS);
+        glTexCoord2d(0.0, 0.0);
+        glVertex2d(left, top);
+        glTexCoord2d(1.0, 0.0);
+        glVertex2d(right, top);
+        glTexCoord2d(1.0, 1.0);
+        glVertex2d(right, bottom);
+        glTexCoord2d(0.0, 1.0);
+        glVertex2d(left, bottom);
+        glEnd();
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+    glDisable(GL_BLEND);
+
+    for (const auto& callback : on_release) {
+        callback();
+    }
+}
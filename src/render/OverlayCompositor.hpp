@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "overlay/CairoDamage.hpp"
+#include "registry/BufferPool.hpp"
+
+namespace wall {
+class CairoSurface;
+
+// Blends the Cairo overlays into the wallpaper's EGL surface instead of showing them on their own subsurfaces. It takes the place of
+// the compositor for the overlay buffers: a buffer stays in use from set_layer until draw has uploaded it into the layer's texture.
+class OverlayCompositor {
+   public:
+    OverlayCompositor() = default;
+    ~OverlayCompositor();
+
+    OverlayCompositor(const OverlayCompositor&) = delete;
+    auto operator=(const OverlayCompositor&) -> OverlayCompositor& = delete;
+    OverlayCompositor(OverlayCompositor&&) = delete;
+    auto operator=(OverlayCompositor&&) -> OverlayCompositor& = delete;
+
+    // Shows the buffer at the given position in surface coordinates on the next draw. Damage is relative to the last buffer set for the
+    // owner, only the damaged areas are uploaded. Layers are stacked in the order their owners first set one.
+    auto set_layer(const CairoSurface* owner, Buffer* buffer, int32_t x_pos, int32_t y_pos, const CairoDamage& damage) -> void;
+
+    auto remove_layer(const CairoSurface* owner) -> void;
+
+    [[nodiscard]] auto get_layer_count() const -> size_t;
+
+    // True if the owner set a buffer that has not been drawn yet
+    [[nodiscard]] auto is_layer_pending(const CairoSurface* owner) const -> bool;
+
+    // Uploads the pending buffers and blends the layers over the current framebuffer, the EGL context has to be current. Width and
+    // height are the framebuffer size in pixels, scale converts surface coordinates to pixels.
+    auto draw(uint32_t width, uint32_t height, double scale) -> void;
+
+   private:
+    struct Layer {
+        const CairoSurface* m_owner{};
+
+        uint32_t m_texture{0U};
+
+        int32_t m_texture_width{0};
+
+        int32_t m_texture_height{0};
+
+        int32_t m_x_pos{0};
+
+        int32_t m_y_pos{0};
+
+        // Set but not uploaded yet
+        Buffer* m_pending_buffer{};
+
+        // Everything that changed since the texture was last uploaded
+        CairoDamage m_pending_damage;
+    };
+
+    static auto upload(Layer* layer) -> void;
+
+    std::vector<Layer> m_layers;
+
+    // Textures of removed layers, deleted on the next draw while the context is current
+    std::vector<uint32_t> m_unused_textures;
+};
+}  // namespace wall
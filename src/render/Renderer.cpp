@@ -24,6 +24,9 @@ const wl_callback_listener wall::Renderer::k_frame_listener = {
                 callback_data->m_renderer->m_last_callback = nullptr;
                 callback_data->m_renderer->set_has_buffer(true);
                 callback_data->m_renderer->render(callback_data->m_surface);
+
+                // overlays that were held back for a frame that did not need rendering after all
+                callback_data->m_surface->draw_overlay();
             } else {
                 // happens when the callback is destroyed before it is called
                 LOG_DEBUG("Callback data is invalid");
@@ -75,12 +78,17 @@ auto wall::Renderer::is_recreate_egl_surface() const -> bool { return m_is_recre
 
 auto wall::Renderer::set_is_recreate_egl_surface(bool is_recreate_egl_surface) -> void { m_is_recreate_egl_surface = is_recreate_egl_surface; }
 
+auto wall::Renderer::is_frame_callback_overdue(std::chrono::steady_clock::time_point now, std::chrono::milliseconds threshold) const -> bool {
+    return m_last_callback != nullptr && now - m_last_callback_time >= threshold;
+}
+
 auto wall::Renderer::setup_next_frame_callback(Surface* surface) -> void {
     if (m_last_callback != nullptr) {
         return;
     }
     // Callback new frame
     m_last_callback = wl_surface_frame(surface->get_wl_surface());
+    m_last_callback_time = std::chrono::steady_clock::now();
 
     static auto frame_number = 0UL;
     auto* callback_data = new FrameCallbackData{surface, this, true, this, frame_number++};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <wayland-client.h>
+#include <chrono>
 #include <memory>
 #include "conf/Config.hpp"
 #include "mpv/MpvResourceConfig.hpp"
@@ -48,6 +49,9 @@ class Renderer : public std::enable_shared_from_this<Renderer> {
 
     auto set_is_recreate_egl_surface(bool is_recreate_egl_surface) -> void;
 
+    // Compositors stop sending frame callbacks to surfaces nobody can see, so one that is still waiting after the threshold is hidden
+    [[nodiscard]] auto is_frame_callback_overdue(std::chrono::steady_clock::time_point now, std::chrono::milliseconds threshold) const -> bool;
+
    protected:
     [[nodiscard]] auto get_config() const -> const Config&;
 
@@ -77,6 +81,7 @@ class Renderer : public std::enable_shared_from_this<Renderer> {
     std::unique_ptr<SurfaceEGL> m_egl_surface{};
 
     struct wl_callback* m_last_callback{};
+    std::chrono::steady_clock::time_point m_last_callback_time{};
     struct FrameCallbackData* m_last_callback_data{};
 };
 }  // namespace wall
@@ -10,6 +10,7 @@
 
 #include "display/Display.hpp"
 #include "mpv/MpvResource.hpp"
+#include "mpv/MpvResourceConfig.hpp"
 #include "render/RendererEGL.hpp"
 #include "render/RendererMpv.hpp"
 #include "surface/Surface.hpp"
@@ -130,6 +131,18 @@ auto wall::RendererCreator::create_mpv_renderer(Surface* surface) const -> void
     auto surface_egl = create_egl_surface(surface->get_wl_surface(), surface->get_width(), surface->get_height());
     make_current(*surface_egl);
 
+    auto* primary_state = m_display->get_primary_state_mut();
+    auto& shared_resource =
+        surface->get_resource_mode() == ResourceMode::Lock ? primary_state->m_lock_shared_resource : primary_state->m_wallpaper_shared_resource;
+    const auto is_share_decode = MpvResourceConfig::build_config(get_config(), surface->get_resource_mode()).m_is_share_decode;
+
+    if (surface->get_mpv_resource() == nullptr && is_share_decode) {
+        if (auto resource = shared_resource.lock(); resource != nullptr) {
+            LOG_DEBUG("Sharing mpv resource with surface {}", surface->get_output_name());
+            surface->set_mpv_resource(std::move(resource));
+        }
+    }
+
     if (surface->get_mpv_resource() == nullptr) {
         LOG_DEBUG("Creating mpv resource for surface {}", surface->get_output_name());
         surface->set_mpv_resource(std::make_shared<MpvResource>(get_config(), m_display, surface));
@@ -145,6 +158,9 @@ auto wall::RendererCreator::create_mpv_renderer(Surface* surface) const -> void
 
     auto renderer = std::make_shared<RendererMpv>(get_config(), m_display, m_egl_display, m_egl_context, std::move(surface_egl));
     surface->set_renderer(std::move(renderer));
-    surface->get_mpv_resource()->set_surface(surface);
+    surface->get_mpv_resource()->add_surface(surface);
+    if (is_share_decode && shared_resource.expired()) {
+        shared_resource = surface->share_mpv_resource();
+    }
     surface->get_mpv_resource()->play();
 }
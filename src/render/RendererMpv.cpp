@@ -5,6 +5,8 @@
 #include <wayland-client-protocol.h>
 #include <array>
 #include "display/Display.hpp"
+#include "render/OverlayCompositor.hpp"
+#include "render/SharedFrame.hpp"
 #include "surface/Surface.hpp"
 #include "surface/SurfaceEGL.hpp"
 
@@ -65,15 +67,37 @@ auto wall::RendererMpv::render(Surface* surface) -> void {
             return;
         }
 
-        // Render frame
-        auto err_code = mpv_render_context_render(resource->get_mpv_context(), render_params.data());
-        if (err_code < 0) {
-            LOG_ERROR("Couldn't render frame: {} for {}", err_code, surface->get_output_name());
-            return;
+        // Render frame, mirrored outputs scale the frame decoded for all of them
+        auto err_code = 0;
+        if (resource->is_shared()) {
+            const auto* frame = resource->render_shared_frame();
+            if (frame == nullptr) {
+                LOG_ERROR("Couldn't render shared frame for {}", surface->get_output_name());
+                return;
+            }
+            frame->draw(fbo_params.w, fbo_params.h, resource->get_resource_config().m_fit_mode);
+        } else {
+            err_code = mpv_render_context_render(resource->get_mpv_context(), render_params.data());
+            if (err_code < 0) {
+                LOG_ERROR("Couldn't render frame: {} for {}", err_code, surface->get_output_name());
+                return;
+            }
         }
 
         setup_next_frame_callback(surface);
         set_is_dirty(false);
+
+        // overlays that are due go out with this frame, the swap commits them together with the video
+        surface->set_is_presenting(true);
+        surface->draw_overlay();
+        surface->set_is_presenting(false);
+
+        // after clearing the dirty flag, an overlay that draws again once its buffer is uploaded asks for the next frame
+        if (surface->get_overlay_compositor_mut() != nullptr) {
+            surface->get_overlay_compositor_mut()->draw(surface->get_width(), surface->get_height(),
+                                                         static_cast<double>(surface->get_fractional_scale()) / 120.0);
+        }
+
         err_code = eglGetError();
         if (err_code != EGL_SUCCESS) {
             LOG_ERROR("Error after rendering: {}", err_code);
@@ -84,7 +108,5 @@ auto wall::RendererMpv::render(Surface* surface) -> void {
             set_is_recreate_egl_surface(true);
             return;
         }
-
-        surface->draw_overlay();
     }
 }
@@ -0,0 +1,211 @@
+#include "render/SharedFrame.hpp"
+
+#include <EGL/egl.h>
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <mpv/render_gl.h>
+#include <spdlog/common.h>
+#include <array>
+
+#include "util/Log.hpp"
+
+namespace {
+// framebuffer objects are not part of the GL 1.x api the headers declare, they are looked up like mpv looks up its functions
+struct FramebufferFunctions {
+    PFNGLGENFRAMEBUFFERSPROC m_gen{};
+    PFNGLDELETEFRAMEBUFFERSPROC m_delete{};
+    PFNGLBINDFRAMEBUFFERPROC m_bind{};
+    PFNGLFRAMEBUFFERTEXTURE2DPROC m_texture_2d{};
+    PFNGLCHECKFRAMEBUFFERSTATUSPROC m_check_status{};
+
+    [[nodiscard]] auto is_valid() const -> bool {
+        return m_gen != nullptr && m_delete != nullptr && m_bind != nullptr && m_texture_2d != nullptr && m_check_status != nullptr;
+    }
+};
+
+auto get_framebuffer_functions() -> const FramebufferFunctions& {
+    static const auto functions = FramebufferFunctions{
+        .m_gen = reinterpret_cast<PFNGLGENFRAMEBUFFERSPROC>(eglGetProcAddress("glGenFramebuffers")),                     // NOLINT
+        .m_delete = reinterpret_cast<PFNGLDELETEFRAMEBUFFERSPROC>(eglGetProcAddress("glDeleteFramebuffers")),            // NOLINT
+        .m_bind = reinterpret_cast<PFNGLBINDFRAMEBUFFERPROC>(eglGetProcAddress("glBindFramebuffer")),                    // NOLINT
+        .m_texture_2d = reinterpret_cast<PFNGLFRAMEBUFFERTEXTURE2DPROC>(eglGetProcAddress("glFramebufferTexture2D")),    // NOLINT
+        .m_check_status = reinterpret_cast<PFNGLCHECKFRAMEBUFFERSTATUSPROC>(eglGetProcAddress("glCheckFramebufferStatus")),  // NOLINT
+    };
+    return functions;
+}
+}  // namespace
+
+wall::SharedFrame::~SharedFrame() {
+    // without a current context the objects are freed together with it
+    if (eglGetCurrentContext() != EGL_NO_CONTEXT) {
+        destroy();
+    }
+}
+
+auto wall::SharedFrame::is_rendered() const -> bool { return m_is_rendered; }
+
+auto wall::SharedFrame::get_width() const -> int32_t { return m_width; }
+
+auto wall::SharedFrame::get_height() const -> int32_t { return m_height; }
+
+auto wall::SharedFrame::create(int32_t width, int32_t height) -> bool {
+    const auto& functions = get_framebuffer_functions();
+    if (!functions.is_valid()) {
+        LOG_ERROR("Framebuffer objects are not supported");
+        return false;
+    }
+
+    destroy();
+
+    glGenTextures(1, &m_texture);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    functions.m_gen(1, &m_framebuffer);
+    functions.m_bind(GL_FRAMEBUFFER, m_framebuffer);
+    functions.m_texture_2d(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture, 0);
+    const auto status = functions.m_check_status(GL_FRAMEBUFFER);
+    functions.m_bind(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        LOG_ERROR("Shared frame framebuffer is incomplete: {}", status);
+        destroy();
+        return false;
+    }
+
+    m_width = width;
+    m_height = height;
+    return true;
+}
+
+auto wall::SharedFrame::destroy() -> void {
+    if (m_framebuffer != 0U) {
+        get_framebuffer_functions().m_delete(1, &m_framebuffer);
+        m_framebuffer = 0U;
+    }
+
+    if (m_texture != 0U) {
+        glDeleteTextures(1, &m_texture);
+        m_texture = 0U;
+    }
+
+    m_width = 0;
+    m_height = 0;
+    m_is_rendered = false;
+}
+
+auto wall::SharedFrame::render(mpv_render_context* mpv_context, int32_t width, int32_t height) -> bool {
+    if (mpv_context == nullptr || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    if ((m_framebuffer == 0U || m_width != width || m_height != height) && !create(width, height)) {
+        return false;
+    }
+
+    mpv_opengl_fbo fbo_params = {.fbo = static_cast<int32_t>(m_framebuffer), .w = width, .h = height, .internal_format = GL_RGBA8};
+
+    // the texture is sampled with a top left origin like the overlays, so unlike the default framebuffer it is not flipped
+    auto zero = 0;
+    std::array<mpv_render_param, 4> render_params = {mpv_render_param{MPV_RENDER_PARAM_OPENGL_FBO, &fbo_params},
+                                                     mpv_render_param{MPV_RENDER_PARAM_FLIP_Y, &zero},
+                                                     mpv_render_param{MPV_RENDER_PARAM_BLOCK_FOR_TARGET_TIME, &zero},
+                                                     mpv_render_param{MPV_RENDER_PARAM_INVALID, nullptr}};
+
+    const auto err_code = mpv_render_context_render(mpv_context, render_params.data());
+    get_framebuffer_functions().m_bind(GL_FRAMEBUFFER, 0);
+    if (err_code < 0) {
+        LOG_ERROR("Couldn't render shared frame: {}", err_code);
+        return false;
+    }
+
+    m_is_rendered = true;
+    return true;
+}
+
+auto wall::SharedFrame::get_bounds(int32_t frame_width, int32_t frame_height, int32_t width, int32_t height, FitMode fit_mode) -> Bounds {
+    Bounds bounds;
+    if (frame_width <= 0 || frame_height <= 0 || width <= 0 || height <= 0) {
+        return bounds;
+    }
+
+    // compared by cross multiplying, so outputs with the same aspect ratio get an exact copy
+    const auto frame_area = static_cast<int64_t>(frame_width) * height;
+    const auto target_area = static_cast<int64_t>(width) * frame_height;
+    if (frame_area == target_area) {
+        return bounds;
+    }
+
+    const auto is_frame_wider = frame_area > target_area;
+    const auto ratio = is_frame_wider ? static_cast<double>(target_area) / frame_area : static_cast<double>(frame_area) / target_area;
+    const auto start = (1.0 - ratio) / 2.0;
+    const auto end = start + ratio;
+
+    // mpv leaves the frame as it is without a fit mode, which shows all of it like fit
+    if (fit_mode == FitMode::Fill) {
+        if (is_frame_wider) {
+            bounds.m_frame_left = start;
+            bounds.m_frame_right = end;
+        } else {
+            bounds.m_frame_top = start;
+            bounds.m_frame_bottom = end;
+        }
+    } else {
+        if (is_frame_wider) {
+            bounds.m_target_top = start;
+            bounds.m_target_bottom = end;
+        } else {
+            bounds.m_target_left = start;
+            bounds.m_target_right = end;
+        }
+    }
+
+    return bounds;
+}
+
+auto wall::SharedFrame::draw(int32_t width, int32_t height, FitMode fit_mode) const -> void {
+    glViewport(0, 0, width, height);
+    glClearColor(0.0F, 0.0F, 0.0F, 1.0F);
+    glClear(GL_COLOR_BUFFER_BIT);
+    if (!m_is_rendered || width <= 0 || height <= 0) {
+        return;
+    }
+
+    // mpv leaves its own state behind, the frame is drawn with the fixed function pipeline in surface pixels with a top left origin
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_BLEND);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(0.0, width, height, 0.0, -1.0, 1.0);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    glEnable(GL_TEXTURE_2D);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+
+    const auto bounds = get_bounds(m_width, m_height, width, height, fit_mode);
+    const auto left = bounds.m_target_left * width;
+    const auto top = bounds.m_target_top * height;
+    const auto right = bounds.m_target_right * width;
+    const auto bottom = bounds.m_target_bottom * height;
+
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glBegin(GL_QUADS);
+    glTexCoord2d(bounds.m_frame_left, bounds.m_frame_top);
+    glVertex2d(left, top);
+    glTexCoord2d(bounds.m_frame_right, bounds.m_frame_top);
+    glVertex2d(right, top);
+    glTexCoord2d(bounds.m_frame_right, bounds.m_frame_bottom);
+    glVertex2d(right, bottom);
+    glTexCoord2d(bounds.m_frame_left, bounds.m_frame_bottom);
+    glVertex2d(left, bottom);
+    glEnd();
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+}
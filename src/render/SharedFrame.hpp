@@ -0,0 +1,66 @@
+#pragma once
+
+#include <mpv/render.h>
+#include <cstdint>
+#include "mpv/MpvResourceConfig.hpp"
+
+namespace wall {
+
+// A video frame rendered once into a texture and then scaled into the EGL surface of every output showing it. The texture has the
+// source's aspect ratio, each output applies the fit mode when drawing it. All surfaces share one EGL context, so the texture can be
+// drawn into any of them. The context has to be current when it is used and destroyed.
+class SharedFrame {
+   public:
+    SharedFrame() = default;
+    ~SharedFrame();
+
+    SharedFrame(const SharedFrame&) = delete;
+    auto operator=(const SharedFrame&) -> SharedFrame& = delete;
+    SharedFrame(SharedFrame&&) = delete;
+    auto operator=(SharedFrame&&) -> SharedFrame& = delete;
+
+    // Renders mpv's current frame into the texture, resized to the given size in pixels. Leaves the default framebuffer bound.
+    [[nodiscard]] auto render(mpv_render_context* mpv_context, int32_t width, int32_t height) -> bool;
+
+    // Scales the texture into the bound framebuffer of the given size, cropped or with black bars when the aspect ratios differ
+    auto draw(int32_t width, int32_t height, FitMode fit_mode) const -> void;
+
+    [[nodiscard]] auto is_rendered() const -> bool;
+
+    [[nodiscard]] auto get_width() const -> int32_t;
+
+    [[nodiscard]] auto get_height() const -> int32_t;
+
+    // Part of the frame and of the target the frame is drawn into, as fractions of their size
+    struct Bounds {
+        double m_frame_left{0.0};
+        double m_frame_top{0.0};
+        double m_frame_right{1.0};
+        double m_frame_bottom{1.0};
+
+        double m_target_left{0.0};
+        double m_target_top{0.0};
+        double m_target_right{1.0};
+        double m_target_bottom{1.0};
+    };
+
+    // Fill crops the frame to the target's aspect ratio, fit keeps all of it and centers it
+    [[nodiscard]] static auto get_bounds(int32_t frame_width, int32_t frame_height, int32_t width, int32_t height, FitMode fit_mode)
+        -> Bounds;
+
+   private:
+    [[nodiscard]] auto create(int32_t width, int32_t height) -> bool;
+
+    auto destroy() -> void;
+
+    uint32_t m_framebuffer{0U};
+
+    uint32_t m_texture{0U};
+
+    int32_t m_width{0};
+
+    int32_t m_height{0};
+
+    bool m_is_rendered{false};
+};
+}  // namespace wall
@@ -5,12 +5,14 @@
 #include <cmath>
 #include <memory>
 #include <utility>
+#include "conf/ConfigMacros.hpp"
 #include "display/Display.hpp"
 #include "fractional-scale-v1-protocol.h"
 #include "mpv/MpvResource.hpp"
 #include "overlay/CairoBarSurface.hpp"
 #include "overlay/CairoIndicatorSurface.hpp"
 #include "registry/Registry.hpp"
+#include "render/OverlayCompositor.hpp"
 #include "render/Renderer.hpp"
 #include "util/Log.hpp"
 #include "viewporter-protocol.h"
@@ -62,6 +64,11 @@ auto wall::Surface::update_settings() -> void {
     if (m_bar != nullptr) {
         m_bar->update_settings();
     }
+
+    // the overlays only redraw on their own once something changes, show the new settings right away
+    if (is_configured()) {
+        draw_overlay();
+    }
 }
 
 auto wall::Surface::set_fractional_scale(uint32_t scale) -> void {
@@ -86,6 +93,8 @@ auto wall::Surface::set_fractional_scale(uint32_t scale) -> void {
 
 auto wall::Surface::get_fractional_scale() const -> uint32_t { return m_fractional_scale; }
 
+auto wall::Surface::get_overlay_compositor_mut() -> OverlayCompositor* { return m_overlay_compositor.get(); }
+
 auto wall::Surface::get_mpv_resource() const -> MpvResource* { return m_mpv_resource.get(); }
 
 auto wall::Surface::share_mpv_resource() -> std::shared_ptr<MpvResource> { return m_mpv_resource; }
@@ -118,7 +127,8 @@ auto wall::Surface::is_failed() const -> bool { return m_is_failed; }
 auto wall::Surface::set_is_failed(bool failed) -> void { m_is_failed = failed; }
 
 auto wall::Surface::next() -> void {
-    if (m_mpv_resource != nullptr) {
+    // a resource shared by several outputs only advances once
+    if (m_mpv_resource != nullptr && m_mpv_resource->get_surface() == this) {
         m_mpv_resource->next();
     }
 }
@@ -170,6 +180,15 @@ auto wall::Surface::is_ready_to_draw() -> bool {
            get_renderer_mut()->get_surface_egl_mut() != nullptr;
 }
 
+auto wall::Surface::is_presenting() const -> bool { return m_is_presenting; }
+
+auto wall::Surface::set_is_presenting(bool is_presenting) -> void { m_is_presenting = is_presenting; }
+
+auto wall::Surface::is_frame_pending() -> bool {
+    return m_mpv_resource != nullptr && is_configured() && !is_failed() && get_renderer_mut() != nullptr && get_renderer_mut()->is_dirty() &&
+           get_renderer_mut()->get_surface_egl_mut() != nullptr;
+}
+
 auto wall::Surface::get_subpixel() const -> wl_output_subpixel { return m_subpixel; }
 
 auto wall::Surface::set_subpixel(wl_output_subpixel subpixel) -> void { m_subpixel = subpixel; }
@@ -224,16 +243,19 @@ auto wall::Surface::create_surface() -> void {
     m_surface = wl_compositor_create_surface(compositor);
     m_fractional_scale_obj = wp_fractional_scale_manager_v1_get_fractional_scale(m_registry->get_fractional_scale_manager(), m_surface);
     m_wp_viewport = wp_viewporter_get_viewport(m_registry->get_viewporter(), m_surface);
-    m_indicator_surface = wl_compositor_create_surface(compositor);
-    m_indicator_subsurface = wl_subcompositor_get_subsurface(subcompositor, m_indicator_surface, get_wl_surface());
-
     wp_fractional_scale_v1_add_listener(m_fractional_scale_obj, &k_fractional_scale_listener, this);
-    wl_subsurface_set_sync(m_indicator_subsurface);
 
-    m_bar_surface = wl_compositor_create_surface(compositor);
-    m_bar_subsurface = wl_subcompositor_get_subsurface(subcompositor, m_bar_surface, get_wl_surface());
+    if (wall_conf_get(get_config(), general, overlay_gl_composite)) {
+        m_overlay_compositor = std::make_unique<OverlayCompositor>();
+    } else {
+        m_indicator_surface = wl_compositor_create_surface(compositor);
+        m_indicator_subsurface = wl_subcompositor_get_subsurface(subcompositor, m_indicator_surface, get_wl_surface());
+        wl_subsurface_set_sync(m_indicator_subsurface);
 
-    wl_subsurface_set_sync(m_bar_subsurface);
+        m_bar_surface = wl_compositor_create_surface(compositor);
+        m_bar_subsurface = wl_subcompositor_get_subsurface(subcompositor, m_bar_surface, get_wl_surface());
+        wl_subsurface_set_sync(m_bar_subsurface);
+    }
 
     m_indicator = std::make_unique<CairoIndicatorSurface>(get_config(), this, get_subpixel());
     m_bar = std::make_unique<CairoBarSurface>(get_config(), this, get_subpixel());
@@ -257,6 +279,6 @@ auto wall::Surface::draw_overlay() -> void {
         return;
     }
 
-    get_indicator()->draw(m_non_scaled_width, m_non_scaled_height);
-    get_bar()->draw(m_non_scaled_width, m_non_scaled_height);
+    get_indicator()->draw_if_due(static_cast<int32_t>(m_non_scaled_width), static_cast<int32_t>(m_non_scaled_height));
+    get_bar()->draw_if_due(static_cast<int32_t>(m_non_scaled_width), static_cast<int32_t>(m_non_scaled_height));
 }
@@ -15,6 +15,7 @@
 namespace wall {
 class CairoBarSurface;
 class CairoIndicatorSurface;
+class OverlayCompositor;
 class RendererCreator;
 class MpvResource;
 class Display;
@@ -73,8 +74,17 @@ class Surface {
 
     auto set_height(uint32_t height) -> void;
 
+    // Draws the overlays that are due, see CairoSurface::draw_if_due
     virtual auto draw_overlay() -> void;
 
+    // Set while the renderer draws the overlays right before presenting, their changes are shown with that frame
+    [[nodiscard]] auto is_presenting() const -> bool;
+
+    auto set_is_presenting(bool is_presenting) -> void;
+
+    // True if the wallpaper has a new frame to present on the next frame callback
+    [[nodiscard]] auto is_frame_pending() -> bool;
+
     auto set_subpixel(wl_output_subpixel subpixel) -> void;
 
     auto on_state_change(State state) -> void;
@@ -113,6 +123,9 @@ class Surface {
 
     [[nodiscard]] auto get_fractional_scale() const -> uint32_t;
 
+    // Null unless the overlays are composited into the EGL surface, they have no subsurfaces then
+    [[nodiscard]] auto get_overlay_compositor_mut() -> OverlayCompositor*;
+
    protected:
     [[nodiscard]] auto get_config() const -> const Config&;
 
@@ -139,6 +152,8 @@ class Surface {
 
     bool m_is_failed{false};
 
+    bool m_is_presenting{false};
+
     Display* m_display{};
 
     Registry* m_registry{};
@@ -177,6 +192,9 @@ class Surface {
 
     std::shared_ptr<Renderer> m_renderer;
 
+    // Declared before the overlays, which hand their buffers to it
+    std::unique_ptr<OverlayCompositor> m_overlay_compositor{nullptr};
+
     std::unique_ptr<CairoIndicatorSurface> m_indicator{nullptr};
 
     std::unique_ptr<CairoBarSurface> m_bar{nullptr};
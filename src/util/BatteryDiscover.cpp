@@ -7,6 +7,7 @@
 #include <optional>
 
 #include "conf/ConfigMacros.hpp"
+#include "util/ClockUtils.hpp"
 #include "util/Log.hpp"
 
 namespace wall {
@@ -27,6 +28,10 @@ auto wall::BatteryDiscover::should_update(std::chrono::time_point<std::chrono::s
     return diff > m_update_interval;
 }
 
+auto wall::BatteryDiscover::get_time_to_update(std::chrono::time_point<std::chrono::system_clock> now) const -> std::chrono::milliseconds {
+    return ClockUtils::get_time_to_update(now, m_last_update, m_update_interval);
+}
+
 auto wall::BatteryDiscover::get_config() const -> const Config& { return m_config; }
 
 auto wall::BatteryDiscover::get_status(std::chrono::time_point<std::chrono::system_clock> now) -> const BatteryStatus& {
@@ -19,6 +19,9 @@ class BatteryDiscover {
 
     auto get_status(std::chrono::time_point<std::chrono::system_clock> now) -> const BatteryStatus&;
 
+    // Time until get_status reads the status again
+    [[nodiscard]] auto get_time_to_update(std::chrono::time_point<std::chrono::system_clock> now) const -> std::chrono::milliseconds;
+
    protected:
     [[nodiscard]] auto get_battery_capacity(struct udev* udev) const -> std::optional<int32_t>;
 
@@ -0,0 +1,105 @@
+#include "util/ClockUtils.hpp"
+
+#include <algorithm>
+#include <ctime>
+
+namespace {
+constexpr auto k_second = std::chrono::seconds{1};
+constexpr auto k_minute = std::chrono::seconds{60};
+constexpr auto k_hour = std::chrono::seconds{3600};
+constexpr auto k_day = std::chrono::seconds{86400};
+
+// Period of a single strftime conversion, zero for the ones printing no time
+auto get_conversion_period(char conversion) -> std::chrono::seconds {
+    switch (conversion) {
+        case 'S':
+        case 'T':
+        case 'r':
+        case 'X':
+        case 'c':
+        case 's':
+        case '+':
+            return k_second;
+        case 'M':
+        case 'R':
+            return k_minute;
+        case 'H':
+        case 'I':
+        case 'k':
+        case 'l':
+        case 'p':
+        case 'P':
+            return k_hour;
+        case '%':
+        case 'n':
+        case 't':
+            return std::chrono::seconds::zero();
+        default:
+            return k_day;
+    }
+}
+}  // namespace
+
+auto wall::ClockUtils::get_format_period(std::string_view format) -> std::chrono::seconds {
+    auto period = std::chrono::seconds::zero();
+    for (auto pos = format.find('%'); pos != std::string_view::npos && pos + 1 < format.size(); pos = format.find('%', pos)) {
+        pos++;
+
+        // skip glibc's flags, field width and the E and O modifiers
+        while (pos < format.size() && std::string_view{"_-0^#123456789EO"}.find(format.at(pos)) != std::string_view::npos) {
+            pos++;
+        }
+        if (pos >= format.size()) {
+            break;
+        }
+
+        const auto conversion_period = get_conversion_period(format.at(pos));
+        if (conversion_period.count() > 0) {
+            period = period.count() == 0 ? conversion_period : std::min(period, conversion_period);
+        }
+        pos++;
+    }
+
+    return period;
+}
+
+auto wall::ClockUtils::get_local_time(std::chrono::system_clock::time_point time) -> std::chrono::milliseconds {
+    const auto epoch_secs = std::chrono::system_clock::to_time_t(time);
+    std::tm local_time{};
+    localtime_r(&epoch_secs, &local_time);
+
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()) + std::chrono::seconds{local_time.tm_gmtoff};
+}
+
+auto wall::ClockUtils::get_time_to_next_tick(std::chrono::system_clock::time_point now, std::chrono::seconds period) -> std::chrono::milliseconds {
+    if (period.count() <= 0) {
+        return std::chrono::milliseconds::zero();
+    }
+
+    const auto period_ms = std::chrono::duration_cast<std::chrono::milliseconds>(period);
+    auto since_tick = get_local_time(now) % period_ms;
+    if (since_tick.count() < 0) {
+        since_tick += period_ms;
+    }
+
+    return period_ms - since_tick;
+}
+
+auto wall::ClockUtils::get_time_to_update(std::chrono::system_clock::time_point now,
+                                          std::chrono::system_clock::time_point last_update,
+                                          std::chrono::seconds interval) -> std::chrono::milliseconds {
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(last_update + interval - now);
+    return std::max(remaining, std::chrono::milliseconds::zero()) + std::chrono::milliseconds{1};
+}
+
+auto wall::ClockUtils::get_tick(std::chrono::system_clock::time_point time, std::chrono::seconds period) -> int64_t {
+    if (period.count() <= 0) {
+        return 0;
+    }
+
+    const auto period_ms = std::chrono::duration_cast<std::chrono::milliseconds>(period).count();
+    const auto local_ms = get_local_time(time).count();
+
+    // rounds down for times before the epoch as well
+    return (local_ms / period_ms) - ((local_ms % period_ms < 0) ? 1 : 0);
+}
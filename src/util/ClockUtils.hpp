@@ -0,0 +1,30 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace wall {
+
+// Ticks of a displayed clock. They are aligned to local time, so a clock redrawn on every tick changes together with what strftime prints.
+class ClockUtils {
+   public:
+    // Smallest unit of time a strftime format shows, zero if it shows no time at all
+    static auto get_format_period(std::string_view format) -> std::chrono::seconds;
+
+    // Time from now until the next tick, zero for a zero period
+    static auto get_time_to_next_tick(std::chrono::system_clock::time_point now, std::chrono::seconds period) -> std::chrono::milliseconds;
+
+    // Time from now until more than the interval has passed since the last update, for values that are only read again after that
+    static auto get_time_to_update(std::chrono::system_clock::time_point now,
+                                   std::chrono::system_clock::time_point last_update,
+                                   std::chrono::seconds interval) -> std::chrono::milliseconds;
+
+    // Index of the tick a time falls into, times in the same tick show the same clock
+    static auto get_tick(std::chrono::system_clock::time_point time, std::chrono::seconds period) -> int64_t;
+
+   private:
+    // Time since the epoch shifted by the local UTC offset
+    static auto get_local_time(std::chrono::system_clock::time_point time) -> std::chrono::milliseconds;
+};
+}  // namespace wall
@@ -105,6 +105,8 @@ auto wall::CommandProcessor::process(const std::string& cmd) -> void {
         m_wallock->full_reload();
     } else if (cmd_no_ws == commands::k_reload) {
         m_wallock->reload();
+    } else if (cmd_no_ws == commands::k_stats) {
+        LOG_INFO("Loop stats\n{}", m_loop->get_stats_mut()->format());
     } else {
         LOG_ERROR("Unknown command: {}", cmd);
     }
@@ -11,6 +11,7 @@ constexpr auto k_stop = "stop";
 constexpr auto k_next = "next";
 constexpr auto k_reload = "reload";
 constexpr auto k_full_reload = "full_reload";
+constexpr auto k_stats = "stats";
 }  // namespace commands
 
 class Wallock;
@@ -1,28 +1,54 @@
 #include "util/Loop.hpp"
 
 #include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
 #include <sys/socket.h>
+#include <sys/timerfd.h>
 #include <sys/un.h>
 #include <unistd.h>
-#include <atomic>
+#include <algorithm>
+#include <array>
+#include <csignal>
 #include <chrono>
 #include <filesystem>
-#include <limits>
-#include <thread>
+#include <ctime>
 #include "util/Log.hpp"
 
 namespace {
-std::atomic_uint64_t g_handle_id{1UL};
-}
+// Max number of ready events read from epoll per loop iteration, anything left over is picked up on the next iteration
+constexpr auto k_max_epoll_events = 32;
+
+constexpr auto k_pipe_read_size = 1024UL;
+
+// Handle ids keep the slot index in the lower bits and the slot's generation in the upper bits
+constexpr auto k_generation_shift = 32U;
+constexpr auto k_slot_index_mask = 0xFFFFFFFFUL;
 
-wall::loop::Handle::Handle() : m_id{g_handle_id++} {}
+// The timer queue is rebuilt once it has more stale entries than this and at least as many stale entries as live timers
+constexpr auto k_min_stale_timer_entries = 64UL;
+}  // namespace
+
+wall::loop::Handle::Handle() = default;
 
 wall::loop::Handle::~Handle() = default;
 
-auto wall::loop::Handle::close() -> void { m_is_closing = true; }
+auto wall::loop::Handle::close() -> void {
+    if (m_is_closing) {
+        return;
+    }
+
+    m_is_closing = true;
+    if (m_loop != nullptr) {
+        m_loop->on_handle_close(this);
+    }
+}
 
 auto wall::loop::Handle::is_closing() const -> bool { return m_is_closing; }
 
+auto wall::loop::Handle::get_loop() const -> Loop* { return m_loop; }
+
 auto wall::loop::Handle::get_id() const -> uint64_t { return m_id; }
 
 wall::loop::Poll::Poll(int32_t file_descriptor, int16_t trigger_events, std::function<void(Poll*, int16_t)> callback)
@@ -61,9 +87,9 @@ wall::loop::PollPipe::~PollPipe() {
 
 auto wall::loop::PollPipe::callback_wrapper(int16_t events) -> void {
     if ((events & POLLIN) != 0) {
-        std::vector<uint8_t> buffer;
-        buffer.resize(1024);
-        const auto read_bytes = ::read(get_fd(), buffer.data(), buffer.size());
+        // the buffer is kept around between reads so reading does not allocate once it has grown to full size
+        m_read_buffer.resize(k_pipe_read_size);
+        const auto read_bytes = ::read(get_fd(), m_read_buffer.data(), m_read_buffer.size());
         if (read_bytes == -1) {
             LOG_ERROR("Failed to read from pipe");
             return;
@@ -75,9 +101,9 @@ auto wall::loop::PollPipe::callback_wrapper(int16_t events) -> void {
             return;
         }
 
-        buffer.resize(read_bytes);
+        m_read_buffer.resize(read_bytes);
 
-        m_callback(this, buffer);
+        m_callback(this, m_read_buffer);
     } else {
         LOG_ERROR("Invalid events for pipe {}", events);
     }
@@ -100,14 +126,129 @@ auto wall::loop::PollPipe::write_one() const -> void { write_one(1); }
 
 auto wall::loop::PollPipe::write_one(uint8_t one) const -> void { PollPipe::write(&one, 1); }
 
-wall::loop::Timer::Timer(std::chrono::system_clock::time_point expiration, std::chrono::milliseconds interval, std::function<void(Timer*)> callback)
+wall::loop::PollEvent::PollEvent(std::function<void(PollEvent*, uint64_t count)> callback)
+    : Poll{0, POLLIN, [this](Poll*, uint16_t events) { this->callback_wrapper(events); }}, m_callback{std::move(callback)} {
+    const auto event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (event_fd == -1) {
+        LOG_FATAL("Failed to create eventfd {}", strerror(errno));
+        return;
+    }
+    set_fd(event_fd);
+}
+
+wall::loop::PollEvent::~PollEvent() {
+    if (get_fd() != -1) {
+        ::close(get_fd());
+    }
+}
+
+auto wall::loop::PollEvent::callback_wrapper(int16_t events) -> void {
+    if ((events & POLLIN) != 0) {
+        // reading resets the counter, so every write since the last read is handled by this one callback
+        uint64_t count = 0;
+        const auto read_bytes = ::read(get_fd(), &count, sizeof(count));
+        if (read_bytes == -1) {
+            if (errno != EAGAIN) {
+                LOG_ERROR("Failed to read from eventfd {}", strerror(errno));
+            }
+            return;
+        }
+
+        m_callback(this, count);
+    } else {
+        LOG_ERROR("Invalid events for eventfd {}", events);
+    }
+}
+
+auto wall::loop::PollEvent::write(uint64_t count) const -> void {
+    // safe to call from any thread, eventfd writes are atomic
+    if (::write(get_fd(), &count, sizeof(count)) == -1 && errno != EAGAIN) {
+        LOG_ERROR("Failed to write to eventfd {}", strerror(errno));
+    }
+}
+
+auto wall::loop::PollEvent::write_one() const -> void { write(1); }
+
+wall::loop::Signal::Signal(int32_t signal_number, std::function<void(Signal*, int32_t signal_number)> callback)
+    : Poll{0, POLLIN, [this](Poll*, uint16_t events) { this->callback_wrapper(events); }},
+      m_signal_number{signal_number},
+      m_callback{std::move(callback)} {
+    // the signal has to be blocked, otherwise it is handled by its default disposition instead of being queued for the signalfd
+    block_signals({signal_number});
+
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, signal_number);
+    const auto signal_fd = signalfd(-1, &mask, SFD_CLOEXEC | SFD_NONBLOCK);
+    if (signal_fd == -1) {
+        LOG_FATAL("Failed to create signalfd for signal {} {}", signal_number, strerror(errno));
+        return;
+    }
+    set_fd(signal_fd);
+}
+
+wall::loop::Signal::~Signal() {
+    // the signal stays blocked so it is queued until the next handle for it is created instead of killing the process
+    if (get_fd() != -1) {
+        ::close(get_fd());
+    }
+}
+
+auto wall::loop::Signal::get_signal_number() const -> int32_t { return m_signal_number; }
+
+auto wall::loop::Signal::block_signals(const std::vector<int32_t>& signal_numbers) -> void {
+    sigset_t mask;
+    sigemptyset(&mask);
+    for (const auto signal_number : signal_numbers) {
+        sigaddset(&mask, signal_number);
+    }
+
+    if (pthread_sigmask(SIG_BLOCK, &mask, nullptr) != 0) {
+        LOG_ERROR("Failed to block signals");
+    }
+}
+
+auto wall::loop::Signal::unblock_signals(const std::vector<int32_t>& signal_numbers) -> void {
+    sigset_t mask;
+    sigemptyset(&mask);
+    for (const auto signal_number : signal_numbers) {
+        sigaddset(&mask, signal_number);
+    }
+
+    if (pthread_sigmask(SIG_UNBLOCK, &mask, nullptr) != 0) {
+        LOG_ERROR("Failed to unblock signals");
+    }
+}
+
+auto wall::loop::Signal::callback_wrapper(int16_t events) -> void {
+    if ((events & POLLIN) == 0) {
+        LOG_ERROR("Invalid events for signalfd {}", events);
+        return;
+    }
+
+    // the same signal can be queued more than once, read until the signalfd is drained
+    signalfd_siginfo info{};
+    while (::read(get_fd(), &info, sizeof(info)) == sizeof(info)) {
+        m_callback(this, static_cast<int32_t>(info.ssi_signo));
+        if (is_closing()) {
+            break;
+        }
+    }
+}
+
+wall::loop::Timer::Timer(loop::Clock::time_point expiration, std::chrono::milliseconds interval, std::function<void(Timer*)> callback)
     : m_expiration{expiration}, m_interval{interval}, m_callback{std::move(callback)} {}
 
 auto wall::loop::Timer::trigger() -> void { m_callback(this); }
 
-auto wall::loop::Timer::get_expiration() const -> std::chrono::system_clock::time_point { return m_expiration; }
+auto wall::loop::Timer::get_expiration() const -> loop::Clock::time_point { return m_expiration; }
 
-auto wall::loop::Timer::set_expiration(std::chrono::system_clock::time_point expiration) -> void { m_expiration = expiration; }
+auto wall::loop::Timer::set_expiration(loop::Clock::time_point expiration) -> void {
+    m_expiration = expiration;
+    if (get_loop() != nullptr && !is_closing()) {
+        get_loop()->schedule_timer(this);
+    }
+}
 
 auto wall::loop::Timer::get_interval() const -> std::chrono::milliseconds { return m_interval; }
 
@@ -147,9 +288,13 @@ wall::loop::UnixSocket::~UnixSocket() {
         ::close(get_fd());
     }
 
-    for (const auto& [id, client] : m_clients) {
-        client->close();
-        ::close(client->get_fd());
+    // clients are looked up by id, a loop going away might have destroyed them before the socket
+    for (const auto client_id : m_client_ids) {
+        auto* client = static_cast<Poll*>(m_loop->get_handle(client_id));
+        if (client != nullptr) {
+            client->close();
+            ::close(client->get_fd());
+        }
     }
 }
 
@@ -170,7 +315,7 @@ auto wall::loop::UnixSocket::accept_new_connection(int16_t events) -> void {
     }
 
     auto* client_poll = m_loop->add_poll(client_fd, POLLIN, [this](Poll* socket, int16_t events2) { client_read_callback(socket, events2); });
-    m_clients[client_poll->get_id()] = client_poll;
+    m_client_ids.insert(client_poll->get_id());
 }
 
 auto wall::loop::UnixSocket::client_read_callback(Poll* poll, int16_t events) -> void {
@@ -181,7 +326,7 @@ auto wall::loop::UnixSocket::client_read_callback(Poll* poll, int16_t events) ->
         if (read_bytes == 0) {
             poll->close();
             ::close(poll->get_fd());
-            m_clients.erase(poll->get_id());
+            m_client_ids.erase(poll->get_id());
             return;
         }
 
@@ -197,131 +342,324 @@ auto wall::loop::UnixSocket::client_read_callback(Poll* poll, int16_t events) ->
     }
 }
 
-wall::Loop::Loop() : m_now{std::chrono::system_clock::now()} {};
+wall::Loop::Loop()
+    : m_epoll_fd{epoll_create1(EPOLL_CLOEXEC)}, m_timer_fd{timerfd_create(CLOCK_BOOTTIME, TFD_CLOEXEC | TFD_NONBLOCK)}, m_now{loop::Clock::now()} {
+    if (m_epoll_fd == -1) {
+        LOG_FATAL("Failed to create epoll fd {}", strerror(errno));
+    }
+
+    if (m_timer_fd == -1) {
+        LOG_FATAL("Failed to create timerfd {}", strerror(errno));
+    }
+
+    // the timerfd is the only fd in the epoll set without a handle, a null data pointer marks it
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_timer_fd, &event) == -1) {
+        LOG_FATAL("Failed to add timerfd to epoll {}", strerror(errno));
+    }
+};
+
+wall::Loop::~Loop() {
+    // handles might close each other while being destroyed, the epoll fd is going away so there is nothing to unregister
+    for (const auto& slot : m_slots) {
+        if (slot.m_handle != nullptr) {
+            slot.m_handle->m_loop = nullptr;
+        }
+    }
+    for (auto slot_index = 0U; slot_index < m_slots.size(); slot_index++) {
+        if (m_slots[slot_index].m_handle != nullptr) {
+            destroy_handle(slot_index);
+        }
+    }
+
+    if (m_timer_fd != -1) {
+        ::close(m_timer_fd);
+        m_timer_fd = -1;
+    }
 
-wall::Loop::~Loop() = default;
+    if (m_epoll_fd != -1) {
+        ::close(m_epoll_fd);
+        m_epoll_fd = -1;
+    }
+}
 
 auto wall::Loop::run() -> bool {
-    auto is_any_open = std::any_of(m_handles.begin(), m_handles.end(), [](const auto& handle) { return !handle->is_closing(); });
-    if (!is_any_open) {
+    if (m_open_count == 0) {
         return false;
     }
 
-    // calculate min timer expiration
-    std::chrono::milliseconds min_timeout = calculate_timeout();
+    // wake up on the earliest timer expiration
+    update_timer_fd();
 
-    // poll fds with timer expiration as max timeout
-    poll_fds(min_timeout);
+    const auto wakeup_time = poll_fds();
 
     // run close handlers first
-    std::erase_if(m_handles, [](const auto& handle) { return handle->is_closing(); });
+    destroy_closed_handles();
 
-    m_now = std::chrono::system_clock::now();
+    m_now = loop::Clock::now();
 
     // check timers
     handle_timers(m_now);
 
+    m_stats.record(LoopMetric::Iteration, loop::Clock::now() - wakeup_time);
+
     // check signals
     return true;
 }
 
-auto wall::Loop::calculate_timeout() const -> std::chrono::milliseconds {
-    std::chrono::milliseconds min_timeout{std::numeric_limits<int32_t>::max()};
-    for (const auto& handle : m_handles) {
-        if (!handle->is_closing() && handle->get_type() == loop::HandleType::Timer) {
-            auto* timer = static_cast<loop::Timer*>(handle.get());
-            const auto timer_duration = std::chrono::duration_cast<std::chrono::milliseconds>(timer->get_expiration() - m_now);
-            if (timer_duration < min_timeout) {
-                min_timeout = timer_duration;
-            }
-        }
+auto wall::Loop::update_timer_fd() -> void {
+    const auto* timer = peek_timer();
+    const auto expiration = timer != nullptr ? timer->get_expiration() : loop::Clock::time_point::max();
+    if (expiration == m_timer_fd_expiration) {
+        return;
+    }
+
+    // an all zero it_value disarms the timer, an absolute expiration in the past fires immediately
+    itimerspec timer_spec{};
+    if (expiration != loop::Clock::time_point::max()) {
+        const auto since_boot = expiration.time_since_epoch();
+        const auto secs = std::chrono::duration_cast<std::chrono::seconds>(since_boot);
+        timer_spec.it_value.tv_sec = secs.count();
+        timer_spec.it_value.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(since_boot - secs).count();
     }
 
-    return min_timeout;
+    if (timerfd_settime(m_timer_fd, TFD_TIMER_ABSTIME, &timer_spec, nullptr) == -1) {
+        LOG_ERROR("Failed to arm timerfd {}", strerror(errno));
+        return;
+    }
+    m_timer_fd_expiration = expiration;
 }
 
 auto wall::Loop::add_poll(int32_t file_descriptor, int16_t trigger_events, std::function<void(loop::Poll*, int16_t)> callback) -> loop::Poll* {
-    return add_handle(std::make_unique<loop::Poll>(file_descriptor, trigger_events, std::move(callback)));
+    return add_handle<loop::Poll>(file_descriptor, trigger_events, std::move(callback));
 }
 
 auto wall::Loop::add_poll_pipe(std::function<void(loop::PollPipe*, const std::vector<uint8_t>&)> callback) -> loop::PollPipe* {
-    return add_handle(std::make_unique<loop::PollPipe>(std::move(callback)));
+    return add_handle<loop::PollPipe>(std::move(callback));
+}
+
+auto wall::Loop::add_poll_event(std::function<void(loop::PollEvent*, uint64_t)> callback) -> loop::PollEvent* {
+    return add_handle<loop::PollEvent>(std::move(callback));
+}
+
+auto wall::Loop::add_signal(int32_t signal_number, std::function<void(loop::Signal*, int32_t)> callback) -> loop::Signal* {
+    return add_handle<loop::Signal>(signal_number, std::move(callback));
 }
 
 auto wall::Loop::add_timer(std::chrono::milliseconds initial_delay,
                            std::chrono::milliseconds interval,
                            std::function<void(loop::Timer*)> callback) -> loop::Timer* {
-    return add_handle(std::make_unique<loop::Timer>(m_now + initial_delay, interval, std::move(callback)));
+    return add_handle<loop::Timer>(m_now + initial_delay, interval, std::move(callback));
 }
 
 auto wall::Loop::add_unix_socket(const std::filesystem::path& path,
                                  std::function<void(loop::UnixSocket*, const std::string&)> callback) -> loop::UnixSocket* {
-    return add_handle(std::make_unique<loop::UnixSocket>(this, path, std::move(callback)));
+    return add_handle<loop::UnixSocket>(this, path, std::move(callback));
 }
 
-auto wall::Loop::handle_timers(std::chrono::system_clock::time_point now) -> void {
-    // The m_handles vector might change on triggering the timer, so we have to check the vector each time
+auto wall::Loop::handle_timers(loop::Clock::time_point now) -> void {
+    // Triggering a timer might add, close or reschedule timers, so the top of the queue is checked again after each one
     while (true) {
-        loop::Timer* valid_timer = nullptr;
-        for (const auto& handle : m_handles) {
-            if (!handle->is_closing() && handle->get_type() == loop::HandleType::Timer) {
-                auto* check_timer = static_cast<loop::Timer*>(handle.get());
-                if (check_timer->get_expiration() <= now) {
-                    valid_timer = check_timer;
-                    break;
-                }
-            }
-        }
-
-        if (valid_timer == nullptr) {
+        auto* valid_timer = peek_timer();
+        if (valid_timer == nullptr || valid_timer->get_expiration() > now) {
             break;
         }
 
-        // set next expiration
+        const auto expiration = valid_timer->get_expiration();
+
+        // set next expiration, this also replaces the timer's entry in the queue
         if (valid_timer->get_interval().count() > 0) {
             valid_timer->set_expiration(now + valid_timer->get_interval());
         } else {
-            valid_timer->set_expiration(std::chrono::system_clock::time_point::max());
+            valid_timer->set_expiration(loop::Clock::time_point::max());
         }
+
+        const auto trigger_time = loop::Clock::now();
+        m_stats.record(LoopMetric::TimerLateness, trigger_time - expiration);
         valid_timer->trigger();
+        m_stats.record_callback(loop::HandleType::Timer, loop::Clock::now() - trigger_time);
     }
 }
 
-auto wall::Loop::poll_fds(std::chrono::milliseconds min_timeout) -> void {
-    std::vector<pollfd> fds;
-    std::vector<loop::Poll*> polls;
-    for (const auto& handle : m_handles) {
-        if (!handle->is_closing() && (handle->get_type() == loop::HandleType::Poll || handle->get_type() == loop::HandleType::PollPipe ||
-                                      handle->get_type() == loop::HandleType::UnixSocket)) {
-            auto* poll = static_cast<loop::Poll*>(handle.get());
-            const int16_t events = poll->get_trigger_events() | POLLERR | POLLHUP;  // always listen for errors and hangups
-            fds.push_back({poll->get_fd(), events, 0});
-            polls.push_back(poll);
+auto wall::Loop::schedule_timer(loop::Timer* timer) -> void {
+    // bumping the sequence invalidates any entry already in the queue for this timer
+    timer->m_sequence = ++m_timer_sequence;
+
+    // timers that will never fire again are only kept around until they are closed
+    if (timer->get_expiration() == loop::Clock::time_point::max()) {
+        return;
+    }
+
+    m_timer_queue.push({timer->get_expiration(), timer->m_sequence, timer->get_id()});
+
+    if (m_timer_queue.size() > k_min_stale_timer_entries && m_timer_queue.size() > 2 * m_timer_count) {
+        compact_timer_queue();
+    }
+}
+
+auto wall::Loop::peek_timer() -> loop::Timer* {
+    while (!m_timer_queue.empty()) {
+        const auto& entry = m_timer_queue.top();
+        auto* timer = static_cast<loop::Timer*>(get_handle(entry.m_timer_id));
+        if (timer != nullptr && timer->m_sequence == entry.m_sequence) {
+            return timer;
         }
+        m_timer_queue.pop();
     }
 
-    if (!fds.empty()) {
-        auto err_code = poll(fds.data(), fds.size(), min_timeout.count());
-        if (err_code == -1) {
+    return nullptr;
+}
+
+auto wall::Loop::compact_timer_queue() -> void {
+    std::vector<TimerEntry> live_entries;
+    live_entries.reserve(m_timer_count);
+    while (!m_timer_queue.empty()) {
+        const auto& entry = m_timer_queue.top();
+        const auto* timer = static_cast<loop::Timer*>(get_handle(entry.m_timer_id));
+        if (timer != nullptr && timer->m_sequence == entry.m_sequence) {
+            live_entries.push_back(entry);
+        }
+        m_timer_queue.pop();
+    }
+
+    m_timer_queue = decltype(m_timer_queue){std::greater<>{}, std::move(live_entries)};
+}
+
+auto wall::Loop::poll_fds() -> loop::Clock::time_point {
+    std::array<epoll_event, k_max_epoll_events> events;
+
+    // timers wake the loop through the timerfd, so there is no timeout here
+    const auto poll_start_time = loop::Clock::now();
+    const auto ready_count = epoll_wait(m_epoll_fd, events.data(), events.size(), -1);
+    const auto wakeup_time = loop::Clock::now();
+    m_stats.record(LoopMetric::PollBlocked, wakeup_time - poll_start_time);
+    m_stats.add_wakeup();
+
+    if (ready_count == -1) {
+        if (errno != EINTR) {
             LOG_ERROR("Failed to poll fds {}", strerror(errno));
-            return;
         }
+        return wakeup_time;
+    }
 
-        for (auto i = 0UL; i < fds.size(); i++) {
-            auto* poll_handle = polls[i];
-            if (!poll_handle->is_closing() && (fds[i].revents & poll_handle->get_trigger_events()) != 0) {
-                polls[i]->trigger(fds[i].revents);
-            }
+    // handles are only destroyed in run after polling, so the pointers stay valid even if a callback closes another handle
+    for (auto i = 0; i < ready_count; i++) {
+        if (events[i].data.ptr == nullptr) {
+            // drain the expiration count, the timers themselves are checked against the clock in handle_timers
+            uint64_t expirations = 0;
+            [[maybe_unused]] const auto read_bytes = ::read(m_timer_fd, &expirations, sizeof(expirations));
+            m_timer_fd_expiration = loop::Clock::time_point::max();
+            continue;
         }
+
+        auto* poll_handle = static_cast<loop::Poll*>(events[i].data.ptr);
+        const auto revents = static_cast<int16_t>(events[i].events);  // EPOLLIN/OUT/ERR/HUP share their values with POLLIN/OUT/ERR/HUP
+        if (!poll_handle->is_closing() && (revents & poll_handle->get_trigger_events()) != 0) {
+            const auto trigger_time = loop::Clock::now();
+            poll_handle->trigger(revents);
+            m_stats.record_callback(poll_handle->get_type(), loop::Clock::now() - trigger_time);
+        }
+    }
+
+    return wakeup_time;
+}
+
+auto wall::Loop::is_poll_type(loop::HandleType type) -> bool {
+    return type == loop::HandleType::Poll || type == loop::HandleType::PollPipe || type == loop::HandleType::PollEvent ||
+           type == loop::HandleType::Signal || type == loop::HandleType::UnixSocket;
+}
+
+auto wall::Loop::register_poll(loop::Poll* poll) const -> void {
+    epoll_event event{};
+    event.events = static_cast<uint16_t>(poll->get_trigger_events()) | EPOLLERR | EPOLLHUP;  // always listen for errors and hangups
+    event.data.ptr = poll;
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, poll->get_fd(), &event) == -1) {
+        LOG_ERROR("Failed to add fd {} to epoll {}", poll->get_fd(), strerror(errno));
+    }
+}
+
+auto wall::Loop::unregister_poll(loop::Poll* poll) const -> void {
+    // the fd might already be closed, in which case the kernel has already dropped it from the epoll set
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, poll->get_fd(), nullptr) == -1 && errno != EBADF && errno != ENOENT) {
+        LOG_ERROR("Failed to remove fd {} from epoll {}", poll->get_fd(), strerror(errno));
+    }
+}
+
+auto wall::Loop::on_handle_close(loop::Handle* handle) -> void {
+    m_open_count--;
+    m_closing_slots.push_back(static_cast<uint32_t>(handle->get_id() & k_slot_index_mask));
+    if (is_poll_type(handle->get_type())) {
+        unregister_poll(static_cast<loop::Poll*>(handle));
+    } else if (handle->get_type() == loop::HandleType::Timer) {
+        // the timer's queue entry is left in place and skipped once it reaches the top
+        m_timer_count--;
+    }
+}
+
+auto wall::Loop::track_handle(loop::Handle* handle, size_t size) -> void {
+    uint32_t slot_index = 0;
+    if (m_free_slots.empty()) {
+        slot_index = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
     } else {
-        std::this_thread::sleep_for(std::chrono::milliseconds{min_timeout});
+        slot_index = m_free_slots.back();
+        m_free_slots.pop_back();
+    }
+
+    auto& slot = m_slots[slot_index];
+    slot.m_handle = handle;
+    slot.m_size = size;
+
+    handle->m_loop = this;
+    handle->m_id = (static_cast<uint64_t>(slot.m_generation) << k_generation_shift) | slot_index;
+    m_open_count++;
+}
+
+auto wall::Loop::get_stats_mut() -> LoopStats* { return &m_stats; }
+
+auto wall::Loop::get_handle(uint64_t handle_id) const -> loop::Handle* {
+    const auto slot_index = handle_id & k_slot_index_mask;
+    const auto generation = static_cast<uint32_t>(handle_id >> k_generation_shift);
+    if (slot_index >= m_slots.size()) {
+        return nullptr;
+    }
+
+    const auto& slot = m_slots[slot_index];
+    if (slot.m_generation != generation || slot.m_handle == nullptr || slot.m_handle->is_closing()) {
+        return nullptr;
+    }
+
+    return slot.m_handle;
+}
+
+auto wall::Loop::destroy_handle(uint32_t slot_index) -> void {
+    auto& slot = m_slots[slot_index];
+    auto* handle = slot.m_handle;
+    const auto size = slot.m_size;
+
+    // clear the slot first, destroying the handle can close other handles
+    slot.m_handle = nullptr;
+    slot.m_generation++;
+
+    handle->~Handle();
+    m_allocator.deallocate(handle, size);
+    m_free_slots.push_back(slot_index);
+}
+
+auto wall::Loop::destroy_closed_handles() -> void {
+    // destroying a handle can close more handles, which are appended and destroyed in the same pass
+    for (auto closing_ix = 0UL; closing_ix < m_closing_slots.size(); closing_ix++) {
+        destroy_handle(m_closing_slots[closing_ix]);
     }
+    m_closing_slots.clear();
 }
 
 auto wall::Loop::print_open_handles() -> void {
-    for (const auto& handle : m_handles) {
-        if (!handle->is_closing()) {
-            LOG_DEBUG("Handle: {} type {}", handle->get_id(), static_cast<int>(handle->get_type()));
+    for (const auto& slot : m_slots) {
+        if (slot.m_handle != nullptr && !slot.m_handle->is_closing()) {
+            LOG_DEBUG("Handle: {} type {}", slot.m_handle->get_id(), static_cast<int>(slot.m_handle->get_type()));
         }
     }
 }
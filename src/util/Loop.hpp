@@ -5,15 +5,23 @@
 #include <filesystem>
 #include <functional>
 #include <memory>
-#include <unordered_map>
+#include <new>
+#include <queue>
+#include <unordered_set>
+#include <vector>
+#include "util/LoopAllocator.hpp"
+#include "util/LoopClock.hpp"
+#include "util/LoopStats.hpp"
 
 namespace wall {
 
 namespace loop {
+
 enum class HandleType {
     None,
     Poll,
     PollPipe,
+    PollEvent,
     UnixSocket,
     TcpSocket,
     UdpSocket,
@@ -23,6 +31,8 @@ enum class HandleType {
 class Handle;
 class Poll;
 class PollPipe;
+class PollEvent;
+class Signal;
 class UnixSocket;
 class Timer;
 }  // namespace loop
@@ -45,30 +55,124 @@ class Loop {
 
     auto add_poll_pipe(std::function<void(loop::PollPipe*, const std::vector<uint8_t>&)> callback) -> loop::PollPipe*;
 
+    auto add_poll_event(std::function<void(loop::PollEvent*, uint64_t)> callback) -> loop::PollEvent*;
+
+    auto add_signal(int32_t signal_number, std::function<void(loop::Signal*, int32_t)> callback) -> loop::Signal*;
+
     auto add_unix_socket(const std::filesystem::path& path, std::function<void(loop::UnixSocket*, const std::string&)> callback) -> loop::UnixSocket*;
 
     auto add_timer(std::chrono::milliseconds initial_delay,
                    std::chrono::milliseconds interval,
                    std::function<void(loop::Timer*)> callback) -> loop::Timer*;
 
-   protected:
-    auto poll_fds(std::chrono::milliseconds min_timeout) -> void;
-
-    auto handle_timers(std::chrono::system_clock::time_point now) -> void;
+    // Returns the open handle with the given id, or null if it has been closed. Ids are not reused, so a stale id never returns a newer
+    // handle that happens to use the same slot.
+    [[nodiscard]] auto get_handle(uint64_t handle_id) const -> loop::Handle*;
 
-    [[nodiscard]] auto calculate_timeout() const -> std::chrono::milliseconds;
+    [[nodiscard]] auto get_stats_mut() -> LoopStats*;
 
-    template <std::derived_from<loop::Handle> HandleType>
-    auto add_handle(std::unique_ptr<HandleType> handle) -> HandleType* {
-        auto* retval = handle.get();
-        m_handles.push_back(std::move(handle));
+   protected:
+    // Returns the time the loop woke up
+    auto poll_fds() -> loop::Clock::time_point;
+
+    auto handle_timers(loop::Clock::time_point now) -> void;
+
+    // Arms the loop's timerfd to the earliest timer expiration, or disarms it if there are no pending timers
+    auto update_timer_fd() -> void;
+
+    template <std::derived_from<loop::Handle> HandleType, typename... Args>
+    auto add_handle(Args&&... args) -> HandleType* {
+        static_assert(alignof(HandleType) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+        auto* retval = new (m_allocator.allocate(sizeof(HandleType))) HandleType(std::forward<Args>(args)...);
+        track_handle(retval, sizeof(HandleType));
+        if constexpr (std::derived_from<HandleType, loop::Poll>) {
+            register_poll(retval);
+        }
+        if constexpr (std::derived_from<HandleType, loop::Timer>) {
+            m_timer_count++;
+            schedule_timer(retval);
+        }
         return retval;
     }
 
+    // Assigns a slot and id to a newly constructed handle
+    auto track_handle(loop::Handle* handle, size_t size) -> void;
+
+    auto destroy_handle(uint32_t slot_index) -> void;
+
+    auto destroy_closed_handles() -> void;
+
+    auto schedule_timer(loop::Timer* timer) -> void;
+
+    // Drops closed or rescheduled timer entries from the top of the queue, returns the next valid timer if any
+    [[nodiscard]] auto peek_timer() -> loop::Timer*;
+
+    auto compact_timer_queue() -> void;
+
+    auto register_poll(loop::Poll* poll) const -> void;
+
+    auto unregister_poll(loop::Poll* poll) const -> void;
+
+    auto on_handle_close(loop::Handle* handle) -> void;
+
+    [[nodiscard]] static auto is_poll_type(loop::HandleType type) -> bool;
+
    private:
-    std::vector<std::unique_ptr<loop::Handle>> m_handles;
+    struct TimerEntry {
+        loop::Clock::time_point m_expiration;
+
+        // Timers with the same expiration fire in the order they were scheduled
+        uint64_t m_sequence{};
+
+        uint64_t m_timer_id{};
 
-    std::chrono::system_clock::time_point m_now;
+        auto operator>(const TimerEntry& other) const -> bool {
+            return m_expiration > other.m_expiration || (m_expiration == other.m_expiration && m_sequence > other.m_sequence);
+        }
+    };
+
+    struct HandleSlot {
+        loop::Handle* m_handle{};
+
+        // Size the handle was allocated with, needed to return its memory to the allocator
+        size_t m_size{};
+
+        // Bumped every time the slot's handle is destroyed, part of the handle id
+        uint32_t m_generation{1U};
+    };
+
+    loop::HandleAllocator m_allocator;
+
+    std::vector<HandleSlot> m_slots;
+
+    std::vector<uint32_t> m_free_slots;
+
+    // Slots of handles that are closed but not yet destroyed
+    std::vector<uint32_t> m_closing_slots;
+
+    size_t m_open_count{0UL};
+
+    // Min-heap of timer expirations. Entries are not removed when a timer is closed or rescheduled, instead they are skipped when they
+    // reach the top of the heap. An entry is only valid if its timer is still open and its sequence matches the timer's latest one.
+    std::priority_queue<TimerEntry, std::vector<TimerEntry>, std::greater<>> m_timer_queue;
+
+    size_t m_timer_count{0UL};
+
+    uint64_t m_timer_sequence{0UL};
+
+    int32_t m_epoll_fd{-1};
+
+    int32_t m_timer_fd{-1};
+
+    // Expiration the timerfd is currently armed for, max if disarmed
+    loop::Clock::time_point m_timer_fd_expiration{loop::Clock::time_point::max()};
+
+    loop::Clock::time_point m_now;
+
+    LoopStats m_stats;
+
+    friend class loop::Handle;
+    friend class loop::Timer;
 };
 
 namespace loop {
@@ -83,8 +187,10 @@ class Handle {
     auto operator=(const Handle&) -> Handle = delete;
     auto operator=(Handle&&) -> Handle = delete;
 
+    // Made up of the handle's slot in the loop and the slot's generation, see Loop::get_handle
     [[nodiscard]] auto get_id() const -> uint64_t;
 
+    // Poll handles are removed from the loop's epoll set here, so close the handle before closing its fd
     auto close() -> void;
 
    protected:
@@ -92,17 +198,21 @@ class Handle {
 
     [[nodiscard]] virtual auto get_type() const -> HandleType { return HandleType::None; }
 
+    [[nodiscard]] auto get_loop() const -> Loop*;
+
    private:
     bool m_is_closing{false};
 
     uint64_t m_id{0UL};
 
+    Loop* m_loop{};
+
     friend class ::wall::Loop;
 };
 
 class Timer : public Handle {
    public:
-    explicit Timer(std::chrono::system_clock::time_point expiration, std::chrono::milliseconds interval, std::function<void(Timer*)> callback);
+    explicit Timer(loop::Clock::time_point expiration, std::chrono::milliseconds interval, std::function<void(Timer*)> callback);
 
     [[nodiscard]] auto get_type() const -> HandleType override { return HandleType::Timer; }
 
@@ -110,20 +220,23 @@ class Timer : public Handle {
 
     auto set_interval(std::chrono::milliseconds interval) -> void;
 
-    [[nodiscard]] auto get_expiration() const -> std::chrono::system_clock::time_point;
+    [[nodiscard]] auto get_expiration() const -> loop::Clock::time_point;
 
-    auto set_expiration(std::chrono::system_clock::time_point expiration) -> void;
+    auto set_expiration(loop::Clock::time_point expiration) -> void;
 
    protected:
     auto trigger() -> void;
 
    private:
-    std::chrono::system_clock::time_point m_expiration;
+    loop::Clock::time_point m_expiration;
 
     std::chrono::milliseconds m_interval;
 
     std::function<void(Timer*)> m_callback;
 
+    // Sequence of the timer's current entry in the loop's timer queue
+    uint64_t m_sequence{0UL};
+
     friend class ::wall::Loop;
 };
 
@@ -174,11 +287,63 @@ class PollPipe : public Poll {
    private:
     int32_t m_write_fd;
 
+    std::vector<uint8_t> m_read_buffer;
+
     std::function<void(PollPipe*, const std::vector<uint8_t>& buffer)> m_callback;
 
     friend class ::wall::Loop;
 };
 
+// Wakeup handle backed by an eventfd. Any number of writes, from any thread, between two loop iterations are coalesced into a single
+// callback with the number of writes. Prefer this over PollPipe when no payload is needed.
+class PollEvent : public Poll {
+   public:
+    explicit PollEvent(std::function<void(PollEvent*, uint64_t count)> callback);
+
+    ~PollEvent() override;
+
+    auto write(uint64_t count) const -> void;
+
+    auto write_one() const -> void;
+
+    [[nodiscard]] auto get_type() const -> HandleType override { return HandleType::PollEvent; }
+
+   protected:
+    auto callback_wrapper(int16_t events) -> void;
+
+   private:
+    std::function<void(PollEvent*, uint64_t count)> m_callback;
+
+    friend class ::wall::Loop;
+};
+
+// Delivers a signal as a regular loop event through a signalfd. The signal is blocked for the calling thread, for other threads to not
+// receive it directly it has to be blocked before they are started, see block_signals.
+class Signal : public Poll {
+   public:
+    explicit Signal(int32_t signal_number, std::function<void(Signal*, int32_t signal_number)> callback);
+
+    ~Signal() override;
+
+    [[nodiscard]] auto get_signal_number() const -> int32_t;
+
+    [[nodiscard]] auto get_type() const -> HandleType override { return HandleType::Signal; }
+
+    static auto block_signals(const std::vector<int32_t>& signal_numbers) -> void;
+
+    static auto unblock_signals(const std::vector<int32_t>& signal_numbers) -> void;
+
+   protected:
+    auto callback_wrapper(int16_t events) -> void;
+
+   private:
+    int32_t m_signal_number{};
+
+    std::function<void(Signal*, int32_t signal_number)> m_callback;
+
+    friend class ::wall::Loop;
+};
+
 class UnixSocket : public Poll {
    public:
     explicit UnixSocket(Loop* loop, const std::filesystem::path& path, std::function<void(UnixSocket*, const std::string&)> callback);
@@ -201,7 +366,8 @@ class UnixSocket : public Poll {
 
     std::function<void(UnixSocket*, const std::string&)> m_callback;
 
-    std::unordered_map<uint64_t, loop::Poll*> m_clients;
+    // Ids of the client polls, resolved through the loop as they can be destroyed before the socket
+    std::unordered_set<uint64_t> m_client_ids;
 
     friend class ::wall::Loop;
 };
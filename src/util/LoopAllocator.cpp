@@ -0,0 +1,62 @@
+#include "util/LoopAllocator.hpp"
+
+#include <new>
+
+// freed blocks are poisoned so address sanitizer still catches handles used after they were destroyed
+#if __has_include(<sanitizer/asan_interface.h>)
+#include <sanitizer/asan_interface.h>
+#endif
+
+#ifndef ASAN_POISON_MEMORY_REGION
+#define ASAN_POISON_MEMORY_REGION(addr, size) ((void)(addr), (void)(size))
+#define ASAN_UNPOISON_MEMORY_REGION(addr, size) ((void)(addr), (void)(size))
+#endif
+
+wall::loop::HandleAllocator::~HandleAllocator() {
+    for (auto class_ix = 0UL; class_ix < k_size_class_count; class_ix++) {
+        for (auto* block : m_free_blocks[class_ix]) {
+            ASAN_UNPOISON_MEMORY_REGION(block, (class_ix + 1) * k_size_class_bytes);
+            ::operator delete(block);
+        }
+        m_free_blocks[class_ix].clear();
+    }
+}
+
+auto wall::loop::HandleAllocator::get_size_class(size_t size) -> size_t { return (size + k_size_class_bytes - 1) / k_size_class_bytes; }
+
+auto wall::loop::HandleAllocator::allocate(size_t size) -> void* {
+    const auto size_class = get_size_class(size);
+    if (size_class == 0 || size_class > k_size_class_count) {
+        return ::operator new(size);
+    }
+
+    auto& free_blocks = m_free_blocks[size_class - 1];
+    if (free_blocks.empty()) {
+        return ::operator new(size_class * k_size_class_bytes);
+    }
+
+    auto* block = free_blocks.back();
+    free_blocks.pop_back();
+    ASAN_UNPOISON_MEMORY_REGION(block, size_class * k_size_class_bytes);
+    return block;
+}
+
+auto wall::loop::HandleAllocator::deallocate(void* block, size_t size) -> void {
+    const auto size_class = get_size_class(size);
+    if (size_class == 0 || size_class > k_size_class_count) {
+        ::operator delete(block);
+        return;
+    }
+
+    // pooled blocks stay poisoned under AddressSanitizer, so a destroyed handle that is still used is reported like freed memory
+    ASAN_POISON_MEMORY_REGION(block, size_class * k_size_class_bytes);
+    m_free_blocks[size_class - 1].push_back(block);
+}
+
+auto wall::loop::HandleAllocator::get_free_block_count() const -> size_t {
+    auto count = 0UL;
+    for (const auto& free_blocks : m_free_blocks) {
+        count += free_blocks.size();
+    }
+    return count;
+}
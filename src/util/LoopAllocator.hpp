@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace wall {
+namespace loop {
+
+// Free-list allocator for loop handles. Memory of destroyed handles is bucketed by size class and handed out again to new handles of the
+// same size class, so a loop that keeps creating and closing handles stops allocating once it has warmed up.
+class HandleAllocator {
+   public:
+    HandleAllocator() = default;
+    ~HandleAllocator();
+
+    HandleAllocator(HandleAllocator&&) = delete;
+    HandleAllocator(const HandleAllocator&) = delete;
+    auto operator=(const HandleAllocator&) -> HandleAllocator = delete;
+    auto operator=(HandleAllocator&&) -> HandleAllocator = delete;
+
+    [[nodiscard]] auto allocate(size_t size) -> void*;
+
+    auto deallocate(void* block, size_t size) -> void;
+
+    [[nodiscard]] auto get_free_block_count() const -> size_t;
+
+   protected:
+    [[nodiscard]] static auto get_size_class(size_t size) -> size_t;
+
+   private:
+    static constexpr size_t k_size_class_bytes = 64UL;
+
+    // Blocks larger than the last size class are not pooled
+    static constexpr size_t k_size_class_count = 16UL;
+
+    std::array<std::vector<void*>, k_size_class_count> m_free_blocks;
+};
+
+}  // namespace loop
+}  // namespace wall
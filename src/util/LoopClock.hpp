@@ -0,0 +1,21 @@
+#pragma once
+
+#include <chrono>
+
+namespace wall {
+namespace loop {
+
+// Monotonic clock used for all loop scheduling. It is backed by CLOCK_BOOTTIME so it never jumps with wall clock changes but keeps
+// counting while the system is suspended, timers that expired during suspend fire right after resume.
+struct Clock {
+    using duration = std::chrono::nanoseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<Clock>;
+
+    static constexpr bool is_steady = true;
+
+    static auto now() noexcept -> time_point;
+};
+}  // namespace loop
+}  // namespace wall
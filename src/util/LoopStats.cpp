@@ -0,0 +1,151 @@
+#include "util/LoopStats.hpp"
+
+#include <spdlog/fmt/fmt.h>
+#include <bit>
+#include "util/Loop.hpp"
+
+namespace {
+auto get_metric_name(wall::LoopMetric metric) -> std::string_view {
+    switch (metric) {
+        case wall::LoopMetric::Iteration:
+            return "iteration";
+        case wall::LoopMetric::PollBlocked:
+            return "poll_blocked";
+        case wall::LoopMetric::TimerLateness:
+            return "timer_lateness";
+        case wall::LoopMetric::SwapSurfaces:
+            return "swap_surfaces";
+        case wall::LoopMetric::Render:
+            return "render";
+    }
+    return "unknown";
+}
+
+auto get_handle_type_name(wall::loop::HandleType type) -> std::string_view {
+    switch (type) {
+        case wall::loop::HandleType::None:
+            return "none";
+        case wall::loop::HandleType::Poll:
+            return "poll";
+        case wall::loop::HandleType::PollPipe:
+            return "poll_pipe";
+        case wall::loop::HandleType::PollEvent:
+            return "poll_event";
+        case wall::loop::HandleType::UnixSocket:
+            return "unix_socket";
+        case wall::loop::HandleType::TcpSocket:
+            return "tcp_socket";
+        case wall::loop::HandleType::UdpSocket:
+            return "udp_socket";
+        case wall::loop::HandleType::Timer:
+            return "timer";
+        case wall::loop::HandleType::Signal:
+            return "signal";
+    }
+    return "unknown";
+}
+}  // namespace
+
+auto wall::LoopHistogram::get_bucket(std::chrono::nanoseconds duration) -> size_t {
+    const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    if (micros <= 0) {
+        return 0;
+    }
+
+    // bucket n holds durations in [2^(n-1), 2^n) microseconds
+    return std::min(static_cast<size_t>(std::bit_width(static_cast<uint64_t>(micros))), k_bucket_count - 1);
+}
+
+auto wall::LoopHistogram::record(std::chrono::nanoseconds duration) -> void {
+    const auto nanos = static_cast<uint64_t>(std::max(duration.count(), std::chrono::nanoseconds::rep{0}));
+    m_buckets[get_bucket(duration)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_total_ns.fetch_add(nanos, std::memory_order_relaxed);
+
+    auto max_ns = m_max_ns.load(std::memory_order_relaxed);
+    while (nanos > max_ns && !m_max_ns.compare_exchange_weak(max_ns, nanos, std::memory_order_relaxed)) {
+    }
+}
+
+auto wall::LoopHistogram::get_count() const -> uint64_t { return m_count.load(std::memory_order_relaxed); }
+
+auto wall::LoopHistogram::get_mean() const -> std::chrono::microseconds {
+    const auto count = get_count();
+    if (count == 0) {
+        return std::chrono::microseconds::zero();
+    }
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds{m_total_ns.load(std::memory_order_relaxed) / count});
+}
+
+auto wall::LoopHistogram::get_max() const -> std::chrono::microseconds {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds{m_max_ns.load(std::memory_order_relaxed)});
+}
+
+auto wall::LoopHistogram::get_percentile(double percentile) const -> std::chrono::microseconds {
+    const auto count = get_count();
+    if (count == 0) {
+        return std::chrono::microseconds::zero();
+    }
+
+    const auto target = static_cast<uint64_t>(static_cast<double>(count) * percentile / 100.0);
+    auto seen = 0UL;
+    for (auto bucket_ix = 0UL; bucket_ix < k_bucket_count; bucket_ix++) {
+        seen += m_buckets[bucket_ix].load(std::memory_order_relaxed);
+        if (seen > target) {
+            return std::min(std::chrono::microseconds{1UL << bucket_ix}, get_max());
+        }
+    }
+
+    return get_max();
+}
+
+auto wall::LoopHistogram::format() const -> std::string {
+    return fmt::format("count={} mean={}us p50={}us p99={}us max={}us", get_count(), get_mean().count(), get_percentile(50.0).count(),
+                       get_percentile(99.0).count(), get_max().count());
+}
+
+wall::LoopStats::LoopStats() : m_start_time{loop::Clock::now()}, m_last_format_time{m_start_time} {}
+
+auto wall::LoopStats::record(LoopMetric metric, std::chrono::nanoseconds duration) -> void {
+    m_metrics[static_cast<size_t>(metric)].record(duration);
+}
+
+auto wall::LoopStats::record_callback(loop::HandleType type, std::chrono::nanoseconds duration) -> void {
+    m_callbacks[static_cast<size_t>(type)].record(duration);
+}
+
+auto wall::LoopStats::add_wakeup() -> void { m_wakeup_count.fetch_add(1, std::memory_order_relaxed); }
+
+auto wall::LoopStats::get_metric(LoopMetric metric) const -> const LoopHistogram& { return m_metrics[static_cast<size_t>(metric)]; }
+
+auto wall::LoopStats::get_callback_metric(loop::HandleType type) const -> const LoopHistogram& {
+    return m_callbacks[static_cast<size_t>(type)];
+}
+
+auto wall::LoopStats::get_wakeup_count() const -> uint64_t { return m_wakeup_count.load(std::memory_order_relaxed); }
+
+auto wall::LoopStats::format() -> std::string {
+    const auto now = loop::Clock::now();
+    const auto wakeup_count = get_wakeup_count();
+    const auto total_secs = std::chrono::duration<double>(now - m_start_time).count();
+    const auto interval_secs = std::chrono::duration<double>(now - m_last_format_time).count();
+
+    std::string result = fmt::format("wakeups total={} per_sec={:.2f} per_sec_since_last={:.2f}\n", wakeup_count,
+                                     total_secs > 0.0 ? static_cast<double>(wakeup_count) / total_secs : 0.0,
+                                     interval_secs > 0.0 ? static_cast<double>(wakeup_count - m_last_format_wakeup_count) / interval_secs : 0.0);
+    m_last_format_time = now;
+    m_last_format_wakeup_count = wakeup_count;
+
+    for (auto metric_ix = 0UL; metric_ix < k_metric_count; metric_ix++) {
+        result += fmt::format("{} {}\n", get_metric_name(static_cast<LoopMetric>(metric_ix)), m_metrics[metric_ix].format());
+    }
+
+    for (auto type_ix = 0UL; type_ix < k_handle_type_count; type_ix++) {
+        if (m_callbacks[type_ix].get_count() > 0) {
+            result += fmt::format("callback_{} {}\n", get_handle_type_name(static_cast<loop::HandleType>(type_ix)), m_callbacks[type_ix].format());
+        }
+    }
+
+    return result;
+}
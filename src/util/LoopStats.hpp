@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "util/LoopClock.hpp"
+
+namespace wall {
+
+namespace loop {
+enum class HandleType;
+}  // namespace loop
+
+enum class LoopMetric {
+    Iteration,
+    PollBlocked,
+    TimerLateness,
+    SwapSurfaces,
+    Render,
+};
+
+// Histogram with power of two microsecond buckets. Recording only does relaxed atomic adds so it is cheap enough to always be on.
+class LoopHistogram {
+   public:
+    auto record(std::chrono::nanoseconds duration) -> void;
+
+    [[nodiscard]] auto get_count() const -> uint64_t;
+
+    [[nodiscard]] auto get_mean() const -> std::chrono::microseconds;
+
+    [[nodiscard]] auto get_max() const -> std::chrono::microseconds;
+
+    // Upper bound of the bucket the percentile falls into
+    [[nodiscard]] auto get_percentile(double percentile) const -> std::chrono::microseconds;
+
+    [[nodiscard]] auto format() const -> std::string;
+
+   protected:
+    [[nodiscard]] static auto get_bucket(std::chrono::nanoseconds duration) -> size_t;
+
+   private:
+    static constexpr size_t k_bucket_count = 32UL;
+
+    std::array<std::atomic_uint64_t, k_bucket_count> m_buckets{};
+
+    std::atomic_uint64_t m_count{0UL};
+
+    std::atomic_uint64_t m_total_ns{0UL};
+
+    std::atomic_uint64_t m_max_ns{0UL};
+};
+
+class LoopStats {
+   public:
+    LoopStats();
+
+    auto record(LoopMetric metric, std::chrono::nanoseconds duration) -> void;
+
+    auto record_callback(loop::HandleType type, std::chrono::nanoseconds duration) -> void;
+
+    auto add_wakeup() -> void;
+
+    [[nodiscard]] auto get_metric(LoopMetric metric) const -> const LoopHistogram&;
+
+    [[nodiscard]] auto get_callback_metric(loop::HandleType type) const -> const LoopHistogram&;
+
+    [[nodiscard]] auto get_wakeup_count() const -> uint64_t;
+
+    // Also reports the wakeup rate since the previous call
+    [[nodiscard]] auto format() -> std::string;
+
+   private:
+    static constexpr size_t k_metric_count = static_cast<size_t>(LoopMetric::Render) + 1;
+
+    static constexpr size_t k_handle_type_count = 16UL;
+
+    std::array<LoopHistogram, k_metric_count> m_metrics{};
+
+    std::array<LoopHistogram, k_handle_type_count> m_callbacks{};
+
+    std::atomic_uint64_t m_wakeup_count{0UL};
+
+    loop::Clock::time_point m_start_time;
+
+    loop::Clock::time_point m_last_format_time;
+
+    uint64_t m_last_format_wakeup_count{0UL};
+};
+}  // namespace wall
@@ -12,6 +12,7 @@
 #include <cerrno>
 #include <cstring>
 #include "conf/ConfigMacros.hpp"
+#include "util/ClockUtils.hpp"
 #include "util/Log.hpp"
 
 wall::NetworkDiscover::NetworkDiscover(const Config& config) : m_config{config} {
@@ -20,6 +21,10 @@ wall::NetworkDiscover::NetworkDiscover(const Config& config) : m_config{config}
 
 wall::NetworkDiscover::~NetworkDiscover() = default;
 
+auto wall::NetworkDiscover::get_time_to_update(std::chrono::time_point<std::chrono::system_clock> now) const -> std::chrono::milliseconds {
+    return ClockUtils::get_time_to_update(now, m_last_update, m_update_interval);
+}
+
 auto wall::NetworkDiscover::get_config() const -> const Config& { return m_config; }
 
 auto wall::NetworkDiscover::should_update(std::chrono::time_point<std::chrono::system_clock> now) const -> bool {
@@ -18,6 +18,9 @@ class NetworkDiscover {
     virtual ~NetworkDiscover();
     auto get_status(std::chrono::time_point<std::chrono::system_clock> now) -> const Network&;
 
+    // Time until get_status reads the status again
+    [[nodiscard]] auto get_time_to_update(std::chrono::time_point<std::chrono::system_clock> now) const -> std::chrono::milliseconds;
+
    protected:
     [[nodiscard]] virtual auto should_update(std::chrono::time_point<std::chrono::system_clock> now) const -> bool;
 
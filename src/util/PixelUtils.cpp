@@ -0,0 +1,256 @@
+#include "util/PixelUtils.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#include <arm_neon.h>
+#endif
+
+namespace {
+constexpr uint32_t k_opaque = 0xff000000U;
+
+/* premul-color = alpha/255 * color/255 * 255 = (alpha*color)/255
+ * (z/255) = z/256 * 256/255     = z/256 (1 + 1/255)
+ *         = z/256 + (z/256)/255 = (z + z/255)/256
+ *         # recurse once
+ *         = (z + (z + z/255)/256)/256
+ *         = (z + z/256 + z/256/255) / 256
+ *         # only use 16bit uint operations, loose some precision,
+ *         # result is floored.
+ *       ->  (z + z>>8)>>8
+ *         # add 0x80/255 = 0.5 to convert floor to round
+ *       =>  (z+0x80 + (z+0x80)>>8 ) >> 8
+ * ------
+ * tested as equal to lround(z/255.0) for uint z in [0..0xfe02]
+ *
+ * Every intermediate fits into 16 bits, which is what the SIMD kernels compute in.
+ */
+auto premultiply(uint32_t color, uint32_t alpha) -> uint32_t {
+    const auto product = (color * alpha) + 0x80U;
+    return (product + (product >> 8U)) >> 8U;
+}
+
+// Cairo's formats are native endian 32 bit words
+auto store_pixel(uint8_t* dst, uint32_t pixel) -> void { std::memcpy(dst, &pixel, sizeof(pixel)); }
+
+auto rgb_to_xrgb_scalar(const uint8_t* src, uint8_t* dst, size_t count) -> void {
+    for (size_t index = 0; index < count; index++, src += 3, dst += 4) {
+        store_pixel(dst, k_opaque | (uint32_t{src[0]} << 16U) | (uint32_t{src[1]} << 8U) | uint32_t{src[2]});
+    }
+}
+
+auto rgba_to_premultiplied_argb_scalar(const uint8_t* src, uint8_t* dst, size_t count) -> void {
+    for (size_t index = 0; index < count; index++, src += 4, dst += 4) {
+        const uint32_t alpha = src[3];
+        store_pixel(dst, (alpha << 24U) | (premultiply(src[0], alpha) << 16U) | (premultiply(src[1], alpha) << 8U) | premultiply(src[2], alpha));
+    }
+}
+
+#if defined(__x86_64__)
+// SSE2 has no byte shuffle, the swizzle needs SSSE3
+__attribute__((target("ssse3"))) auto rgb_to_xrgb_ssse3(const uint8_t* src, uint8_t* dst, size_t count) -> void {
+    const auto shuffle = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+    const auto opaque = _mm_set1_epi32(static_cast<int32_t>(k_opaque));
+
+    // a load reads 16 bytes for 4 pixels, the last ones are left to the scalar loop to not read past the row
+    size_t index = 0;
+    for (; index + 6 <= count; index += 4) {
+        const auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (index * 3)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + (index * 4)), _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), opaque));
+    }
+
+    rgb_to_xrgb_scalar(src + (index * 3), dst + (index * 4), count - index);
+}
+
+__attribute__((target("avx2"))) auto rgb_to_xrgb_avx2(const uint8_t* src, uint8_t* dst, size_t count) -> void {
+    const auto shuffle = _mm256_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10,
+                                          9, -1);
+    const auto opaque = _mm256_set1_epi32(static_cast<int32_t>(k_opaque));
+
+    // the shuffle stays within 128 bit lanes, the second 4 pixels are moved up into the high lane first
+    const auto spread = _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6);
+    size_t index = 0;
+    for (; index + 11 <= count; index += 8) {
+        const auto loaded = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + (index * 3)));
+        const auto pixels = _mm256_permutevar8x32_epi32(loaded, spread);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + (index * 4)), _mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffle), opaque));
+    }
+
+    // the tail runs legacy SSE code, which stalls while the upper halves of the AVX registers are dirty
+    _mm256_zeroupper();
+    rgb_to_xrgb_ssse3(src + (index * 3), dst + (index * 4), count - index);
+}
+
+// Takes the R G B A channels of two pixels in 16 bit lanes, returns their colors multiplied by alpha in B G R order
+auto premultiply_sse2(__m128i channels, __m128i rounding) -> __m128i {
+    auto alpha = _mm_shufflelo_epi16(channels, _MM_SHUFFLE(3, 3, 3, 3));
+    alpha = _mm_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+    auto colors = _mm_shufflelo_epi16(channels, _MM_SHUFFLE(3, 0, 1, 2));
+    colors = _mm_shufflehi_epi16(colors, _MM_SHUFFLE(3, 0, 1, 2));
+
+    const auto product = _mm_add_epi16(_mm_mullo_epi16(colors, alpha), rounding);
+    return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+}
+
+auto rgba_to_premultiplied_argb_sse2(const uint8_t* src, uint8_t* dst, size_t count) -> void {
+    const auto zero = _mm_setzero_si128();
+    const auto rounding = _mm_set1_epi16(0x80);
+    const auto alpha_mask = _mm_set1_epi32(static_cast<int32_t>(k_opaque));
+
+    size_t index = 0;
+    for (; index + 4 <= count; index += 4) {
+        const auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (index * 4)));
+        const auto low = premultiply_sse2(_mm_unpacklo_epi8(pixels, zero), rounding);
+        const auto high = premultiply_sse2(_mm_unpackhi_epi8(pixels, zero), rounding);
+
+        // alpha is multiplied with itself above, it is taken from the source instead
+        const auto colors = _mm_packus_epi16(low, high);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + (index * 4)),
+                         _mm_or_si128(_mm_andnot_si128(alpha_mask, colors), _mm_and_si128(alpha_mask, pixels)));
+    }
+
+    rgba_to_premultiplied_argb_scalar(src + (index * 4), dst + (index * 4), count - index);
+}
+
+__attribute__((target("avx2"))) auto premultiply_avx2(__m256i channels, __m256i rounding) -> __m256i {
+    auto alpha = _mm256_shufflelo_epi16(channels, _MM_SHUFFLE(3, 3, 3, 3));
+    alpha = _mm256_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+    auto colors = _mm256_shufflelo_epi16(channels, _MM_SHUFFLE(3, 0, 1, 2));
+    colors = _mm256_shufflehi_epi16(colors, _MM_SHUFFLE(3, 0, 1, 2));
+
+    const auto product = _mm256_add_epi16(_mm256_mullo_epi16(colors, alpha), rounding);
+    return _mm256_srli_epi16(_mm256_add_epi16(product, _mm256_srli_epi16(product, 8)), 8);
+}
+
+__attribute__((target("avx2"))) auto rgba_to_premultiplied_argb_avx2(const uint8_t* src, uint8_t* dst, size_t count) -> void {
+    const auto zero = _mm256_setzero_si256();
+    const auto rounding = _mm256_set1_epi16(0x80);
+    const auto alpha_mask = _mm256_set1_epi32(static_cast<int32_t>(k_opaque));
+
+    // unpacking and packing both stay within 128 bit lanes, so the pixels come out in the order they went in
+    size_t index = 0;
+    for (; index + 8 <= count; index += 8) {
+        const auto pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + (index * 4)));
+        const auto low = premultiply_avx2(_mm256_unpacklo_epi8(pixels, zero), rounding);
+        const auto high = premultiply_avx2(_mm256_unpackhi_epi8(pixels, zero), rounding);
+
+        const auto colors = _mm256_packus_epi16(low, high);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + (index * 4)),
+                            _mm256_or_si256(_mm256_andnot_si256(alpha_mask, colors), _mm256_and_si256(alpha_mask, pixels)));
+    }
+
+    _mm256_zeroupper();
+    rgba_to_premultiplied_argb_sse2(src + (index * 4), dst + (index * 4), count - index);
+}
+#elif defined(__aarch64__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+auto rgb_to_xrgb_neon(const uint8_t* src, uint8_t* dst, size_t count) -> void {
+    size_t index = 0;
+    for (; index + 16 <= count; index += 16) {
+        const auto rgb = vld3q_u8(src + (index * 3));
+        const uint8x16x4_t bgrx{{rgb.val[2], rgb.val[1], rgb.val[0], vdupq_n_u8(0xff)}};
+        vst4q_u8(dst + (index * 4), bgrx);
+    }
+
+    rgb_to_xrgb_scalar(src + (index * 3), dst + (index * 4), count - index);
+}
+
+auto premultiply_neon(uint8x8_t color, uint8x8_t alpha) -> uint8x8_t {
+    const auto product = vaddq_u16(vmull_u8(color, alpha), vdupq_n_u16(0x80));
+    return vshrn_n_u16(vaddq_u16(product, vshrq_n_u16(product, 8)), 8);
+}
+
+auto premultiply_neon(uint8x16_t color, uint8x16_t alpha) -> uint8x16_t {
+    return vcombine_u8(premultiply_neon(vget_low_u8(color), vget_low_u8(alpha)), premultiply_neon(vget_high_u8(color), vget_high_u8(alpha)));
+}
+
+auto rgba_to_premultiplied_argb_neon(const uint8_t* src, uint8_t* dst, size_t count) -> void {
+    size_t index = 0;
+    for (; index + 16 <= count; index += 16) {
+        const auto rgba = vld4q_u8(src + (index * 4));
+        const auto alpha = rgba.val[3];
+        const uint8x16x4_t bgra{{premultiply_neon(rgba.val[2], alpha), premultiply_neon(rgba.val[1], alpha), premultiply_neon(rgba.val[0], alpha), alpha}};
+        vst4q_u8(dst + (index * 4), bgra);
+    }
+
+    rgba_to_premultiplied_argb_scalar(src + (index * 4), dst + (index * 4), count - index);
+}
+#endif
+}  // namespace
+
+auto wall::PixelUtils::get_supported_kernels() -> std::vector<Kernel> {
+    std::vector<Kernel> kernels{Kernel::Scalar};
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("ssse3")) {
+        kernels.push_back(Kernel::Ssse3);
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.push_back(Kernel::Avx2);
+    }
+#elif defined(__aarch64__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // part of the base instruction set
+    kernels.push_back(Kernel::Neon);
+#endif
+    return kernels;
+}
+
+auto wall::PixelUtils::get_kernel() -> Kernel {
+    static const auto kernel = get_supported_kernels().back();
+    return kernel;
+}
+
+auto wall::PixelUtils::get_kernel_name(Kernel kernel) -> const char* {
+    switch (kernel) {
+        case Kernel::Ssse3:
+            return "ssse3";
+        case Kernel::Avx2:
+            return "avx2";
+        case Kernel::Neon:
+            return "neon";
+        case Kernel::Scalar:
+            [[fallthrough]];
+        default:
+            return "scalar";
+    }
+}
+
+auto wall::PixelUtils::rgb_to_xrgb(const uint8_t* src, uint8_t* dst, size_t count, Kernel kernel) -> void {
+    switch (kernel) {
+#if defined(__x86_64__)
+        case Kernel::Ssse3:
+            rgb_to_xrgb_ssse3(src, dst, count);
+            break;
+        case Kernel::Avx2:
+            rgb_to_xrgb_avx2(src, dst, count);
+            break;
+#elif defined(__aarch64__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        case Kernel::Neon:
+            rgb_to_xrgb_neon(src, dst, count);
+            break;
+#endif
+        default:
+            rgb_to_xrgb_scalar(src, dst, count);
+            break;
+    }
+}
+
+auto wall::PixelUtils::rgba_to_premultiplied_argb(const uint8_t* src, uint8_t* dst, size_t count, Kernel kernel) -> void {
+    switch (kernel) {
+#if defined(__x86_64__)
+        case Kernel::Ssse3:
+            rgba_to_premultiplied_argb_sse2(src, dst, count);
+            break;
+        case Kernel::Avx2:
+            rgba_to_premultiplied_argb_avx2(src, dst, count);
+            break;
+#elif defined(__aarch64__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        case Kernel::Neon:
+            rgba_to_premultiplied_argb_neon(src, dst, count);
+            break;
+#endif
+        default:
+            rgba_to_premultiplied_argb_scalar(src, dst, count);
+            break;
+    }
+}
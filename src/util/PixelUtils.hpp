@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace wall {
+
+// Converts rows of 8 bit per channel RGB and RGBA pixels, as decoded by gdk-pixbuf, to Cairo's native endian 32 bit formats. Every
+// kernel produces exactly the same bytes, the SIMD ones are picked at runtime depending on what the CPU supports.
+class PixelUtils {
+   public:
+    enum class Kernel {
+        Scalar,
+        Ssse3,
+        Avx2,
+        Neon,
+    };
+
+    // Fastest kernel the CPU supports
+    static auto get_kernel() -> Kernel;
+
+    // Every kernel the CPU supports, slowest first
+    static auto get_supported_kernels() -> std::vector<Kernel>;
+
+    static auto get_kernel_name(Kernel kernel) -> const char*;
+
+    // RGB to CAIRO_FORMAT_RGB24, the unused byte is set to 0xff
+    static auto rgb_to_xrgb(const uint8_t* src, uint8_t* dst, size_t count, Kernel kernel = get_kernel()) -> void;
+
+    // RGBA to CAIRO_FORMAT_ARGB32, colors are multiplied by alpha and rounded to the nearest value
+    static auto rgba_to_premultiplied_argb(const uint8_t* src, uint8_t* dst, size_t count, Kernel kernel = get_kernel()) -> void;
+};
+}  // namespace wall
@@ -1,64 +1,53 @@
 #include "util/SignalHandler.hpp"
 #include <csignal>
 
-#include "util/CommandProcessor.hpp"
 #include "util/Log.hpp"
 #include "wallock/Wallock.hpp"
 
 namespace {
-const wall::Config* g_config = nullptr;
-wall::Wallock* g_instance = nullptr;
+const std::vector<int32_t> k_shutdown_signals = {SIGINT, SIGTERM, SIGQUIT, SIGHUP};  // NOLINT
+const std::vector<int32_t> k_handled_signals = {SIGINT, SIGTERM, SIGQUIT, SIGHUP, SIGUSR1, SIGUSR2};  // NOLINT
 }  // namespace
 
-wall::SignalHandler::SignalHandler(const Config* config, Wallock* wallock) {
-    if (g_config == nullptr) {
-        g_config = config;
-        g_instance = wallock;
-    } else {
-        LOG_WARN("SignalHandler already initialized");
+wall::SignalHandler::SignalHandler(Wallock* wallock) : m_wallock{wallock} {
+    for (const auto signal_number : k_handled_signals) {
+        m_signals.push_back(
+            m_wallock->get_loop()->add_signal(signal_number, [this](loop::Signal*, int32_t received_signal) { on_signal(received_signal); }));
     }
-
-    signal(SIGINT, shutdown_handler);
-    signal(SIGTERM, shutdown_handler);
-    signal(SIGQUIT, shutdown_handler);
-    signal(SIGHUP, shutdown_handler);
-    signal(SIGUSR1, refresh_handler);
-    signal(SIGUSR2, reload_handler);
-}
-
-wall::SignalHandler::~SignalHandler() {
-    g_config = nullptr;
-    stop_listening();
 }
 
-auto wall::SignalHandler::refresh_handler([[maybe_unused]] int signal) -> void {
-    LOG_DEBUG("Received signal to reload colors {}", signal);
-    if (g_config != nullptr) {
-        CommandProcessor::send(*g_config, commands::k_reload);
+wall::SignalHandler::~SignalHandler() { close_signals(); }
+
+auto wall::SignalHandler::block_signals() -> void { loop::Signal::block_signals(k_handled_signals); }
+
+auto wall::SignalHandler::on_signal(int32_t signal_number) -> void {
+    switch (signal_number) {
+        case SIGUSR1:
+            LOG_DEBUG("Received signal to reload colors {}", signal_number);
+            m_wallock->reload();
+            break;
+        case SIGUSR2:
+            LOG_DEBUG("Received signal to reload {}", signal_number);
+            m_wallock->full_reload();
+            break;
+        default:
+            LOG_DEBUG("Received signal to shutdown {}", signal_number);
+            stop_listening();
+            m_wallock->stop();
+            break;
     }
 }
 
-auto wall::SignalHandler::reload_handler([[maybe_unused]] int signal) -> void {
-    LOG_DEBUG("Received signal to reload {}", signal);
-    if (g_config != nullptr) {
-        CommandProcessor::send(*g_config, commands::k_full_reload);
+auto wall::SignalHandler::close_signals() -> void {
+    for (auto* signal_handle : m_signals) {
+        signal_handle->close();
     }
-}
-
-auto wall::SignalHandler::shutdown_handler([[maybe_unused]] int signal) -> void {
-    LOG_DEBUG("Received signal to shutdown {}", signal);
-    stop_listening();
-    if (g_instance != nullptr) {
-        g_instance->stop();
-    }
-    g_config = nullptr;
-    g_instance = nullptr;
+    m_signals.clear();
 }
 
 auto wall::SignalHandler::stop_listening() -> void {
-    signal(SIGINT, SIG_DFL);
-    signal(SIGTERM, SIG_DFL);
-    signal(SIGQUIT, SIG_DFL);
-    signal(SIGUSR1, SIG_DFL);
-    signal(SIGUSR2, SIG_DFL);
+    close_signals();
+
+    // restore the default behavior, a second shutdown signal terminates right away
+    loop::Signal::unblock_signals(k_shutdown_signals);
 }
@@ -1,11 +1,13 @@
 #pragma once
 
-#include "conf/Config.hpp"
+#include <vector>
+#include "util/Loop.hpp"
+
 namespace wall {
 class Wallock;
 class SignalHandler {
    public:
-    SignalHandler(const Config* config, Wallock* wallock);
+    explicit SignalHandler(Wallock* wallock);
     ~SignalHandler();
 
     SignalHandler(const SignalHandler& other) = delete;
@@ -13,15 +15,19 @@ class SignalHandler {
     SignalHandler(SignalHandler&& other) = delete;
     auto operator=(SignalHandler&& other) -> SignalHandler& = delete;
 
-    static auto stop_listening() -> void;
+    // Needs to run before any thread is started, threads inherit the signal mask and would otherwise receive the signals directly
+    static auto block_signals() -> void;
 
-   protected:
-    static auto shutdown_handler(int signal) -> void;
+    auto stop_listening() -> void;
 
-    static auto refresh_handler(int signal) -> void;
+   protected:
+    auto on_signal(int32_t signal_number) -> void;
 
-    static auto reload_handler(int signal) -> void;
+    auto close_signals() -> void;
 
    private:
+    Wallock* m_wallock{};
+
+    std::vector<loop::Signal*> m_signals;
 };
 }  // namespace wall
@@ -0,0 +1,94 @@
+#include "util/WorkerPool.hpp"
+
+#include <spdlog/common.h>
+#include <utility>
+
+#include "util/Log.hpp"
+
+wall::WorkerPool::WorkerPool(Loop* loop, size_t thread_count) {
+    if (thread_count == 0 || loop == nullptr) {
+        return;
+    }
+
+    m_work_done_poll = loop->add_poll_event([this](loop::PollEvent* /* poll */, uint64_t /* count */) { run_done_callbacks(); });
+
+    m_threads.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; i++) {
+        m_threads.emplace_back(&WorkerPool::run_worker, this);
+    }
+    LOG_DEBUG("Started {} worker threads", thread_count);
+}
+
+wall::WorkerPool::~WorkerPool() { stop(); }
+
+auto wall::WorkerPool::get_thread_count() const -> size_t { return m_threads.size(); }
+
+auto wall::WorkerPool::post(std::function<void()> work, std::function<void()> done) -> void {
+    if (m_threads.empty()) {
+        work();
+        done();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_guard);
+        m_pending_tasks.push_back(Task{.m_work = std::move(work), .m_done = std::move(done)});
+    }
+    m_work_available.notify_one();
+}
+
+auto wall::WorkerPool::stop() -> void {
+    {
+        std::lock_guard<std::mutex> lock(m_guard);
+        m_is_stopping = true;
+        m_pending_tasks.clear();
+    }
+    m_work_available.notify_all();
+
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+    m_done_tasks.clear();
+
+    if (m_work_done_poll != nullptr) {
+        m_work_done_poll->close();
+        m_work_done_poll = nullptr;
+    }
+}
+
+auto wall::WorkerPool::run_worker() -> void {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(m_guard);
+            m_work_available.wait(lock, [this]() { return m_is_stopping || !m_pending_tasks.empty(); });
+            if (m_is_stopping) {
+                return;
+            }
+
+            task = std::move(m_pending_tasks.front());
+            m_pending_tasks.pop_front();
+        }
+
+        task.m_work();
+
+        {
+            std::lock_guard<std::mutex> lock(m_guard);
+            m_done_tasks.push_back(std::move(task));
+        }
+        m_work_done_poll->write_one();
+    }
+}
+
+auto wall::WorkerPool::run_done_callbacks() -> void {
+    std::vector<Task> done_tasks;
+    {
+        std::lock_guard<std::mutex> lock(m_guard);
+        done_tasks.swap(m_done_tasks);
+    }
+
+    for (auto& task : done_tasks) {
+        task.m_done();
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "util/Loop.hpp"
+
+namespace wall {
+
+// Runs work off the loop thread. The work of a task runs on one of the worker threads, its done callback then runs on the loop thread
+// after a wakeup. Without worker threads both run right away on the calling thread.
+class WorkerPool {
+   public:
+    WorkerPool(Loop* loop, size_t thread_count);
+    virtual ~WorkerPool();
+
+    WorkerPool(WorkerPool&&) = delete;
+    WorkerPool(const WorkerPool&) = delete;
+    auto operator=(const WorkerPool&) -> WorkerPool = delete;
+    auto operator=(WorkerPool&&) -> WorkerPool = delete;
+
+    auto post(std::function<void()> work, std::function<void()> done) -> void;
+
+    [[nodiscard]] auto get_thread_count() const -> size_t;
+
+    // Stops the worker threads after their current work, tasks that did not start and pending done callbacks are dropped
+    auto stop() -> void;
+
+   protected:
+    auto run_worker() -> void;
+
+    auto run_done_callbacks() -> void;
+
+   private:
+    struct Task {
+        std::function<void()> m_work;
+        std::function<void()> m_done;
+    };
+
+    loop::PollEvent* m_work_done_poll{};
+
+    std::mutex m_guard;
+
+    std::condition_variable m_work_available;
+
+    // Guarded by m_guard
+    std::deque<Task> m_pending_tasks;
+
+    // Guarded by m_guard, tasks whose work is done but whose done callback has not run yet
+    std::vector<Task> m_done_tasks;
+
+    // Guarded by m_guard
+    bool m_is_stopping{false};
+
+    std::vector<std::thread> m_threads;
+};
+}  // namespace wall
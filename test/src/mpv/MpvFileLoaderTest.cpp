@@ -237,3 +237,58 @@ TEST(MpvFileLoaderTest, test_calculate_timer_delay) {
     timer_delay = wall::MpvFileLoader::calculate_timer_delay(3.0, resource_config);
     EXPECT_EQ(timer_delay, std::chrono::seconds{3});
 }
+
+TEST(MpvFileLoaderTest, test_calculate_switch_delay) {
+    auto config = wall::Config::get_default_config();
+    wall::MpvResourceConfig resource_config = wall::MpvResourceConfig::build_config(config, wall::ResourceMode::Wallpaper);
+    resource_config.m_image_change_interval_secs = std::chrono::seconds{10};
+    resource_config.m_video_max_change_interval_secs = std::chrono::seconds{20};
+    resource_config.m_video_preload_secs = std::chrono::seconds{5};
+
+    // the switch happens when the file ends, the preload time is not taken off
+    EXPECT_EQ(wall::MpvFileLoader::calculate_switch_delay(0.0, resource_config), std::chrono::milliseconds{10000});
+    EXPECT_EQ(wall::MpvFileLoader::calculate_switch_delay(15.5, resource_config), std::chrono::milliseconds{15500});
+    EXPECT_EQ(wall::MpvFileLoader::calculate_switch_delay(25.0, resource_config), std::chrono::milliseconds{20000});
+}
+
+TEST(MpvFileLoaderTest, standby_timer) {
+    auto config = wall::Config::get_default_config();
+    config.set(wall::conf::k_file_path, "/tmp/standby_folder");
+    config.set(wall::conf::k_file_sort_order, "alpha");
+    config.set(wall::conf::k_file_standby_preload, true);
+
+    std::filesystem::create_directory("/tmp/standby_folder");
+    std::ofstream("/tmp/standby_folder/test_1.png").close();
+    std::ofstream("/tmp/standby_folder/test_2.png").close();
+
+    wall::PrimaryDisplayState primary_state;
+    wall::Loop loop;
+    std::vector<std::string> loaded_files;
+    std::vector<std::string> preloaded_files;
+    auto switch_count = 0;
+
+    wall::MpvResourceConfig resource_config = wall::MpvResourceConfig::build_config(config, wall::ResourceMode::Wallpaper);
+    wall::MpvFileLoader loader(config, &loop, &resource_config, &primary_state, "",
+                               [&](const std::string& file) { loaded_files.push_back(file); });
+    loader.set_standby_callbacks([&](const std::string& file) { preloaded_files.push_back(file); },
+                                 [&]() {
+                                     switch_count++;
+                                     loader.stop();
+                                     return true;
+                                 });
+    loader.load_options();
+    loader.load_next_file();
+    ASSERT_EQ(loaded_files.size(), 1);
+    EXPECT_EQ(loaded_files.front(), "/tmp/standby_folder/test_1.png");
+
+    // the next file goes to the standby 0.2 seconds early and is switched to without loading it again, stopping the loader ends the loop
+    loader.setup_load_next_file_timer(1.2);
+    while (loop.run()) {
+    }
+
+    ASSERT_EQ(preloaded_files.size(), 1);
+    EXPECT_EQ(preloaded_files.front(), "/tmp/standby_folder/test_2.png");
+    EXPECT_EQ(switch_count, 1);
+    EXPECT_EQ(loaded_files.size(), 1);
+    EXPECT_EQ(loader.get_current_file(), "/tmp/standby_folder/test_2.png");
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <chrono>
+
+#include "mpv/MpvPlaybackGovernor.hpp"
+
+namespace {
+auto get_time(int64_t milliseconds) -> std::chrono::steady_clock::time_point {
+    return std::chrono::steady_clock::time_point{} + std::chrono::milliseconds{milliseconds};
+}
+}  // namespace
+
+TEST(MpvPlaybackGovernorTest, disabled_plays_normally) {
+    wall::MpvPlaybackGovernor governor;
+    governor.set_limits(0, 0, false);
+    EXPECT_FALSE(governor.is_enabled());
+
+    EXPECT_FALSE(governor.update(get_time(0), {.m_is_ac_connected = false, .m_file_fps = 60.0, .m_is_hidden = true}));
+    EXPECT_FALSE(governor.update(get_time(10000), {.m_is_ac_connected = false, .m_file_fps = 60.0, .m_is_hidden = true}));
+    EXPECT_EQ(governor.get_mode(), wall::PlaybackMode::Normal);
+}
+
+TEST(MpvPlaybackGovernorTest, battery_cap_after_hold) {
+    wall::MpvPlaybackGovernor governor;
+    governor.set_limits(0, 15, false);
+    EXPECT_TRUE(governor.is_battery_needed());
+
+    const wall::PlaybackInputs on_battery{.m_is_ac_connected = false, .m_file_fps = 30.0};
+    EXPECT_FALSE(governor.update(get_time(0), on_battery));
+    EXPECT_FALSE(governor.update(get_time(2000), on_battery));
+    EXPECT_EQ(governor.get_mode(), wall::PlaybackMode::Normal);
+
+    EXPECT_TRUE(governor.update(get_time(3000), on_battery));
+    EXPECT_EQ(governor.get_mode(), wall::PlaybackMode::Capped);
+    EXPECT_EQ(governor.get_frame_interval(), std::chrono::milliseconds{67});
+
+    // no battery information leaves the rate alone
+    const wall::PlaybackInputs unknown{.m_file_fps = 30.0};
+    EXPECT_FALSE(governor.update(get_time(4000), unknown));
+    EXPECT_TRUE(governor.update(get_time(7000), unknown));
+    EXPECT_EQ(governor.get_mode(), wall::PlaybackMode::Normal);
+}
+
+TEST(MpvPlaybackGovernorTest, hysteresis_ignores_flapping) {
+    wall::MpvPlaybackGovernor governor;
+    governor.set_limits(0, 15, false);
+
+    const wall::PlaybackInputs on_battery{.m_is_ac_connected = false, .m_file_fps = 30.0};
+    const wall::PlaybackInputs on_ac{.m_is_ac_connected = true, .m_file_fps = 30.0};
+    for (auto time = 0; time < 10000; time += 2000) {
+        EXPECT_FALSE(governor.update(get_time(time), on_battery));
+        EXPECT_FALSE(governor.update(get_time(time + 1000), on_ac));
+    }
+    EXPECT_EQ(governor.get_mode(), wall::PlaybackMode::Normal);
+}
+
+TEST(MpvPlaybackGovernorTest, cap_above_file_rate) {
+    wall::MpvPlaybackGovernor governor;
+    governor.set_limits(30, 0, false);
+
+    EXPECT_FALSE(governor.update(get_time(0), {.m_file_fps = 24.0}));
+    EXPECT_FALSE(governor.update(get_time(5000), {.m_file_fps = 24.0}));
+    EXPECT_EQ(governor.get_mode(), wall::PlaybackMode::Normal);
+
+    governor.update(get_time(6000), {.m_file_fps = 60.0});
+    EXPECT_TRUE(governor.update(get_time(9000), {.m_file_fps = 60.0}));
+    EXPECT_EQ(governor.get_mode(), wall::PlaybackMode::Capped);
+    EXPECT_EQ(governor.get_frame_interval(), std::chrono::milliseconds{33});
+}
+
+TEST(MpvPlaybackGovernorTest, near_static_steps) {
+    wall::MpvPlaybackGovernor governor;
+    governor.set_limits(30, 0, false);
+
+    governor.update(get_time(0), {.m_file_fps = 1.0});
+    EXPECT_TRUE(governor.update(get_time(3000), {.m_file_fps = 1.0}));
+    EXPECT_EQ(governor.get_mode(), wall::PlaybackMode::Stepping);
+    EXPECT_EQ(governor.get_frame_interval(), std::chrono::milliseconds{1000});
+}
+
+TEST(MpvPlaybackGovernorTest, hidden_pauses_and_resumes_at_once) {
+    wall::MpvPlaybackGovernor governor;
+    governor.set_limits(0, 0, true);
+
+    EXPECT_FALSE(governor.update(get_time(0), {.m_file_fps = 30.0, .m_is_hidden = true}));
+    EXPECT_TRUE(governor.update(get_time(3000), {.m_file_fps = 30.0, .m_is_hidden = true}));
+    EXPECT_EQ(governor.get_mode(), wall::PlaybackMode::Paused);
+
+    EXPECT_TRUE(governor.update(get_time(3100), {.m_file_fps = 30.0}));
+    EXPECT_EQ(governor.get_mode(), wall::PlaybackMode::Normal);
+}
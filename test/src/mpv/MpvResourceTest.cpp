@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <utility>
+
+#include "mpv/MpvResource.hpp"
+#include "mpv/MpvResourceConfig.hpp"
+#include "render/SharedFrame.hpp"
+
+TEST(MpvResourceTest, decode_lowres_same_size) {
+    EXPECT_EQ(wall::MpvResource::calculate_decode_lowres(1920, 1080, 1920, 1080, wall::FitMode::Fill), 0);
+    EXPECT_EQ(wall::MpvResource::calculate_decode_lowres(1280, 720, 1920, 1080, wall::FitMode::Fill), 0);
+    EXPECT_EQ(wall::MpvResource::calculate_decode_lowres(3000, 2000, 1920, 1080, wall::FitMode::Fill), 0);
+}
+
+TEST(MpvResourceTest, decode_lowres_large_source) {
+    EXPECT_EQ(wall::MpvResource::calculate_decode_lowres(3840, 2160, 1920, 1080, wall::FitMode::Fill), 1);
+    EXPECT_EQ(wall::MpvResource::calculate_decode_lowres(7680, 4320, 1920, 1080, wall::FitMode::Fill), 2);
+
+    // never below an eighth of the source
+    EXPECT_EQ(wall::MpvResource::calculate_decode_lowres(30720, 17280, 1920, 1080, wall::FitMode::Fill), 3);
+}
+
+TEST(MpvResourceTest, decode_lowres_fit_mode) {
+    // a panorama filling a 16:9 output is cropped at the sides, only its height is shrunk by less than half
+    EXPECT_EQ(wall::MpvResource::calculate_decode_lowres(7680, 2000, 1920, 1080, wall::FitMode::Fill), 0);
+
+    // fit shows all of it, so its width decides
+    EXPECT_EQ(wall::MpvResource::calculate_decode_lowres(7680, 2000, 1920, 1080, wall::FitMode::Fit), 2);
+    EXPECT_EQ(wall::MpvResource::calculate_decode_lowres(7680, 2000, 1920, 1080, wall::FitMode::None), 2);
+}
+
+TEST(MpvResourceTest, decode_lowres_unknown_size) {
+    EXPECT_EQ(wall::MpvResource::calculate_decode_lowres(0, 0, 1920, 1080, wall::FitMode::Fill), 0);
+    EXPECT_EQ(wall::MpvResource::calculate_decode_lowres(3840, 2160, 0, 0, wall::FitMode::Fill), 0);
+}
+
+TEST(MpvResourceTest, shared_frame_outputs_with_different_aspect_ratios) {
+    // a 16:9 source shown on a 21:9 output, which is the largest, and on a 4:3 output
+    const auto outputs = std::array<std::pair<int32_t, int32_t>, 2>{std::pair{2560, 1080}, std::pair{1600, 1200}};
+    for (const auto fit_mode : {wall::FitMode::Fill, wall::FitMode::Fit}) {
+        const auto [width, height] = wall::MpvResource::calculate_shared_frame_size(1920, 1080, 2560, 1080, fit_mode);
+        EXPECT_EQ(width * 1080, height * 1920);
+
+        // every output crops or letterboxes the shared frame the same way it would the source itself
+        for (const auto& [output_width, output_height] : outputs) {
+            const auto shared = wall::SharedFrame::get_bounds(width, height, output_width, output_height, fit_mode);
+            const auto direct = wall::SharedFrame::get_bounds(1920, 1080, output_width, output_height, fit_mode);
+            EXPECT_DOUBLE_EQ(shared.m_frame_left, direct.m_frame_left);
+            EXPECT_DOUBLE_EQ(shared.m_frame_top, direct.m_frame_top);
+            EXPECT_DOUBLE_EQ(shared.m_frame_right, direct.m_frame_right);
+            EXPECT_DOUBLE_EQ(shared.m_frame_bottom, direct.m_frame_bottom);
+            EXPECT_DOUBLE_EQ(shared.m_target_left, direct.m_target_left);
+            EXPECT_DOUBLE_EQ(shared.m_target_top, direct.m_target_top);
+            EXPECT_DOUBLE_EQ(shared.m_target_right, direct.m_target_right);
+            EXPECT_DOUBLE_EQ(shared.m_target_bottom, direct.m_target_bottom);
+        }
+    }
+
+    // fill covers the largest output, fit stays within it
+    EXPECT_EQ(wall::MpvResource::calculate_shared_frame_size(1920, 1080, 2560, 1080, wall::FitMode::Fill), std::make_pair(2560, 1440));
+    EXPECT_EQ(wall::MpvResource::calculate_shared_frame_size(1920, 1080, 2560, 1080, wall::FitMode::Fit), std::make_pair(1920, 1080));
+}
+
+TEST(MpvResourceTest, shared_frame_unknown_source_size) {
+    EXPECT_EQ(wall::MpvResource::calculate_shared_frame_size(0, 0, 2560, 1080, wall::FitMode::Fill), std::make_pair(2560, 1080));
+}
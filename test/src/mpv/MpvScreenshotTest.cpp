@@ -0,0 +1,27 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+
+#include "mpv/MpvScreenshot.hpp"
+
+TEST(MpvScreenshotTest, bgr0_to_rgb) {
+    const std::array<uint8_t, 8> src{0x10, 0x20, 0x30, 0x00, 0xaa, 0xbb, 0xcc, 0xff};
+    std::array<uint8_t, 6> dst{};
+    wall::MpvScreenshot::bgr0_to_rgb(src.data(), dst.data(), 2);
+
+    const std::array<uint8_t, 6> expected{0x30, 0x20, 0x10, 0xcc, 0xbb, 0xaa};
+    EXPECT_EQ(dst, expected);
+}
+
+TEST(MpvScreenshotTest, pixbuf_format) {
+    EXPECT_EQ(wall::MpvScreenshot::get_pixbuf_format("jpg"), "jpeg");
+    EXPECT_EQ(wall::MpvScreenshot::get_pixbuf_format("jpeg"), "jpeg");
+    EXPECT_EQ(wall::MpvScreenshot::get_pixbuf_format("png"), "png");
+}
+
+TEST(MpvScreenshotTest, pixbuf_format_writable) {
+    EXPECT_TRUE(wall::MpvScreenshot::is_pixbuf_format_writable("jpeg"));
+    EXPECT_TRUE(wall::MpvScreenshot::is_pixbuf_format_writable("png"));
+    EXPECT_FALSE(wall::MpvScreenshot::is_pixbuf_format_writable("jpg"));
+    EXPECT_FALSE(wall::MpvScreenshot::is_pixbuf_format_writable("unknown"));
+}
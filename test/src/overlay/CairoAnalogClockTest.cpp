@@ -1,7 +1,10 @@
 #include <cairo.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <chrono>
+#include <vector>
 
+#include "TestUtils.hpp"
 #include "conf/ConfigDefaultSettings.hpp"
 #include "overlay/CairoAnalogClockElement.hpp"
 
@@ -45,22 +48,77 @@ TEST(CairoAnalogClockTest, test_update_interval) {
     auto config = wall::Config::get_default_config();
     config.set(wall::conf::k_lock_bar_monitor, "all");
 
+    const auto start = wall::TestUtils::convert_date_string_to_time_point("2021-01-01 12:00:00");
+    const auto ms = [start](int64_t count) { return start + std::chrono::milliseconds(count); };
+
     wall::CairoAnalogClockElement clock{config};
-    ASSERT_FALSE(clock.should_redraw(std::chrono::milliseconds(100)));
-    ASSERT_TRUE(clock.should_redraw(std::chrono::milliseconds(1001)));
+    ASSERT_FALSE(clock.should_redraw(start, ms(100)));
+    ASSERT_TRUE(clock.should_redraw(start, ms(1001)));
+
+    // redraws are aligned to the clock, not to the last draw
+    ASSERT_TRUE(clock.should_redraw(ms(900), ms(1000)));
+    ASSERT_EQ(clock.get_time_to_redraw(ms(250)), std::chrono::milliseconds(750));
 
     config.set(wall::conf::k_lock_indicator_analog_clock_second_hand_enabled, false);
     clock.update_settings();
-    ASSERT_FALSE(clock.should_redraw(std::chrono::milliseconds(2000)));
-    ASSERT_TRUE(clock.should_redraw(std::chrono::milliseconds(60001)));
+    ASSERT_FALSE(clock.should_redraw(start, ms(2000)));
+    ASSERT_TRUE(clock.should_redraw(start, ms(60001)));
+    ASSERT_EQ(clock.get_time_to_redraw(ms(250)), std::chrono::milliseconds(59750));
 
     config.set(wall::conf::k_lock_indicator_analog_clock_minute_hand_enabled, false);
     clock.update_settings();
-    ASSERT_FALSE(clock.should_redraw(std::chrono::milliseconds(60002)));
-    ASSERT_TRUE(clock.should_redraw(std::chrono::milliseconds(3600001)));
+    ASSERT_FALSE(clock.should_redraw(start, ms(60002)));
+    ASSERT_TRUE(clock.should_redraw(start, ms(3600001)));
 
     config.set(wall::conf::k_lock_indicator_analog_clock_hour_hand_enabled, false);
     clock.update_settings();
-    ASSERT_FALSE(clock.should_redraw(std::chrono::milliseconds(3600002)));
-    ASSERT_FALSE(clock.should_redraw(std::chrono::milliseconds(36000000)));
+    ASSERT_FALSE(clock.should_redraw(start, ms(3600002)));
+    ASSERT_FALSE(clock.should_redraw(start, ms(36000000)));
+    ASSERT_EQ(clock.get_time_to_redraw(ms(250)), std::chrono::milliseconds::zero());
+}
+
+TEST(CairoAnalogClockTest, test_redraw_moved_hands) {
+    auto config = wall::Config::get_default_config();
+
+    const auto second_hand_length = wall_conf_get(config, lock_indicator, analog_clock_second_hand_length);
+    const auto size = static_cast<int32_t>(second_hand_length * 2.0 + 11.0);
+    const auto stride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, size);
+    const auto center = size / 2.0;
+
+    wall::CairoAnalogClockElement clock{config};
+    const auto draw = [&](std::vector<unsigned char>* buffer, std::chrono::system_clock::time_point now, bool is_damage_only) {
+        auto* surface = cairo_image_surface_create_for_data(buffer->data(), CAIRO_FORMAT_ARGB32, size, size, stride);
+        auto* cairo = cairo_create(surface);
+        cairo_set_antialias(cairo, CAIRO_ANTIALIAS_BEST);
+
+        if (is_damage_only) {
+            wall::CairoDamage damage;
+            clock.add_damage(&damage, center, center, wall::State::Input, now);
+            for (const auto& rect : damage.get_rects()) {
+                cairo_rectangle(cairo, rect.x, rect.y, rect.width, rect.height);
+            }
+            cairo_clip(cairo);
+        }
+
+        // overlays are drawn with the source operator
+        cairo_set_operator(cairo, CAIRO_OPERATOR_SOURCE);
+        cairo_set_source_rgba(cairo, 0, 0, 0, 0);
+        cairo_paint(cairo);
+        clock.draw(cairo, center, center, wall::State::Input, now);
+
+        cairo_destroy(cairo);
+        cairo_surface_destroy(surface);
+    };
+
+    const auto start = wall::TestUtils::convert_date_string_to_time_point("2021-01-01 12:00:00");
+    std::vector<unsigned char> partial(static_cast<size_t>(stride * size));
+    std::vector<unsigned char> full(static_cast<size_t>(stride * size));
+    draw(&partial, start, false);
+    const auto first = partial;
+
+    // only the second hand moved, it overlapped the other hands which are composited again where it was
+    draw(&partial, start + std::chrono::seconds(1), true);
+    draw(&full, start + std::chrono::seconds(1), false);
+    EXPECT_NE(partial, first);
+    EXPECT_EQ(partial, full);
 }
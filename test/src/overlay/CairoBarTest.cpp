@@ -14,7 +14,8 @@ TEST(CairoBarTest, test_bar_alignment) {
     config.set(wall::conf::k_lock_bar_top_padding, 10);
     config.set(wall::conf::k_lock_bar_bottom_padding, 10);
 
-    wall::CairoFontCache font_cache{config, CAIRO_SUBPIXEL_ORDER_DEFAULT};
+    wall::FontRegistry font_registry;
+    wall::CairoFontCache font_cache{config, &font_registry, CAIRO_SUBPIXEL_ORDER_DEFAULT};
     font_cache.load_font("FiraCode Nerd Font", 12);
 
     std::string message = "hello world!";
@@ -121,7 +122,8 @@ TEST(CairoBarTest, test_bar_draw) {
     auto config = wall::Config::get_default_config();
     config.set(wall::conf::k_lock_bar_alignment, "top-left");
 
-    wall::CairoFontCache font_cache{config, CAIRO_SUBPIXEL_ORDER_DEFAULT};
+    wall::FontRegistry font_registry;
+    wall::CairoFontCache font_cache{config, &font_registry, CAIRO_SUBPIXEL_ORDER_DEFAULT};
     font_cache.load_font("FiraCode Nerd Font", 12);
 
     std::string message = "hello world!";
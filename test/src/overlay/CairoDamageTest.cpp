@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <numbers>
+
+#include "overlay/CairoDamage.hpp"
+
+TEST(CairoDamageTest, empty_and_full) {
+    wall::CairoDamage damage;
+    EXPECT_TRUE(damage.is_empty());
+    EXPECT_FALSE(damage.is_full());
+
+    damage.add_rect(10.0, 10.0, 0.0, 5.0);
+    EXPECT_TRUE(damage.is_empty());
+
+    damage.add_rect(10.0, 10.0, 5.0, 5.0);
+    EXPECT_FALSE(damage.is_empty());
+    EXPECT_EQ(damage.get_rects().size(), 1);
+
+    damage.add_full();
+    EXPECT_TRUE(damage.is_full());
+    EXPECT_FALSE(damage.is_empty());
+    EXPECT_TRUE(damage.get_rects().empty());
+
+    // rects added after the whole buffer is damaged are redundant
+    damage.add_rect(10.0, 10.0, 5.0, 5.0);
+    EXPECT_TRUE(damage.get_rects().empty());
+
+    wall::CairoDamage other;
+    other.add(damage);
+    EXPECT_TRUE(other.is_full());
+
+    damage.clear();
+    EXPECT_TRUE(damage.is_empty());
+}
+
+TEST(CairoDamageTest, rect_bounds) {
+    wall::CairoDamage damage;
+    damage.add_rect(10.5, 20.25, 4.0, 3.5);
+
+    ASSERT_EQ(damage.get_rects().size(), 1);
+    const auto& rect = damage.get_rects().front();
+
+    // rounded outwards and grown by the antialiasing margin
+    EXPECT_EQ(rect.x, 8);
+    EXPECT_EQ(rect.y, 18);
+    EXPECT_EQ(rect.x + rect.width, 17);
+    EXPECT_EQ(rect.y + rect.height, 26);
+}
+
+TEST(CairoDamageTest, arc_bounds) {
+    wall::CairoDamage damage;
+
+    // quarter arc from the right to the bottom of the circle
+    damage.add_arc(100.0, 100.0, 50.0, 0.0, std::numbers::pi / 2.0, 10.0);
+
+    ASSERT_EQ(damage.get_rects().size(), 1);
+    const auto& quarter = damage.get_rects().front();
+    EXPECT_LE(quarter.x, 95);
+    EXPECT_LE(quarter.y, 95);
+    EXPECT_GE(quarter.x + quarter.width, 155);
+    EXPECT_GE(quarter.y + quarter.height, 155);
+    EXPECT_GT(quarter.x, 50);
+    EXPECT_GT(quarter.y, 50);
+
+    // an arc that crosses the top of the circle reaches above both of its end points
+    damage.clear();
+    damage.add_arc(100.0, 100.0, 50.0, std::numbers::pi * 1.25, std::numbers::pi * 1.75, 2.0);
+
+    ASSERT_EQ(damage.get_rects().size(), 1);
+    EXPECT_LE(damage.get_rects().front().y, 49);
+
+    // a full turn damages the whole circle
+    damage.clear();
+    damage.add_arc(100.0, 100.0, 50.0, 0.0, 2.0 * std::numbers::pi, 10.0);
+
+    ASSERT_EQ(damage.get_rects().size(), 1);
+    const auto& circle = damage.get_rects().front();
+    EXPECT_LE(circle.x, 45);
+    EXPECT_LE(circle.y, 45);
+    EXPECT_GE(circle.x + circle.width, 155);
+    EXPECT_GE(circle.y + circle.height, 155);
+}
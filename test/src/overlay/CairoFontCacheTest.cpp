@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "conf/Config.hpp"
+#include "overlay/CairoFontCache.hpp"
+
+TEST(CairoFontCacheTest, text_layouts_cached) {
+    auto config = wall::Config::get_default_config();
+    wall::FontRegistry font_registry;
+    wall::CairoFontCache font_cache{config, &font_registry, CAIRO_SUBPIXEL_ORDER_DEFAULT};
+    font_cache.load_font("sans-serif", 20.0);
+
+    const auto& extents = font_cache.get_text_extents("Verifying");
+    EXPECT_GT(extents.width, 0.0);
+    EXPECT_EQ(font_cache.get_text_layout_count(), 1);
+
+    // measuring the same text again does not lay it out again
+    EXPECT_EQ(&font_cache.get_text_extents("Verifying"), &extents);
+    EXPECT_EQ(font_cache.get_text_layout_count(), 1);
+
+    EXPECT_LT(font_cache.get_text_extents("V").width, extents.width);
+    EXPECT_EQ(font_cache.get_text_layout_count(), 2);
+
+    // the layouts belong to the old font
+    const auto width = extents.width;
+    font_cache.load_font("sans-serif", 40.0);
+    EXPECT_EQ(font_cache.get_text_layout_count(), 0);
+    EXPECT_GT(font_cache.get_text_extents("Verifying").width, width);
+}
+
+TEST(CairoFontCacheTest, text_layouts_bounded) {
+    auto config = wall::Config::get_default_config();
+    wall::FontRegistry font_registry;
+    wall::CairoFontCache font_cache{config, &font_registry, CAIRO_SUBPIXEL_ORDER_DEFAULT};
+    font_cache.load_font("sans-serif", 20.0);
+
+    for (auto second = 0; second < 120; second++) {
+        [[maybe_unused]] const auto& extents = font_cache.get_text_extents("12:00:" + std::to_string(second));
+    }
+    EXPECT_LT(font_cache.get_text_layout_count(), 120);
+
+    // the most recent text is still cached
+    const auto& latest = font_cache.get_text_extents("12:00:119");
+    const auto count = font_cache.get_text_layout_count();
+    EXPECT_EQ(&font_cache.get_text_extents("12:00:119"), &latest);
+    EXPECT_EQ(font_cache.get_text_layout_count(), count);
+}
@@ -13,7 +13,8 @@ TEST(CairoIndicatorMessageTest, test_cairo_indicator_message_clock_disabled) {
     config.set(wall::conf::k_lock_indicator_monitor, "all");
     config.set(wall::conf::k_lock_indicator_clock_enabled, false);
 
-    wall::CairoFontCache font_cache{config, CAIRO_SUBPIXEL_ORDER_DEFAULT};
+    wall::FontRegistry font_registry;
+    wall::CairoFontCache font_cache{config, &font_registry, CAIRO_SUBPIXEL_ORDER_DEFAULT};
     font_cache.load_font("FiraCode Nerd Font", 12);
 
     const auto time = wall::TestUtils::convert_date_string_to_time_point("2001-01-01 12:00:00");
@@ -31,7 +32,8 @@ TEST(CairoIndicatorMessageTest, test_cairo_indicator_message_clock_enabled) {
     config.set(wall::conf::k_lock_indicator_monitor, "all");
     config.set(wall::conf::k_lock_indicator_clock_enabled, true);
 
-    wall::CairoFontCache font_cache{config, CAIRO_SUBPIXEL_ORDER_DEFAULT};
+    wall::FontRegistry font_registry;
+    wall::CairoFontCache font_cache{config, &font_registry, CAIRO_SUBPIXEL_ORDER_DEFAULT};
     font_cache.load_font("FiraCode Nerd Font", 12);
 
     const auto time = wall::TestUtils::convert_date_string_to_time_point("2001-01-01 12:00:00");
@@ -49,7 +51,8 @@ TEST(CairoIndicatorMessageTest, test_cairo_indicator_caps_lock_message) {
     config.set(wall::conf::k_lock_indicator_monitor, "all");
     config.set(wall::conf::k_lock_indicator_clock_enabled, true);
 
-    wall::CairoFontCache font_cache{config, CAIRO_SUBPIXEL_ORDER_DEFAULT};
+    wall::FontRegistry font_registry;
+    wall::CairoFontCache font_cache{config, &font_registry, CAIRO_SUBPIXEL_ORDER_DEFAULT};
     font_cache.load_font("FiraCode Nerd Font", 12);
 
     const auto time = wall::TestUtils::convert_date_string_to_time_point("2001-01-01 12:00:00");
@@ -67,7 +70,8 @@ TEST(CairoIndicatorMessageTest, test_cairo_indicator_message_draw) {
     config.set(wall::conf::k_lock_indicator_monitor, "all");
     config.set(wall::conf::k_lock_indicator_clock_enabled, true);
 
-    wall::CairoFontCache font_cache{config, CAIRO_SUBPIXEL_ORDER_DEFAULT};
+    wall::FontRegistry font_registry;
+    wall::CairoFontCache font_cache{config, &font_registry, CAIRO_SUBPIXEL_ORDER_DEFAULT};
     font_cache.load_font("FiraCode Nerd Font", 12);
 
     const auto time = wall::TestUtils::convert_date_string_to_time_point("2001-01-01 12:00:00");
@@ -107,3 +111,23 @@ TEST(CairoIndicatorMessageTest, test_cairo_indicator_message_draw) {
     cairo_destroy(cairo);
     free(buffer);
 }
+
+TEST(CairoIndicatorMessageTest, test_cairo_indicator_message_time_to_redraw) {
+    auto config = wall::Config::get_default_config();
+    config.set(wall::conf::k_lock_indicator_clock_enabled, true);
+    config.set(wall::conf::k_lock_indicator_clock_format, "%I:%M %p");
+
+    const auto time = wall::TestUtils::convert_date_string_to_time_point("2001-01-01 12:00:20");
+
+    wall::CairoIndicatorMessage indicator_message{config};
+
+    // the clock shows minutes, it changes at the top of the next one
+    EXPECT_EQ(indicator_message.get_time_to_redraw(wall::State::Input, time), std::chrono::seconds{40});
+
+    // a message replaces the clock
+    EXPECT_EQ(indicator_message.get_time_to_redraw(wall::State::CapsLock, time), std::chrono::milliseconds::zero());
+
+    config.set(wall::conf::k_lock_indicator_clock_enabled, false);
+    indicator_message.update_settings();
+    EXPECT_EQ(indicator_message.get_time_to_redraw(wall::State::Input, time), std::chrono::milliseconds::zero());
+}
@@ -1,6 +1,7 @@
 #include <cairo.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <vector>
 
 #include "conf/ConfigDefaultSettings.hpp"
 #include "overlay/CairoIndicatorElement.hpp"
@@ -26,7 +27,8 @@ TEST(CairoIndicatorTest, test_cairo_indicator) {
     const auto center_x = width / 2.0;
     const auto center_y = height / 2.0;
 
-    wall::CairoIndicatorElement indicator{config};
+    wall::ImageRegistry image_registry;
+    wall::CairoIndicatorElement indicator{config, &image_registry};
 
     // paint black background
     cairo_set_source_rgb(cairo, 0, 0, 0);
@@ -64,3 +66,44 @@ TEST(CairoIndicatorTest, test_cairo_indicator) {
 
     free(buffer);
 }
+
+TEST(CairoIndicatorTest, test_cairo_indicator_layers) {
+    auto config = wall::Config::get_default_config();
+
+    const auto ring_radius = wall_conf_get(config, lock_indicator, ring_radius);
+    const auto ring_thickness = wall_conf_get(config, lock_indicator, ring_thickness);
+    const auto width = static_cast<int32_t>(ring_radius * 2.0 + ring_thickness * 2.0 + 10.0);
+    const auto height = width;
+    const auto stride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, width);
+
+    std::vector<unsigned char> buffer(static_cast<size_t>(stride * height));
+    auto* surface = cairo_image_surface_create_for_data(buffer.data(), CAIRO_FORMAT_ARGB32, width, height, stride);
+    auto* cairo = cairo_create(surface);
+    cairo_set_antialias(cairo, CAIRO_ANTIALIAS_BEST);
+
+    wall::ImageRegistry image_registry;
+    wall::CairoIndicatorElement indicator{config, &image_registry};
+    const auto draw_state = [&](wall::State state) {
+        cairo_set_operator(cairo, CAIRO_OPERATOR_SOURCE);
+        cairo_set_source_rgba(cairo, 0, 0, 0, 0);
+        cairo_paint(cairo);
+
+        indicator.on_state_change(state);
+        indicator.draw(cairo, width / 2.0, height / 2.0);
+        cairo_surface_flush(surface);
+        return buffer;
+    };
+
+    const auto input = draw_state(wall::State::Input);
+    const auto wrong = draw_state(wall::State::Wrong);
+    EXPECT_NE(input, wrong);
+
+    // switching back composites the layer rendered for the first frame
+    EXPECT_EQ(draw_state(wall::State::Input), input);
+
+    indicator.update_settings();
+    EXPECT_EQ(draw_state(wall::State::Input), input);
+
+    cairo_destroy(cairo);
+    cairo_surface_destroy(surface);
+}
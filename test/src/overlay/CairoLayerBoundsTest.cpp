@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+
+#include "overlay/CairoLayerBounds.hpp"
+
+TEST(CairoLayerBoundsTest, update) {
+    wall::CairoLayerBounds bounds;
+    EXPECT_EQ(bounds.get_size(), 0);
+
+    EXPECT_TRUE(bounds.update(100.5, 50.0, 10.0));
+    EXPECT_EQ(bounds.get_x_pos(), 88);
+    EXPECT_EQ(bounds.get_y_pos(), 38);
+    EXPECT_EQ(bounds.get_size(), 25);
+    EXPECT_EQ(bounds.get_center_x(), 100.5);
+    EXPECT_EQ(bounds.get_center_y(), 50.0);
+
+    // the layers stay valid as long as the center does not move
+    EXPECT_FALSE(bounds.update(100.5, 50.0, 10.0));
+    EXPECT_TRUE(bounds.update(101.0, 50.0, 10.0));
+    EXPECT_EQ(bounds.get_x_pos(), 89);
+
+    bounds.reset();
+    EXPECT_EQ(bounds.get_size(), 0);
+    EXPECT_TRUE(bounds.update(101.0, 50.0, 10.0));
+}
+
+TEST(CairoLayerBoundsTest, destroy_surfaces) {
+    cairo_surface_t* first{};
+    cairo_surface_t* second{};
+    wall::CairoLayerBounds::destroy_surfaces({&first, &second});
+    EXPECT_EQ(first, nullptr);
+    EXPECT_EQ(second, nullptr);
+}
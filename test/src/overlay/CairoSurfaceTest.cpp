@@ -1,9 +1,12 @@
 #include <gtest/gtest.h>
 #include <wayland-client-protocol.h>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
 
 #include "MockObjects.hpp"
 #include "State.hpp"
-#include "TestUtils.hpp"
 #include "overlay/CairoSurface.hpp"
 
 class CairoSurfaceMock : public wall::CairoSurface {
@@ -28,15 +31,15 @@ class CairoSurfaceMock : public wall::CairoSurface {
         return wall::CairoSurface::get_last_draw_time();
     }
 
-    [[nodiscard]] auto get_last_activity_time() const -> std::chrono::time_point<std::chrono::system_clock> {
-        return wall::CairoSurface::get_last_activity_time();
-    }
+    [[nodiscard]] auto get_monotonic_now() const -> wall::loop::Clock::time_point { return wall::CairoSurface::get_monotonic_now(); }
+
+    [[nodiscard]] auto get_last_activity_time() const -> wall::loop::Clock::time_point { return wall::CairoSurface::get_last_activity_time(); }
 
     auto set_last_draw_time(std::chrono::time_point<std::chrono::system_clock> now) -> void { wall::CairoSurface::set_last_draw_time(now); }
 
     auto set_idle_timeout(std::chrono::milliseconds idle_timeout) -> void { wall::CairoSurface::set_idle_timeout(idle_timeout); }
 
-    auto set_last_activity_time(std::chrono::time_point<std::chrono::system_clock> now) -> void { wall::CairoSurface::set_last_activity_time(now); }
+    auto set_last_activity_time(wall::loop::Clock::time_point now) -> void { wall::CairoSurface::set_last_activity_time(now); }
 
     auto set_state(wall::State state) -> void { wall::CairoSurface::set_state(state); }
 
@@ -48,6 +51,18 @@ class CairoSurfaceMock : public wall::CairoSurface {
 
     auto set_now(std::chrono::time_point<std::chrono::system_clock> now) -> void { wall::CairoSurface::set_now(now); }
 
+    auto set_monotonic_now(wall::loop::Clock::time_point now) -> void { wall::CairoSurface::set_monotonic_now(now); }
+
+    auto create_cairo_surface(int32_t width, int32_t height, int32_t pixel_size) -> bool {
+        return wall::CairoSurface::create_cairo_surface(width, height, pixel_size);
+    }
+
+    auto render_frame(std::function<void(cairo_t*)> rasterize, std::function<void()> present) -> void {
+        wall::CairoSurface::render_frame(std::move(rasterize), std::move(present));
+    }
+
+    auto cancel_render() -> void { wall::CairoSurface::cancel_render(); }
+
    private:
     uint32_t m_draw_count{};
 };
@@ -68,10 +83,13 @@ TEST(CairoSurfaceTest, idle_timeout) {
     surface.draw(1920, 1080);
 
     surface.on_state_change(wall::State::Keypress);
-    surface.set_now(surface.get_now() + std::chrono::milliseconds{500});
+    surface.set_monotonic_now(surface.get_monotonic_now() + std::chrono::milliseconds{500});
 
     ASSERT_TRUE(surface.should_draw_frame_on_idle(nullptr, nullptr));
-    surface.set_now(surface.get_now() + std::chrono::milliseconds{600});
+
+    // stepping the wall clock back does not postpone the timeout
+    surface.set_now(surface.get_now() - std::chrono::hours{1});
+    surface.set_monotonic_now(surface.get_monotonic_now() + std::chrono::milliseconds{600});
     ASSERT_FALSE(surface.get_state() == wall::State::Idle);
 
     ASSERT_FALSE(surface.should_draw_frame_on_idle(nullptr, nullptr));
@@ -79,7 +97,7 @@ TEST(CairoSurfaceTest, idle_timeout) {
 
     surface.set_is_visible_on_idle(true);
     surface.on_state_change(wall::State::Keypress);
-    surface.set_now(surface.get_now() + std::chrono::milliseconds{2000});
+    surface.set_monotonic_now(surface.get_monotonic_now() + std::chrono::milliseconds{2000});
     ASSERT_TRUE(surface.should_draw_frame_on_idle(nullptr, nullptr));
     ASSERT_EQ(surface.get_state(), wall::State::Idle);
 }
@@ -107,8 +125,8 @@ TEST(CairoSurfaceTest, activity_set) {
     SurfaceMock surface_mock{config, nullptr, &registry_mock};
     CairoSurfaceMock surface{config, &surface_mock};
 
-    const auto time = wall::TestUtils::convert_date_string_to_time_point("2001-01-01 12:00:00");
-    surface.set_now(time);
+    const auto time = wall::loop::Clock::time_point{std::chrono::hours{1}};
+    surface.set_monotonic_now(time);
 
     surface.on_state_change(wall::State::Idle);
     ASSERT_FALSE(surface.get_last_activity_time() == time);
@@ -116,16 +134,86 @@ TEST(CairoSurfaceTest, activity_set) {
     surface.on_state_change(wall::State::Keypress);
     ASSERT_TRUE(surface.get_last_activity_time() == time);
 
-    surface.set_now(time + std::chrono::milliseconds{1000});
+    surface.set_monotonic_now(time + std::chrono::milliseconds{1000});
     surface.on_state_change(wall::State::Backspace);
     ASSERT_TRUE(surface.get_last_activity_time() == (time + std::chrono::milliseconds{1000}));
 
-    surface.set_now(time + std::chrono::milliseconds{5000});
+    surface.set_monotonic_now(time + std::chrono::milliseconds{5000});
     surface.on_state_change(wall::State::Wrong);
     ASSERT_TRUE(surface.get_last_activity_time() == (time + std::chrono::milliseconds{5000}));
 
-    surface.set_now(time + std::chrono::milliseconds{10000});
+    surface.set_monotonic_now(time + std::chrono::milliseconds{10000});
     surface.on_state_change(wall::State::Cleared);
     ASSERT_TRUE(surface.get_last_activity_time() == (time + std::chrono::milliseconds{5000}));
     ASSERT_EQ(surface.get_state(), wall::State::Cleared);
 }
+
+TEST(CairoSurfaceTest, buffer_rotation) {
+    auto config = wall::Config::get_default_config();
+
+    BufferPoolMock buffer_pool;
+
+    wall::Loop loop;
+    RegistryMock registry_mock{config, &loop};
+    registry_mock.set_buffer_pool(&buffer_pool);
+    SurfaceMock surface_mock{config, nullptr, &registry_mock};
+    CairoSurfaceMock surface{config, &surface_mock};
+
+    std::vector<wall::Buffer*> buffers;
+    for (auto i = 0; i < 3; i++) {
+        ASSERT_TRUE(surface.create_cairo_surface(100, 50, 4));
+        auto* buffer = surface.get_cairo_state()->get_buffer();
+        ASSERT_EQ(std::ranges::find(buffers, buffer), buffers.end());
+        buffers.push_back(buffer);
+        // attached, the compositor has not released it yet
+        buffer->m_is_free = false;
+    }
+
+    // every buffer is in use, the draw is deferred
+    ASSERT_FALSE(surface.create_cairo_surface(100, 50, 4));
+
+    buffers[1]->m_is_free = true;
+    ASSERT_TRUE(surface.create_cairo_surface(100, 50, 4));
+    ASSERT_EQ(surface.get_cairo_state()->get_buffer(), buffers[1]);
+
+    // a new size replaces a released buffer, the old one goes back to the pool
+    buffers[0]->m_is_free = true;
+    ASSERT_TRUE(surface.create_cairo_surface(60, 50, 4));
+    ASSERT_EQ(surface.get_cairo_state()->get_width(), 60);
+    ASSERT_EQ(buffer_pool.get_free_buffer_count(), 1);
+}
+
+TEST(CairoSurfaceTest, cancel_render_applies_held_states) {
+    auto config = wall::Config::get_default_config();
+    config.set(wall::conf::k_general_overlay_render_threads, 1UL);
+
+    BufferPoolMock buffer_pool;
+
+    wall::Loop loop;
+    RegistryMock registry_mock{config, &loop};
+    registry_mock.set_buffer_pool(&buffer_pool);
+    SurfaceMock surface_mock{config, nullptr, &registry_mock};
+    CairoSurfaceMock surface{config, &surface_mock};
+    surface.set_state(wall::State::Idle);
+
+    auto present_count = 0;
+    ASSERT_TRUE(surface.create_cairo_surface(100, 50, 4));
+    surface.render_frame([](cairo_t* /* cairo */) {}, [&]() { present_count++; });
+
+    // held back until the frame is done, then applied by the cancel before the next change
+    surface.on_state_change(wall::State::Keypress);
+    surface.cancel_render();
+    ASSERT_EQ(surface.get_state(), wall::State::Input);
+
+    surface.on_state_change(wall::State::Wrong);
+    ASSERT_EQ(surface.get_state(), wall::State::Wrong);
+
+    // a later frame must not replay the state that was held back
+    ASSERT_TRUE(surface.create_cairo_surface(100, 50, 4));
+    surface.render_frame([](cairo_t* /* cairo */) {}, [&]() { present_count++; });
+    while (present_count == 0 && loop.run()) {
+    }
+
+    ASSERT_EQ(present_count, 1);
+    ASSERT_EQ(surface.get_state(), wall::State::Wrong);
+}
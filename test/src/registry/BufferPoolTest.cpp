@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wayland-client-protocol.h>
+#include <vector>
+
+#include "MockObjects.hpp"
+#include "registry/BufferPool.hpp"
+
+class AnonymousFileBufferPool : public BufferPoolMock {
+   public:
+    using wall::BufferPool::create_anonymous_file;
+};
+
+TEST(BufferPoolTest, reuse_released_buffer) {
+    BufferPoolMock buffer_pool;
+
+    auto buffer = buffer_pool.acquire_buffer(100, 50, 4, WL_SHM_FORMAT_ARGB8888);
+    ASSERT_NE(buffer, nullptr);
+    auto* buffer_ptr = buffer.get();
+    auto* data = buffer->m_data;
+
+    buffer_pool.release_buffer(std::move(buffer));
+    EXPECT_EQ(buffer_pool.get_free_buffer_count(), 1);
+    EXPECT_EQ(buffer_pool.get_free_buffer_bytes(), 100 * 50 * 4);
+
+    // different size, a new buffer is created
+    auto other = buffer_pool.acquire_buffer(60, 50, 4, WL_SHM_FORMAT_ARGB8888);
+    ASSERT_NE(other, nullptr);
+    EXPECT_NE(other.get(), buffer_ptr);
+    EXPECT_EQ(buffer_pool.get_free_buffer_count(), 1);
+
+    buffer = buffer_pool.acquire_buffer(100, 50, 4, WL_SHM_FORMAT_ARGB8888);
+    EXPECT_EQ(buffer.get(), buffer_ptr);
+    EXPECT_EQ(buffer->m_data, data);
+    EXPECT_EQ(buffer_pool.get_free_buffer_count(), 0);
+    EXPECT_EQ(buffer_pool.get_free_buffer_bytes(), 0);
+}
+
+TEST(BufferPoolTest, busy_buffer_not_reused) {
+    BufferPoolMock buffer_pool;
+
+    auto buffer = buffer_pool.acquire_buffer(100, 50, 4, WL_SHM_FORMAT_ARGB8888);
+    auto* buffer_ptr = buffer.get();
+
+    // attached and not yet released by the compositor
+    buffer->m_is_free = false;
+    buffer_pool.release_buffer(std::move(buffer));
+
+    auto other = buffer_pool.acquire_buffer(100, 50, 4, WL_SHM_FORMAT_ARGB8888);
+    EXPECT_NE(other.get(), buffer_ptr);
+    EXPECT_EQ(buffer_pool.get_free_buffer_count(), 1);
+
+    // release event from the compositor
+    buffer_ptr->m_is_free = true;
+    buffer = buffer_pool.acquire_buffer(100, 50, 4, WL_SHM_FORMAT_ARGB8888);
+    EXPECT_EQ(buffer.get(), buffer_ptr);
+}
+
+TEST(BufferPoolTest, evict_oldest) {
+    BufferPoolMock buffer_pool;
+
+    std::vector<wall::Buffer*> buffer_ptrs;
+    for (auto i = 0; i < 5; i++) {
+        auto buffer = buffer_pool.acquire_buffer(100, 50, 4, WL_SHM_FORMAT_ARGB8888);
+        buffer_ptrs.push_back(buffer.get());
+        buffer_pool.release_buffer(std::move(buffer));
+        // keep the released buffer busy so the next acquire creates a new one
+        buffer_ptrs.back()->m_is_free = false;
+    }
+
+    // only the newest buffers of one size are kept
+    EXPECT_LT(buffer_pool.get_free_buffer_count(), 5);
+    EXPECT_EQ(buffer_pool.get_free_buffer_bytes(), buffer_pool.get_free_buffer_count() * 100 * 50 * 4);
+
+    buffer_ptrs.back()->m_is_free = true;
+    auto buffer = buffer_pool.acquire_buffer(100, 50, 4, WL_SHM_FORMAT_ARGB8888);
+    EXPECT_EQ(buffer.get(), buffer_ptrs.back());
+
+    // a buffer larger than the memory budget is not kept at all
+    auto large = buffer_pool.acquire_buffer(4096, 4096, 4, WL_SHM_FORMAT_ARGB8888);
+    buffer_pool.release_buffer(std::move(large));
+    EXPECT_EQ(buffer_pool.get_free_buffer_bytes(), buffer_pool.get_free_buffer_count() * 100 * 50 * 4);
+}
+
+TEST(BufferPoolTest, anonymous_file_sealed) {
+    constexpr auto size = 100 * 50 * 4;
+    const auto file = AnonymousFileBufferPool::create_anonymous_file(size);
+    ASSERT_GE(file, 0);
+
+    struct stat file_stat {};
+    ASSERT_EQ(fstat(file, &file_stat), 0);
+    EXPECT_EQ(file_stat.st_size, size);
+
+    // the size is sealed
+    EXPECT_LT(ftruncate(file, size / 2), 0);
+    close(file);
+}
@@ -0,0 +1,42 @@
+#include <cairo.h>
+#include <gtest/gtest.h>
+#include <string>
+
+#include "registry/FontRegistry.hpp"
+
+class FontRegistryMock : public wall::FontRegistry {
+   public:
+    [[nodiscard]] auto get_load_count() const -> uint32_t { return m_load_count; }
+
+   protected:
+    auto load_font_face(std::string_view font) -> cairo_font_face_t* override {
+        m_load_count++;
+        return cairo_toy_font_face_create(std::string{font}.c_str(), CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+    }
+
+   private:
+    uint32_t m_load_count{0U};
+};
+
+TEST(FontRegistryTest, share_font_face) {
+    FontRegistryMock font_registry;
+
+    auto* bar_face = font_registry.acquire_font_face("sans-serif");
+    auto* indicator_face = font_registry.acquire_font_face("sans-serif");
+    EXPECT_NE(bar_face, nullptr);
+    EXPECT_EQ(bar_face, indicator_face);
+    EXPECT_EQ(font_registry.get_load_count(), 1);
+
+    auto* other_face = font_registry.acquire_font_face("monospace");
+    EXPECT_NE(other_face, bar_face);
+    EXPECT_EQ(font_registry.get_load_count(), 2);
+
+    font_registry.release_font_face(bar_face);
+    font_registry.release_font_face(indicator_face);
+    font_registry.release_font_face(other_face);
+
+    // unused faces are kept for the next overlays
+    EXPECT_EQ(font_registry.acquire_font_face("sans-serif"), bar_face);
+    EXPECT_EQ(font_registry.get_load_count(), 2);
+    font_registry.release_font_face(bar_face);
+}
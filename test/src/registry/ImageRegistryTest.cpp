@@ -0,0 +1,102 @@
+#include <cairo.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "registry/ImageRegistry.hpp"
+
+class ImageRegistryMock : public wall::ImageRegistry {
+   public:
+    [[nodiscard]] auto get_load_count() const -> uint32_t { return m_load_count; }
+
+   protected:
+    // a wide image, the left and right thirds are cropped away when it is shown in a circle
+    auto load_image(const std::filesystem::path& /*file_path*/) -> cairo_surface_t* override {
+        m_load_count++;
+        auto* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 300, 100);
+        auto* cairo = cairo_create(surface);
+        cairo_set_source_rgb(cairo, 1.0, 0.0, 0.0);
+        cairo_paint(cairo);
+        cairo_set_source_rgb(cairo, 0.0, 0.0, 1.0);
+        cairo_rectangle(cairo, 100, 0, 100, 100);
+        cairo_fill(cairo);
+        cairo_destroy(cairo);
+        return surface;
+    }
+
+   private:
+    uint32_t m_load_count{0U};
+};
+
+namespace {
+auto create_image_file() -> std::filesystem::path {
+    const auto file_path = std::filesystem::temp_directory_path() / "wallock_image_registry_test.png";
+    std::ofstream{file_path} << "image";
+    return file_path;
+}
+
+auto read_pixel(cairo_surface_t* surface, int32_t x_pos, int32_t y_pos) -> uint32_t {
+    uint32_t pixel{};
+    const auto* data = cairo_image_surface_get_data(surface) + (y_pos * cairo_image_surface_get_stride(surface));
+    std::memcpy(&pixel, data + (x_pos * 4), sizeof(pixel));
+    return pixel;
+}
+}  // namespace
+
+TEST(ImageRegistryTest, scale_image_once) {
+    ImageRegistryMock image_registry;
+    const auto file_path = create_image_file();
+
+    auto* image = image_registry.acquire_image(file_path, 50, 1.0);
+    ASSERT_NE(image, nullptr);
+    EXPECT_EQ(cairo_image_surface_get_width(image), 50);
+    EXPECT_EQ(cairo_image_surface_get_height(image), 50);
+
+    // only the blue center is left
+    for (const auto pixel : {read_pixel(image, 0, 0), read_pixel(image, 25, 25), read_pixel(image, 49, 49)}) {
+        EXPECT_EQ(pixel, 0xff0000ffU);
+    }
+
+    EXPECT_EQ(image_registry.acquire_image(file_path, 50, 1.0), image);
+    EXPECT_EQ(image_registry.get_image_count(), 1);
+
+    // another size or scale is scaled from the decoded image
+    auto* scaled_image = image_registry.acquire_image(file_path, 75, 1.5);
+    ASSERT_NE(scaled_image, nullptr);
+    EXPECT_NE(scaled_image, image);
+    EXPECT_EQ(cairo_image_surface_get_width(scaled_image), 75);
+    double scale_x{};
+    double scale_y{};
+    cairo_surface_get_device_scale(scaled_image, &scale_x, &scale_y);
+    EXPECT_EQ(scale_x, 1.5);
+    EXPECT_EQ(image_registry.get_load_count(), 1);
+
+    image_registry.release_image(image);
+    image_registry.release_image(image);
+    image_registry.release_image(scaled_image);
+
+    // unused images are kept
+    EXPECT_EQ(image_registry.acquire_image(file_path, 50, 1.0), image);
+    image_registry.release_image(image);
+    EXPECT_EQ(image_registry.get_load_count(), 1);
+
+    std::filesystem::remove(file_path);
+}
+
+TEST(ImageRegistryTest, reload_changed_file) {
+    ImageRegistryMock image_registry;
+    const auto file_path = create_image_file();
+
+    image_registry.release_image(image_registry.acquire_image(file_path, 50, 1.0));
+    std::filesystem::last_write_time(file_path, std::filesystem::last_write_time(file_path) + std::chrono::seconds(1));
+    image_registry.release_image(image_registry.acquire_image(file_path, 50, 1.0));
+    EXPECT_EQ(image_registry.get_load_count(), 2);
+    EXPECT_EQ(image_registry.get_decoded_image_count(), 2);
+
+    std::filesystem::remove(file_path);
+    EXPECT_EQ(image_registry.acquire_image(file_path, 50, 1.0), nullptr);
+    EXPECT_EQ(image_registry.acquire_image("", 50, 1.0), nullptr);
+}
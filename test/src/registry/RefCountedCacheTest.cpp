@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "registry/RefCountedCache.hpp"
+
+namespace {
+struct Loader {
+    auto load(const std::string& key) -> std::string* {
+        m_load_count++;
+        return key.empty() ? nullptr : new std::string{key};
+    }
+
+    auto destroy(std::string* value) -> void {
+        m_destroyed.push_back(*value);
+        delete value;
+    }
+
+    uint32_t m_load_count{0U};
+    std::vector<std::string> m_destroyed;
+};
+
+using StringCache = wall::RefCountedCache<std::string, std::string*>;
+
+auto create_cache(Loader* loader) -> StringCache {
+    return StringCache{2, [loader](std::string* value) { loader->destroy(value); }};
+}
+}  // namespace
+
+TEST(RefCountedCacheTest, share_value) {
+    Loader loader;
+    auto cache = create_cache(&loader);
+    const auto load = [&loader](const std::string& key) { return loader.load(key); };
+
+    auto* first = cache.acquire("a", load);
+    auto* second = cache.acquire("a", load);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(loader.m_load_count, 1);
+
+    EXPECT_TRUE(cache.release(first));
+    EXPECT_TRUE(cache.release(second));
+    EXPECT_FALSE(cache.release(second));
+
+    // unused values are kept
+    EXPECT_EQ(cache.acquire("a", load), first);
+    EXPECT_EQ(loader.m_load_count, 1);
+    EXPECT_TRUE(cache.release(first));
+    EXPECT_TRUE(loader.m_destroyed.empty());
+}
+
+TEST(RefCountedCacheTest, destroy_least_recently_released) {
+    Loader loader;
+    auto cache = create_cache(&loader);
+    const auto load = [&loader](const std::string& key) { return loader.load(key); };
+
+    auto* used = cache.acquire("used", load);
+    auto* first = cache.acquire("first", load);
+    auto* second = cache.acquire("second", load);
+    auto* third = cache.acquire("third", load);
+
+    // released out of the order they were loaded in
+    cache.release(second);
+    cache.release(first);
+    cache.release(third);
+
+    EXPECT_EQ(cache.get_size(), 3);
+    EXPECT_EQ(loader.m_destroyed, std::vector<std::string>{"second"});
+
+    // the value in use and the latest unused ones are kept
+    EXPECT_EQ(cache.acquire("used", load), used);
+    cache.release(cache.acquire("first", load));
+    EXPECT_EQ(loader.m_load_count, 4);
+
+    cache.release(used);
+    cache.release(used);
+    EXPECT_EQ(loader.m_destroyed, (std::vector<std::string>{"second", "third"}));
+}
+
+TEST(RefCountedCacheTest, remember_failed_load) {
+    Loader loader;
+    auto cache = create_cache(&loader);
+    const auto load = [&loader](const std::string& key) { return loader.load(key); };
+
+    EXPECT_EQ(cache.acquire("", load), nullptr);
+    EXPECT_EQ(cache.acquire("", load), nullptr);
+    EXPECT_EQ(loader.m_load_count, 1);
+    EXPECT_FALSE(cache.release(nullptr));
+}
+
+TEST(RefCountedCacheTest, clear_destroys_values_in_use) {
+    Loader loader;
+    {
+        auto cache = create_cache(&loader);
+        std::ignore = cache.acquire("a", [&loader](const std::string& key) { return loader.load(key); });
+    }
+    EXPECT_EQ(loader.m_destroyed, std::vector<std::string>{"a"});
+}
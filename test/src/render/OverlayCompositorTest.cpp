@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include <wayland-client-protocol.h>
+#include <array>
+
+#include "MockObjects.hpp"
+#include "overlay/CairoDamage.hpp"
+#include "render/OverlayCompositor.hpp"
+
+namespace {
+// layers are only keyed by their owner, it is never dereferenced
+auto get_owner(const std::array<int32_t, 2>& owners, size_t index) -> const wall::CairoSurface* {
+    return reinterpret_cast<const wall::CairoSurface*>(&owners.at(index));  // NOLINT
+}
+}  // namespace
+
+TEST(OverlayCompositorTest, buffer_in_use_until_drawn) {
+    BufferPoolMock buffer_pool;
+    auto first = buffer_pool.acquire_buffer(100, 50, 4, WL_SHM_FORMAT_ARGB8888);
+    auto second = buffer_pool.acquire_buffer(100, 50, 4, WL_SHM_FORMAT_ARGB8888);
+    std::array<int32_t, 2> owners{};
+
+    wall::CairoDamage damage;
+    damage.add_rect(0.0, 0.0, 10.0, 10.0);
+
+    wall::OverlayCompositor compositor;
+    compositor.set_layer(get_owner(owners, 0), first.get(), 10, 20, damage);
+    EXPECT_EQ(compositor.get_layer_count(), 1);
+    EXPECT_FALSE(first->m_is_free);
+
+    // a newer frame replaces the one waiting to be drawn, the older buffer can be drawn into again
+    compositor.set_layer(get_owner(owners, 0), second.get(), 10, 20, damage);
+    EXPECT_EQ(compositor.get_layer_count(), 1);
+    EXPECT_TRUE(first->m_is_free);
+    EXPECT_FALSE(second->m_is_free);
+
+    compositor.set_layer(get_owner(owners, 1), first.get(), 0, 0, damage);
+    EXPECT_EQ(compositor.get_layer_count(), 2);
+    EXPECT_FALSE(first->m_is_free);
+
+    compositor.remove_layer(get_owner(owners, 0));
+    EXPECT_EQ(compositor.get_layer_count(), 1);
+    EXPECT_TRUE(second->m_is_free);
+
+    // removing an unknown owner is a no-op
+    compositor.remove_layer(get_owner(owners, 0));
+    EXPECT_EQ(compositor.get_layer_count(), 1);
+    EXPECT_FALSE(first->m_is_free);
+}
+
+TEST(OverlayCompositorTest, destroy_releases_buffers) {
+    BufferPoolMock buffer_pool;
+    auto buffer = buffer_pool.acquire_buffer(100, 50, 4, WL_SHM_FORMAT_ARGB8888);
+    std::array<int32_t, 2> owners{};
+
+    {
+        wall::OverlayCompositor compositor;
+        compositor.set_layer(get_owner(owners, 0), buffer.get(), 0, 0, wall::CairoDamage{});
+        EXPECT_FALSE(buffer->m_is_free);
+    }
+
+    EXPECT_TRUE(buffer->m_is_free);
+}
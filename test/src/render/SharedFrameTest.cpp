@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include "mpv/MpvResourceConfig.hpp"
+#include "render/SharedFrame.hpp"
+
+TEST(SharedFrameTest, same_aspect_ratio_copies_frame) {
+    const auto bounds = wall::SharedFrame::get_bounds(3840, 2160, 1920, 1080, wall::FitMode::Fill);
+    EXPECT_DOUBLE_EQ(bounds.m_frame_left, 0.0);
+    EXPECT_DOUBLE_EQ(bounds.m_frame_top, 0.0);
+    EXPECT_DOUBLE_EQ(bounds.m_frame_right, 1.0);
+    EXPECT_DOUBLE_EQ(bounds.m_frame_bottom, 1.0);
+    EXPECT_DOUBLE_EQ(bounds.m_target_left, 0.0);
+    EXPECT_DOUBLE_EQ(bounds.m_target_top, 0.0);
+    EXPECT_DOUBLE_EQ(bounds.m_target_right, 1.0);
+    EXPECT_DOUBLE_EQ(bounds.m_target_bottom, 1.0);
+}
+
+TEST(SharedFrameTest, fill_crops_frame) {
+    // a 16:9 frame on a 4:3 output loses a quarter of its width, an eighth on each side
+    auto bounds = wall::SharedFrame::get_bounds(1920, 1080, 1440, 1080, wall::FitMode::Fill);
+    EXPECT_DOUBLE_EQ(bounds.m_frame_left, 0.125);
+    EXPECT_DOUBLE_EQ(bounds.m_frame_right, 0.875);
+    EXPECT_DOUBLE_EQ(bounds.m_frame_top, 0.0);
+    EXPECT_DOUBLE_EQ(bounds.m_frame_bottom, 1.0);
+    EXPECT_DOUBLE_EQ(bounds.m_target_left, 0.0);
+    EXPECT_DOUBLE_EQ(bounds.m_target_right, 1.0);
+
+    // a wide output keeps the middle rows of a square frame
+    bounds = wall::SharedFrame::get_bounds(1000, 1000, 1000, 500, wall::FitMode::Fill);
+    EXPECT_DOUBLE_EQ(bounds.m_frame_top, 0.25);
+    EXPECT_DOUBLE_EQ(bounds.m_frame_bottom, 0.75);
+    EXPECT_DOUBLE_EQ(bounds.m_frame_left, 0.0);
+    EXPECT_DOUBLE_EQ(bounds.m_frame_right, 1.0);
+}
+
+TEST(SharedFrameTest, fit_letterboxes_frame) {
+    auto bounds = wall::SharedFrame::get_bounds(1920, 1080, 1440, 1080, wall::FitMode::Fit);
+    EXPECT_DOUBLE_EQ(bounds.m_frame_left, 0.0);
+    EXPECT_DOUBLE_EQ(bounds.m_frame_right, 1.0);
+    EXPECT_DOUBLE_EQ(bounds.m_target_top, 0.125);
+    EXPECT_DOUBLE_EQ(bounds.m_target_bottom, 0.875);
+    EXPECT_DOUBLE_EQ(bounds.m_target_left, 0.0);
+    EXPECT_DOUBLE_EQ(bounds.m_target_right, 1.0);
+
+    // without a fit mode mpv shows the whole frame too
+    bounds = wall::SharedFrame::get_bounds(1000, 1000, 1000, 500, wall::FitMode::None);
+    EXPECT_DOUBLE_EQ(bounds.m_target_left, 0.25);
+    EXPECT_DOUBLE_EQ(bounds.m_target_right, 0.75);
+    EXPECT_DOUBLE_EQ(bounds.m_target_top, 0.0);
+    EXPECT_DOUBLE_EQ(bounds.m_target_bottom, 1.0);
+}
+
+TEST(SharedFrameTest, empty_size_copies_frame) {
+    const auto bounds = wall::SharedFrame::get_bounds(0, 0, 1920, 1080, wall::FitMode::Fit);
+    EXPECT_DOUBLE_EQ(bounds.m_target_left, 0.0);
+    EXPECT_DOUBLE_EQ(bounds.m_target_right, 1.0);
+}
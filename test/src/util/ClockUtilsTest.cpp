@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include <chrono>
+
+#include "TestUtils.hpp"
+#include "util/ClockUtils.hpp"
+
+TEST(ClockUtilsTest, format_period) {
+    EXPECT_EQ(wall::ClockUtils::get_format_period("%I:%M %p"), std::chrono::minutes{1});
+    EXPECT_EQ(wall::ClockUtils::get_format_period("%H:%M:%S"), std::chrono::seconds{1});
+    EXPECT_EQ(wall::ClockUtils::get_format_period("%T"), std::chrono::seconds{1});
+    EXPECT_EQ(wall::ClockUtils::get_format_period("%-I %p"), std::chrono::hours{1});
+    EXPECT_EQ(wall::ClockUtils::get_format_period("%a, %b %d"), std::chrono::hours{24});
+    EXPECT_EQ(wall::ClockUtils::get_format_period("%Ey %OM"), std::chrono::minutes{1});
+
+    // literal percent signs and plain text never change
+    EXPECT_EQ(wall::ClockUtils::get_format_period("100%% %n"), std::chrono::seconds::zero());
+    EXPECT_EQ(wall::ClockUtils::get_format_period("clock"), std::chrono::seconds::zero());
+    EXPECT_EQ(wall::ClockUtils::get_format_period("%"), std::chrono::seconds::zero());
+}
+
+TEST(ClockUtilsTest, time_to_next_tick) {
+    // utc offsets are whole minutes, so second and minute ticks are the same in every time zone
+    const auto now = std::chrono::system_clock::from_time_t(1700000000) + std::chrono::milliseconds{250};
+    EXPECT_EQ(wall::ClockUtils::get_time_to_next_tick(now, std::chrono::seconds{1}), std::chrono::milliseconds{750});
+    EXPECT_EQ(wall::ClockUtils::get_time_to_next_tick(now, std::chrono::minutes{1}), std::chrono::milliseconds{39750});
+    EXPECT_EQ(wall::ClockUtils::get_time_to_next_tick(now, std::chrono::seconds::zero()), std::chrono::milliseconds::zero());
+
+    // days start at local midnight
+    const auto before_midnight = wall::TestUtils::convert_date_string_to_time_point("2021-01-01 23:59:30");
+    EXPECT_EQ(wall::ClockUtils::get_time_to_next_tick(before_midnight, std::chrono::hours{24}), std::chrono::seconds{30});
+}
+
+TEST(ClockUtilsTest, time_to_update) {
+    const auto last_update = std::chrono::system_clock::from_time_t(1700000000);
+    const auto interval = std::chrono::seconds{5};
+
+    // the value is read again once more than the interval has passed
+    EXPECT_EQ(wall::ClockUtils::get_time_to_update(last_update, last_update, interval), std::chrono::milliseconds{5001});
+    EXPECT_EQ(wall::ClockUtils::get_time_to_update(last_update + std::chrono::seconds{2}, last_update, interval), std::chrono::milliseconds{3001});
+    EXPECT_EQ(wall::ClockUtils::get_time_to_update(last_update + std::chrono::seconds{10}, last_update, interval), std::chrono::milliseconds{1});
+}
+
+TEST(ClockUtilsTest, tick) {
+    const auto start = wall::TestUtils::convert_date_string_to_time_point("2021-01-01 12:00:00");
+    const auto period = std::chrono::minutes{1};
+
+    EXPECT_EQ(wall::ClockUtils::get_tick(start, period), wall::ClockUtils::get_tick(start + std::chrono::seconds{59}, period));
+    EXPECT_EQ(wall::ClockUtils::get_tick(start, period) + 1, wall::ClockUtils::get_tick(start + std::chrono::seconds{60}, period));
+    EXPECT_EQ(wall::ClockUtils::get_tick(start, period) - 1, wall::ClockUtils::get_tick(start - std::chrono::milliseconds{1}, period));
+}
@@ -0,0 +1,45 @@
+#include "gtest/gtest.h"
+#include "util/Loop.hpp"
+#include "util/LoopStats.hpp"
+
+TEST(LoopStatsTest, test_histogram) {
+    wall::LoopHistogram histogram;
+    EXPECT_EQ(histogram.get_count(), 0);
+    EXPECT_EQ(histogram.get_percentile(50.0).count(), 0);
+
+    for (auto i = 0; i < 99; i++) {
+        histogram.record(std::chrono::microseconds{3});
+    }
+    histogram.record(std::chrono::milliseconds{10});
+
+    EXPECT_EQ(histogram.get_count(), 100);
+    EXPECT_EQ(histogram.get_max(), std::chrono::milliseconds{10});
+    EXPECT_EQ(histogram.get_mean(), std::chrono::microseconds{(99 * 3 + 10000) / 100});
+
+    // 3us falls in the [2us, 4us) bucket
+    EXPECT_EQ(histogram.get_percentile(50.0), std::chrono::microseconds{4});
+    EXPECT_EQ(histogram.get_percentile(100.0), std::chrono::milliseconds{10});
+}
+
+TEST(LoopStatsTest, test_loop_records) {
+    wall::Loop loop;
+
+    auto* poll_event = loop.add_poll_event([](wall::loop::PollEvent*, uint64_t) {});
+    loop.add_timer(std::chrono::milliseconds{0}, std::chrono::milliseconds::zero(), [](wall::loop::Timer* timer) { timer->close(); });
+
+    poll_event->write_one();
+    loop.run();
+
+    const auto* stats = loop.get_stats_mut();
+    EXPECT_EQ(stats->get_wakeup_count(), 1);
+    EXPECT_EQ(stats->get_metric(wall::LoopMetric::Iteration).get_count(), 1);
+    EXPECT_EQ(stats->get_metric(wall::LoopMetric::PollBlocked).get_count(), 1);
+    EXPECT_EQ(stats->get_metric(wall::LoopMetric::TimerLateness).get_count(), 1);
+    EXPECT_EQ(stats->get_callback_metric(wall::loop::HandleType::PollEvent).get_count(), 1);
+    EXPECT_EQ(stats->get_callback_metric(wall::loop::HandleType::Timer).get_count(), 1);
+
+    const auto formatted = loop.get_stats_mut()->format();
+    EXPECT_NE(formatted.find("callback_poll_event count=1"), std::string::npos);
+
+    poll_event->close();
+}
@@ -1,4 +1,13 @@
 
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
 #include "gtest/gtest.h"
 #include "util/Loop.hpp"
 
@@ -20,3 +29,231 @@ TEST(LoopTest, test_pipe) {
 
     loop.run();
 }
+
+TEST(LoopTest, test_closed_poll_not_triggered) {
+    wall::Loop loop;
+
+    auto first_count = 0;
+    auto second_count = 0;
+    wall::loop::PollPipe* second_pipe = nullptr;
+    auto* first_pipe = loop.add_poll_pipe([&](wall::loop::PollPipe*, const std::vector<uint8_t>&) {
+        first_count++;
+        second_pipe->close();
+    });
+    second_pipe = loop.add_poll_pipe([&](wall::loop::PollPipe*, const std::vector<uint8_t>&) { second_count++; });
+
+    // both pipes are ready in the same iteration, the first one closes the second before it is dispatched
+    first_pipe->write_one();
+    second_pipe->write_one();
+    loop.run();
+
+    EXPECT_EQ(first_count, 1);
+    EXPECT_EQ(second_count, 0);
+
+    first_pipe->close();
+    EXPECT_FALSE(loop.run());
+}
+
+TEST(LoopTest, test_timer_order) {
+    wall::Loop loop;
+
+    constexpr auto timer_count = 5000;
+    std::mt19937 rng{42};
+    std::uniform_int_distribution<int32_t> delay_dist{0, 50};
+
+    // (delay, insertion index) in firing order
+    std::vector<std::pair<int32_t, int32_t>> fired;
+    fired.reserve(timer_count);
+    for (auto i = 0; i < timer_count; i++) {
+        const auto delay = delay_dist(rng);
+        loop.add_timer(std::chrono::milliseconds{delay}, std::chrono::milliseconds::zero(), [&fired, delay, i](wall::loop::Timer* timer) {
+            fired.emplace_back(delay, i);
+            timer->close();
+        });
+    }
+
+    // closed timers must never fire, even when they are at the front of the queue
+    auto* closed_timer = loop.add_timer(std::chrono::milliseconds{0}, std::chrono::milliseconds::zero(), [](wall::loop::Timer*) { FAIL(); });
+    closed_timer->close();
+
+    while (loop.run()) {
+    }
+
+    ASSERT_EQ(fired.size(), timer_count);
+    EXPECT_TRUE(std::is_sorted(fired.begin(), fired.end()));
+}
+
+TEST(LoopTest, test_timer_reschedule) {
+    wall::Loop loop;
+
+    std::vector<int32_t> fired;
+    auto* first = loop.add_timer(std::chrono::milliseconds{1}, std::chrono::milliseconds::zero(), [&fired](wall::loop::Timer* timer) {
+        fired.push_back(1);
+        timer->close();
+    });
+    loop.add_timer(std::chrono::milliseconds{5}, std::chrono::milliseconds::zero(), [&fired](wall::loop::Timer* timer) {
+        fired.push_back(2);
+        timer->close();
+    });
+
+    // push the first timer behind the second one, its original entry in the queue must be ignored
+    first->set_expiration(first->get_expiration() + std::chrono::milliseconds{20});
+
+    while (loop.run()) {
+    }
+
+    EXPECT_EQ(fired, (std::vector<int32_t>{2, 1}));
+}
+
+TEST(LoopTest, test_repeating_timer) {
+    wall::Loop loop;
+
+    auto count = 0;
+    loop.add_timer(std::chrono::milliseconds{0}, std::chrono::milliseconds{1}, [&count](wall::loop::Timer* timer) {
+        if (++count == 3) {
+            timer->close();
+        }
+    });
+
+    while (loop.run()) {
+    }
+
+    EXPECT_EQ(count, 3);
+}
+
+TEST(LoopTest, test_poll_event) {
+    wall::Loop loop;
+
+    auto callback_count = 0;
+    uint64_t expect_count = 3;
+    auto* poll_event = loop.add_poll_event([&](wall::loop::PollEvent*, uint64_t count) {
+        callback_count++;
+        EXPECT_EQ(count, expect_count);
+    });
+
+    // all writes before the loop runs are coalesced into a single callback
+    poll_event->write_one();
+    poll_event->write_one();
+    poll_event->write_one();
+    loop.run();
+    EXPECT_EQ(callback_count, 1);
+
+    expect_count = 1;
+    poll_event->write_one();
+    loop.run();
+    EXPECT_EQ(callback_count, 2);
+}
+
+TEST(LoopTest, test_timer_not_early) {
+    wall::Loop loop;
+
+    std::vector<wall::loop::Clock::time_point> expected;
+    std::vector<wall::loop::Clock::time_point> fired;
+    for (auto delay : {3, 1, 2}) {
+        auto* timer = loop.add_timer(std::chrono::milliseconds{delay}, std::chrono::milliseconds::zero(), [&fired](wall::loop::Timer* this_timer) {
+            fired.push_back(wall::loop::Clock::now());
+            this_timer->close();
+        });
+        expected.push_back(timer->get_expiration());
+    }
+    std::sort(expected.begin(), expected.end());
+
+    while (loop.run()) {
+    }
+
+    ASSERT_EQ(fired.size(), expected.size());
+    for (auto i = 0UL; i < fired.size(); i++) {
+        EXPECT_GE(fired[i], expected[i]);
+    }
+}
+
+TEST(LoopTest, test_signal) {
+    wall::Loop loop;
+
+    std::vector<int32_t> received;
+    auto* signal_handle = loop.add_signal(SIGUSR2, [&received](wall::loop::Signal*, int32_t signal_number) { received.push_back(signal_number); });
+
+    kill(getpid(), SIGUSR2);
+    loop.run();
+
+    EXPECT_EQ(received, (std::vector<int32_t>{SIGUSR2}));
+    signal_handle->close();
+}
+
+TEST(LoopTest, test_handle_reuse) {
+    wall::Loop loop;
+
+    auto* keep_alive = loop.add_poll_event([](wall::loop::PollEvent*, uint64_t) {});
+
+    auto* first = loop.add_timer(std::chrono::milliseconds{0}, std::chrono::milliseconds::zero(), [](wall::loop::Timer*) {});
+    const auto first_id = first->get_id();
+    EXPECT_EQ(loop.get_handle(first_id), first);
+
+    first->close();
+    EXPECT_EQ(loop.get_handle(first_id), nullptr);
+    keep_alive->write_one();
+    loop.run();
+
+    // the closed timer's slot is reused, but its id is not
+    auto* second = loop.add_timer(std::chrono::milliseconds{0}, std::chrono::milliseconds::zero(), [](wall::loop::Timer*) {});
+    EXPECT_NE(second->get_id(), first_id);
+    EXPECT_EQ(loop.get_handle(first_id), nullptr);
+    EXPECT_EQ(loop.get_handle(second->get_id()), second);
+
+    second->close();
+    keep_alive->close();
+    EXPECT_FALSE(loop.run());
+}
+
+TEST(LoopTest, test_unix_socket_client_in_lower_slot) {
+    const auto socket_path = std::filesystem::temp_directory_path() / ("wallock_loop_test_" + std::to_string(getpid()) + ".sock");
+    const auto client_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    ASSERT_NE(client_fd, -1);
+
+    std::string received;
+    {
+        wall::Loop loop;
+        auto* keep_alive = loop.add_poll_event([](wall::loop::PollEvent*, uint64_t) {});
+        auto* placeholder = loop.add_timer(std::chrono::milliseconds{0}, std::chrono::milliseconds::zero(), [](wall::loop::Timer*) {});
+        loop.add_unix_socket(socket_path, [&received](wall::loop::UnixSocket*, const std::string& message) { received += message; });
+
+        // free a slot below the socket for its client to reuse
+        placeholder->close();
+        keep_alive->write_one();
+        loop.run();
+
+        sockaddr_un server_addr{};
+        server_addr.sun_family = AF_UNIX;
+        std::strncpy(server_addr.sun_path, socket_path.c_str(), sizeof(server_addr.sun_path) - 1);
+        ASSERT_EQ(connect(client_fd, reinterpret_cast<sockaddr*>(&server_addr), sizeof(server_addr)), 0);
+        loop.run();
+
+        ASSERT_EQ(write(client_fd, "stats", 5), 5);
+        loop.run();
+
+        // the loop destroys the client before the socket, which must not touch it anymore
+    }
+
+    EXPECT_EQ(received, "stats");
+    ::close(client_fd);
+    std::filesystem::remove(socket_path);
+}
+
+TEST(LoopTest, test_handle_allocator) {
+    wall::loop::HandleAllocator allocator;
+
+    auto* first = allocator.allocate(100);
+    allocator.deallocate(first, 100);
+    EXPECT_EQ(allocator.get_free_block_count(), 1);
+
+    // same size class gets the same block back
+    auto* second = allocator.allocate(120);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(allocator.get_free_block_count(), 0);
+    allocator.deallocate(second, 120);
+
+    // large blocks are not pooled
+    auto* large = allocator.allocate(4096);
+    allocator.deallocate(large, 4096);
+    EXPECT_EQ(allocator.get_free_block_count(), 1);
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "util/PixelUtils.hpp"
+
+namespace {
+auto random_pixels(size_t size) -> std::vector<uint8_t> {
+    std::mt19937 generator{42};
+    std::uniform_int_distribution<uint32_t> distribution{0, 255};
+    std::vector<uint8_t> pixels(size);
+    for (auto& channel : pixels) {
+        channel = static_cast<uint8_t>(distribution(generator));
+    }
+    return pixels;
+}
+
+// Every color and alpha combination
+auto all_color_alpha_pairs() -> std::vector<uint8_t> {
+    std::vector<uint8_t> rgba;
+    for (uint32_t alpha = 0; alpha < 256; alpha++) {
+        for (uint32_t color = 0; color < 256; color++) {
+            rgba.insert(rgba.end(), {static_cast<uint8_t>(color), static_cast<uint8_t>(255 - color), 0, static_cast<uint8_t>(alpha)});
+        }
+    }
+    return rgba;
+}
+
+auto read_pixel(const std::vector<uint8_t>& pixels, size_t index) -> uint32_t {
+    uint32_t pixel{};
+    std::memcpy(&pixel, pixels.data() + (index * 4), sizeof(pixel));
+    return pixel;
+}
+}  // namespace
+
+TEST(PixelUtilsTest, scalar_conversion) {
+    const std::vector<uint8_t> rgb{0x11, 0x22, 0x33};
+    std::vector<uint8_t> xrgb(4);
+    wall::PixelUtils::rgb_to_xrgb(rgb.data(), xrgb.data(), 1, wall::PixelUtils::Kernel::Scalar);
+    EXPECT_EQ(read_pixel(xrgb, 0), 0xff112233U);
+
+    // rounded like dividing by 255
+    const auto rgba = all_color_alpha_pairs();
+    std::vector<uint8_t> argb(rgba.size());
+    wall::PixelUtils::rgba_to_premultiplied_argb(rgba.data(), argb.data(), rgba.size() / 4, wall::PixelUtils::Kernel::Scalar);
+    for (size_t index = 0; index < rgba.size() / 4; index++) {
+        const auto alpha = uint32_t{rgba[(index * 4) + 3]};
+        const auto red = static_cast<uint32_t>(std::lround(rgba[index * 4] * alpha / 255.0));
+        const auto green = static_cast<uint32_t>(std::lround(rgba[(index * 4) + 1] * alpha / 255.0));
+        ASSERT_EQ(read_pixel(argb, index), (alpha << 24U) | (red << 16U) | (green << 8U)) << "pixel " << index;
+    }
+}
+
+TEST(PixelUtilsTest, kernels_match_scalar) {
+    // odd counts leave tails for the scalar loop, the exact size buffers catch reads past the row with sanitizers
+    for (const auto count : {0UL, 1UL, 5UL, 7UL, 15UL, 16UL, 17UL, 33UL, 1021UL}) {
+        const auto rgb = random_pixels(count * 3);
+        const auto rgba = random_pixels(count * 4);
+
+        std::vector<uint8_t> expected_xrgb(count * 4);
+        std::vector<uint8_t> expected_argb(count * 4);
+        wall::PixelUtils::rgb_to_xrgb(rgb.data(), expected_xrgb.data(), count, wall::PixelUtils::Kernel::Scalar);
+        wall::PixelUtils::rgba_to_premultiplied_argb(rgba.data(), expected_argb.data(), count, wall::PixelUtils::Kernel::Scalar);
+
+        for (const auto kernel : wall::PixelUtils::get_supported_kernels()) {
+            std::vector<uint8_t> xrgb(count * 4);
+            std::vector<uint8_t> argb(count * 4);
+            wall::PixelUtils::rgb_to_xrgb(rgb.data(), xrgb.data(), count, kernel);
+            wall::PixelUtils::rgba_to_premultiplied_argb(rgba.data(), argb.data(), count, kernel);
+
+            EXPECT_EQ(xrgb, expected_xrgb) << wall::PixelUtils::get_kernel_name(kernel) << " " << count;
+            EXPECT_EQ(argb, expected_argb) << wall::PixelUtils::get_kernel_name(kernel) << " " << count;
+        }
+    }
+
+    const auto rgba = all_color_alpha_pairs();
+    std::vector<uint8_t> expected_argb(rgba.size());
+    wall::PixelUtils::rgba_to_premultiplied_argb(rgba.data(), expected_argb.data(), rgba.size() / 4, wall::PixelUtils::Kernel::Scalar);
+    for (const auto kernel : wall::PixelUtils::get_supported_kernels()) {
+        std::vector<uint8_t> argb(rgba.size());
+        wall::PixelUtils::rgba_to_premultiplied_argb(rgba.data(), argb.data(), rgba.size() / 4, kernel);
+        EXPECT_EQ(argb, expected_argb) << wall::PixelUtils::get_kernel_name(kernel);
+    }
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "util/Loop.hpp"
+#include "util/WorkerPool.hpp"
+
+TEST(WorkerPoolTest, run_inline_without_threads) {
+    wall::Loop loop;
+    wall::WorkerPool worker_pool{&loop, 0};
+
+    std::vector<int32_t> order;
+    worker_pool.post([&order]() { order.push_back(1); }, [&order]() { order.push_back(2); });
+
+    EXPECT_EQ(worker_pool.get_thread_count(), 0);
+    EXPECT_EQ(order, (std::vector<int32_t>{1, 2}));
+}
+
+TEST(WorkerPoolTest, done_on_loop_thread) {
+    wall::Loop loop;
+    wall::WorkerPool worker_pool{&loop, 2};
+    EXPECT_EQ(worker_pool.get_thread_count(), 2);
+
+    const auto loop_thread = std::this_thread::get_id();
+    constexpr auto k_task_count = 8;
+    std::atomic<int32_t> work_on_loop_thread{0};
+    auto done_count = 0;
+    for (auto i = 0; i < k_task_count; i++) {
+        worker_pool.post(
+            [&]() {
+                if (std::this_thread::get_id() == loop_thread) {
+                    work_on_loop_thread++;
+                }
+            },
+            [&]() {
+                EXPECT_EQ(std::this_thread::get_id(), loop_thread);
+                done_count++;
+            });
+    }
+
+    // the done callbacks only run once the loop handles the wakeup
+    while (done_count < k_task_count) {
+        loop.run();
+    }
+
+    EXPECT_EQ(work_on_loop_thread, 0);
+}
+
+TEST(WorkerPoolTest, stop_drops_done) {
+    wall::Loop loop;
+    wall::WorkerPool worker_pool{&loop, 1};
+
+    std::atomic<bool> is_work_done{false};
+    auto is_done_called = false;
+    worker_pool.post(
+        [&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+            is_work_done = true;
+        },
+        [&]() { is_done_called = true; });
+
+    // give the worker a chance to pick up the task, stop waits for it to finish either way
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    worker_pool.stop();
+
+    EXPECT_EQ(worker_pool.get_thread_count(), 0);
+    EXPECT_FALSE(is_done_called);
+    EXPECT_FALSE(loop.run());
+}